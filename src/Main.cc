@@ -11,6 +11,8 @@
 
 #include "db/DatabaseManager.h"
 #include "gui/MainWindow.h"
+#include "gui/MaintenanceScheduler.h"
+#include "gui/ExternalChangeWatcher.h"
 #include "gui/views/ViewFactory.h"
 #include "core/utils/LanguageManager.h"
 #include "core/utils/StyleLoader.h"
@@ -31,6 +33,12 @@ int main( int argc, char *argv[] ) {
     DatabaseManager db_manager;
     if ( !db_manager.connect() || !db_manager.createTables() ) return -1;
 
+    MaintenanceScheduler maintenance_scheduler( db_manager );
+    maintenance_scheduler.start();
+
+    ExternalChangeWatcher change_watcher( db_manager );
+    change_watcher.start();
+
     ViewFactory view_factory( db_manager );
     MainWindow main_window( view_factory );
     main_window.show();
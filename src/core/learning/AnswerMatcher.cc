@@ -0,0 +1,148 @@
+/*
+ * @authors: Jakub Jurczak, Mateusz Woźniak
+ * summary: Typo tolerant answer matching with a bit-parallel edit distance - source file.
+ */
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "AnswerMatcher.h"
+
+using namespace std;
+
+// decodes UTF-8 into out (up to capacity code points) and returns the total number of code
+// points, a malformed byte counts as one character of its own
+static size_t decodeUtf8( string_view text, char32_t* out, size_t capacity ) {
+    size_t count = 0;
+    for ( size_t i = 0; i < text.size(); ) {
+        unsigned char lead = static_cast<unsigned char>( text[i] );
+        size_t len = 1;
+        if ( ( lead >> 5 ) == 0x6 ) {
+            len = 2;
+        } else if ( ( lead >> 4 ) == 0xE ) {
+            len = 3;
+        } else if ( ( lead >> 3 ) == 0x1E ) {
+            len = 4;
+        }
+        char32_t code = len == 1 ? lead : lead & ( 0x7F >> len );
+        for ( size_t k = 1; k < len && i + k < text.size(); ++k ) {
+            code = ( code << 6 ) | ( static_cast<unsigned char>( text[i + k] ) & 0x3F );
+        }
+        if ( count < capacity ) out[count] = code;
+        ++count;
+        i += len;
+    }
+    return count;
+}
+
+int TypoTolerance::allowedEdits( size_t length ) const {
+    if ( chars_per_edit <= 0 ) return 0;
+    return min( max_edits, static_cast<int>( length ) / chars_per_edit );
+}
+
+size_t AnswerMatcher::length( string_view text ) { return decodeUtf8( text, nullptr, 0 ); }
+
+// both answers are decoded onto the stack, only answers longer than MAX_FAST_LENGTH allocate
+int AnswerMatcher::editDistance( string_view expected, string_view typed, int max_distance ) {
+    char32_t a[MAX_FAST_LENGTH];
+    char32_t b[MAX_FAST_LENGTH];
+    size_t m = decodeUtf8( expected, a, MAX_FAST_LENGTH );
+    size_t n = decodeUtf8( typed, b, MAX_FAST_LENGTH );
+
+    // every insertion or deletion changes the length by one
+    if ( static_cast<size_t>( abs( static_cast<long>( m ) - static_cast<long>( n ) ) ) >
+         static_cast<size_t>( max_distance ) ) {
+        return max_distance + 1;
+    }
+    if ( m <= MAX_FAST_LENGTH && n <= MAX_FAST_LENGTH ) {
+        return myersDistance( a, m, b, n, max_distance );
+    }
+
+    vector<char32_t> long_a( m );
+    vector<char32_t> long_b( n );
+    decodeUtf8( expected, long_a.data(), m );
+    decodeUtf8( typed, long_b.data(), n );
+    return rowDistance( long_a.data(), m, long_b.data(), n, max_distance );
+}
+
+// Myers' bit-vector algorithm in Hyyrö's formulation: bit i of the vertical delta vectors says
+// whether row i + 1 of the current DP column is one more (pv) or one less (mv) than row i, so a
+// whole column of up to 64 rows advances with a handful of word operations per typed character
+int AnswerMatcher::myersDistance( const char32_t* pattern, size_t m, const char32_t* text,
+                                  size_t n, int max_distance ) {
+    if ( m == 0 ) return min( static_cast<int>( n ), max_distance + 1 );
+
+    // match masks, a table for ASCII and a short list for the other characters of the pattern
+    uint64_t ascii_masks[128];
+    memset( ascii_masks, 0, sizeof( ascii_masks ) );
+    char32_t other_chars[MAX_FAST_LENGTH];
+    uint64_t other_masks[MAX_FAST_LENGTH];
+    size_t others = 0;
+    for ( size_t i = 0; i < m; ++i ) {
+        char32_t c = pattern[i];
+        if ( c < 128 ) {
+            ascii_masks[c] |= uint64_t( 1 ) << i;
+            continue;
+        }
+        size_t k = find( other_chars, other_chars + others, c ) - other_chars;
+        if ( k == others ) {
+            other_chars[others] = c;
+            other_masks[others++] = 0;
+        }
+        other_masks[k] |= uint64_t( 1 ) << i;
+    }
+    auto match_mask = [&]( char32_t c ) -> uint64_t {
+        if ( c < 128 ) return ascii_masks[c];
+        size_t k = find( other_chars, other_chars + others, c ) - other_chars;
+        return k < others ? other_masks[k] : 0;
+    };
+
+    const uint64_t last = uint64_t( 1 ) << ( m - 1 );
+    uint64_t pv = ~uint64_t( 0 );
+    uint64_t mv = 0;
+    int score = static_cast<int>( m );
+    for ( size_t j = 0; j < n; ++j ) {
+        uint64_t eq = match_mask( text[j] );
+        uint64_t xv = eq | mv;
+        uint64_t xh = ( ( ( eq & pv ) + pv ) ^ pv ) | eq;
+        uint64_t ph = mv | ~( xh | pv );
+        uint64_t mh = pv & xh;
+        if ( ph & last ) {
+            ++score;
+        } else if ( mh & last ) {
+            --score;
+        }
+        // the top row of the DP grows by one per column, which shifts a 1 into ph
+        ph = ( ph << 1 ) | 1;
+        mh <<= 1;
+        pv = mh | ~( xv | ph );
+        mv = ph & xv;
+
+        // the score drops by at most one per remaining character
+        if ( score - static_cast<int>( n - j - 1 ) > max_distance ) return max_distance + 1;
+    }
+    return min( score, max_distance + 1 );
+}
+
+// plain two-row DP for answers too long for one machine word
+int AnswerMatcher::rowDistance( const char32_t* a, size_t m, const char32_t* b, size_t n,
+                                int max_distance ) {
+    vector<int> previous( n + 1 );
+    vector<int> current( n + 1 );
+    for ( size_t j = 0; j <= n; ++j ) previous[j] = static_cast<int>( j );
+
+    for ( size_t i = 1; i <= m; ++i ) {
+        current[0] = static_cast<int>( i );
+        int row_min = current[0];
+        for ( size_t j = 1; j <= n; ++j ) {
+            int substitution = previous[j - 1] + ( a[i - 1] != b[j - 1] );
+            current[j] = min( { previous[j] + 1, current[j - 1] + 1, substitution } );
+            row_min = min( row_min, current[j] );
+        }
+        if ( row_min > max_distance ) return max_distance + 1;
+        swap( previous, current );
+    }
+    return min( previous[n], max_distance + 1 );
+}
@@ -0,0 +1,32 @@
+/*
+ * @authors: Jakub Jurczak, Mateusz Woźniak
+ * summary: Typo tolerant answer matching with a bit-parallel edit distance - header file.
+ */
+#pragma once
+#include <cstddef>
+#include <string_view>
+
+// one typo is accepted per chars_per_edit characters of the expected answer, up to max_edits
+struct TypoTolerance {
+    int chars_per_edit = 5;
+    int max_edits = 2;
+
+    int allowedEdits( std::size_t length ) const;
+};
+
+class AnswerMatcher {
+public:
+    // answers up to this many characters take the bit-parallel path
+    static constexpr std::size_t MAX_FAST_LENGTH = 64;
+
+    // Levenshtein distance of two UTF-8 strings counted in code points, capped at
+    // max_distance + 1 as soon as the distance is known to be larger than max_distance
+    static int editDistance( std::string_view expected, std::string_view typed, int max_distance );
+    static std::size_t length( std::string_view text );
+
+private:
+    static int myersDistance( const char32_t* pattern, std::size_t m, const char32_t* text,
+                              std::size_t n, int max_distance );
+    static int rowDistance( const char32_t* a, std::size_t m, const char32_t* b, std::size_t n,
+                            int max_distance );
+};
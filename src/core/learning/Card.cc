@@ -2,14 +2,17 @@
  * @authors: Jakub Jurczak, Mateusz Woźniak
  * summary: Class representing a learning card - source file.
  */
+#include <QString>
 #include <algorithm>
-#include <cctype>
 
 #include "Card.h"
 
 using namespace std;
 
-Card::Card( const CardData& data ) : data_( data ) {
+Card::Card( const CardData& data, AnswerKeyOptions options )
+    : data_( data ), key_options_( options ) {
+    buildAnswerKeys();
+
     if ( holds_alternative<ImageContent>( data_.question ) ) {
         media_type_ = MediaType::IMAGE;
     } else if ( holds_alternative<SoundContent>( data_.question ) ) {
@@ -19,14 +22,49 @@ Card::Card( const CardData& data ) : data_( data ) {
     }
 }
 
+void Card::setAnswerKeyOptions( AnswerKeyOptions options ) {
+    if ( options == key_options_ ) return;
+    key_options_ = options;
+    buildAnswerKeys();
+}
+
+void Card::buildAnswerKeys() {
+    answer_keys_.clear();
+    answer_keys_.reserve( 1 + data_.accepted_answers.size() );
+    answer_keys_.push_back( normalizeAnswer( data_.correct_answer, key_options_ ) );
+    for ( const auto& accepted : data_.accepted_answers ) {
+        answer_keys_.push_back( normalizeAnswer( accepted, key_options_ ) );
+    }
+}
+
+// only the user's answer is normalized here, the card's keys were built in the constructor
 bool Card::checkAnswer( string_view user_answer ) const {
-    return areStringsEqual( user_answer, data_.correct_answer );
+    string key = normalizeAnswer( user_answer, key_options_ );
+    return find( answer_keys_.begin(), answer_keys_.end(), key ) != answer_keys_.end();
 }
 
-vector<string> Card::getChoices() const {
-    vector<string> choices = data_.wrong_answers;
-    choices.push_back( data_.correct_answer );
-    return choices;
+// typos are counted against every accepted answer, each with its own length based allowance
+AnswerMatch Card::matchAnswer( string_view user_answer, TypoTolerance tolerance ) const {
+    string key = normalizeAnswer( user_answer, key_options_ );
+    AnswerMatch match = AnswerMatch::WRONG;
+    for ( const auto& answer_key : answer_keys_ ) {
+        if ( answer_key == key ) return AnswerMatch::EXACT;
+        int allowed = tolerance.allowedEdits( AnswerMatcher::length( answer_key ) );
+        if ( allowed > 0 && AnswerMatcher::editDistance( answer_key, key, allowed ) <= allowed ) {
+            match = AnswerMatch::TYPO;
+        }
+    }
+    return match;
+}
+
+// rows stored before addCardToSet checked the limit may have more wrong answers, only the
+// first ones are shown next to the correct answer
+size_t Card::getChoiceCount() const {
+    return min( data_.wrong_answers.size(), ChoiceOrder::MAX_CHOICES - 1 ) + 1;
+}
+
+const string& Card::getChoice( size_t i ) const {
+    return i + 1 < getChoiceCount() ? data_.wrong_answers[i] : data_.correct_answer;
 }
 
 string Card::getQuestion() const {
@@ -36,12 +74,64 @@ string Card::getQuestion() const {
     return "[Media Content]";
 }
 
+// relative path of the question's image or sound, empty for text questions
+string Card::getMediaFile() const {
+    if ( holds_alternative<ImageContent>( data_.question ) ) {
+        return get<ImageContent>( data_.question ).image_path;
+    }
+    if ( holds_alternative<SoundContent>( data_.question ) ) {
+        return get<SoundContent>( data_.question ).sound_path;
+    }
+    return "";
+}
+
 bool Card::isChoiceCard() const {
     return !data_.wrong_answers.empty() || data_.answer_type == AnswerType::TEXT_CHOICE ||
            data_.answer_type == AnswerType::IMAGE_CHOICE;
 }
 
-bool Card::areStringsEqual( string_view a, string_view b ) {
-    return equal( a.begin(), a.end(), b.begin(), b.end(),
-                  []( char a, char b ) { return tolower( a ) == tolower( b ); } );
+// ASCII needs none of the Unicode steps: it is already NFC, has no diacritics and folds to
+// lower case byte by byte, so typical answers are normalized in one string without QString
+static bool isAscii( string_view text ) {
+    return all_of( text.begin(), text.end(),
+                   []( char c ) { return static_cast<unsigned char>( c ) < 0x80; } );
+}
+
+// the whitespace QChar::isSpace() reports below 0x80
+static bool isAsciiSpace( char c ) {
+    return c == ' ' || ( c >= '\t' && c <= '\r' );
+}
+
+// toCaseFolded alone maps one character to one character, upper casing first expands the
+// special cases of full case folding, e.g. "ß" -> "SS" -> "ss"; every step returns a new
+// QString, which is why ASCII answers take the byte path
+string Card::normalizeAnswer( string_view text, AnswerKeyOptions options ) {
+    if ( isAscii( text ) ) {
+        string key;
+        key.reserve( text.size() );
+        for ( char c : text ) {
+            if ( options.strip_whitespace && isAsciiSpace( c ) ) continue;
+            key.push_back( c >= 'A' && c <= 'Z' ? static_cast<char>( c - 'A' + 'a' ) : c );
+        }
+        size_t begin = 0;
+        while ( begin < key.size() && isAsciiSpace( key[begin] ) ) ++begin;
+        size_t end = key.size();
+        while ( end > begin && isAsciiSpace( key[end - 1] ) ) --end;
+        key.erase( end );
+        key.erase( 0, begin );
+        return key;
+    }
+
+    QString key = QString::fromUtf8( text.data(), static_cast<qsizetype>( text.size() ) );
+    if ( options.strip_diacritics ) {
+        key = key.normalized( QString::NormalizationForm_D );
+        key.removeIf( []( QChar c ) { return c.category() == QChar::Mark_NonSpacing; } );
+        // the stroke of "ł" is part of the letter and does not decompose
+        key.replace( QChar( 0x0142 ), u'l' ).replace( QChar( 0x0141 ), u'L' );
+    }
+    key = key.toUpper().toCaseFolded().normalized( QString::NormalizationForm_C ).trimmed();
+    if ( options.strip_whitespace ) {
+        key.removeIf( []( QChar c ) { return c.isSpace(); } );
+    }
+    return key.toStdString();
 }
\ No newline at end of file
@@ -3,11 +3,15 @@
  * summary: Class representing a learning card - header file.
  */
 #pragma once
+#include <array>
+#include <cstdint>
+#include <random>
 #include <string>
 #include <string_view>
 #include <variant>
 #include <vector>
 
+#include "AnswerMatcher.h"
 #include "CardTypes.h"
 
 struct TextContent {
@@ -29,6 +33,7 @@ struct CardData {
     std::string correct_answer;
     std::vector<std::string> wrong_answers;
     AnswerType answer_type = AnswerType::FLASHCARD;
+    std::vector<std::string> accepted_answers;  // other spellings accepted for INPUT cards
 };
 
 struct DraftCard {
@@ -36,28 +41,82 @@ struct DraftCard {
     std::string correct_answer;
     std::vector<std::string> wrong_answers;
     AnswerType answer_type = AnswerType::FLASHCARD;
+    std::vector<std::string> accepted_answers;
+};
+
+// EXACT when the normalized answers are equal, TYPO when they are within the typo tolerance
+enum class AnswerMatch { WRONG, TYPO, EXACT };
+
+// answers are always compared in NFC with full case folding and without surrounding whitespace
+struct AnswerKeyOptions {
+    bool strip_diacritics = false;  // "Żółw" matches "zolw"
+    bool strip_whitespace = false;  // "ice cream" matches "icecream"
+
+    bool operator==( const AnswerKeyOptions& other ) const {
+        return strip_diacritics == other.strip_diacritics &&
+               strip_whitespace == other.strip_whitespace;
+    }
+    bool operator!=( const AnswerKeyOptions& other ) const { return !( *this == other ); }
+};
+
+// presentation order of a card's choices, positions index Card::getChoice()
+struct ChoiceOrder {
+    // the correct answer and at most 15 wrong ones, addCardToSet refuses cards with more
+    static constexpr std::size_t MAX_CHOICES = 16;
+
+    std::array<std::uint8_t, MAX_CHOICES> positions{};
+    std::size_t size = 0;
 };
 
 class Card {
 public:
-    explicit Card( const CardData& data );
+    explicit Card( const CardData& data, AnswerKeyOptions options = {} );
 
     Card() = default;
 
+    // rebuilds the answer keys when the options differ from the ones they were built with
+    void setAnswerKeyOptions( AnswerKeyOptions options );
+
     bool checkAnswer( std::string_view user_answer ) const;
-    std::vector<std::string> getChoices() const;
+    AnswerMatch matchAnswer( std::string_view user_answer, TypoTolerance tolerance = {} ) const;
+    // wrong answers followed by the correct one, read from the card's own data
+    std::size_t getChoiceCount() const;
+    const std::string& getChoice( std::size_t i ) const;
+    template <typename Rng>
+    ChoiceOrder shuffleChoices( Rng& rng ) const;
     std::string getQuestion() const;
+    std::string getMediaFile() const;
     bool isChoiceCard() const;
+    static std::string normalizeAnswer( std::string_view text, AnswerKeyOptions options = {} );
 
     int getId() const { return data_.id; }
     int getSetId() const { return data_.set_id; }
     MediaType getMediaType() const { return media_type_; }
     const CardData& getData() const { return data_; }
     const std::string& getCorrectAnswer() const { return data_.correct_answer; }
+    // normalized correct answer followed by the normalized accepted answers
+    const std::vector<std::string>& getAnswerKeys() const { return answer_keys_; }
 
 private:
     MediaType media_type_;
     CardData data_;
+    AnswerKeyOptions key_options_;
+    std::vector<std::string> answer_keys_;  // built once per card
+
+    void buildAnswerKeys();
+};
 
-    static bool areStringsEqual( std::string_view a, std::string_view b );
-};
\ No newline at end of file
+// Fisher-Yates over a fixed array, so a new order costs no allocation
+template <typename Rng>
+ChoiceOrder Card::shuffleChoices( Rng& rng ) const {
+    ChoiceOrder order;
+    order.size = getChoiceCount();
+    for ( std::size_t i = 0; i < order.size; ++i ) {
+        order.positions[i] = static_cast<std::uint8_t>( i );
+    }
+    for ( std::size_t i = order.size; i > 1; --i ) {
+        std::uniform_int_distribution<std::size_t> pick( 0, i - 1 );
+        std::swap( order.positions[i - 1], order.positions[pick( rng )] );
+    }
+    return order;
+}
\ No newline at end of file
@@ -0,0 +1,124 @@
+/*
+ * @authors: Jakub Jurczak, Mateusz Woźniak
+ * summary: Class CardStore, columnar storage for all cards of large sets - source file.
+ */
+#include <string>
+
+#include "CardStore.h"
+
+using namespace std;
+
+void CardStore::add( const CardData& data ) {
+    if ( holds_alternative<ImageContent>( data.question ) ) {
+        beginRow( data.id, data.set_id, MediaType::IMAGE, data.answer_type,
+                  get<ImageContent>( data.question ).image_path, data.correct_answer );
+    } else if ( holds_alternative<SoundContent>( data.question ) ) {
+        beginRow( data.id, data.set_id, MediaType::SOUND, data.answer_type,
+                  get<SoundContent>( data.question ).sound_path, data.correct_answer );
+    } else {
+        beginRow( data.id, data.set_id, MediaType::TEXT, data.answer_type,
+                  get<TextContent>( data.question ).text, data.correct_answer );
+    }
+    for ( const auto& wrong : data.wrong_answers ) addWrongAnswer( wrong );
+    for ( const auto& accepted : data.accepted_answers ) addAcceptedAnswer( accepted );
+}
+
+void CardStore::beginRow( int id, int set_id, MediaType media_type, AnswerType answer_type,
+                          string_view question, string_view correct_answer ) {
+    ids_.push_back( id );
+    set_ids_.push_back( set_id );
+    media_types_.push_back( media_type );
+    answer_types_.push_back( answer_type );
+    questions_.push_back( strings_.intern( question ) );
+    correct_answers_.push_back( strings_.intern( correct_answer ) );
+    extras_begin_.push_back( static_cast<uint32_t>( extras_.size() ) );
+    wrong_counts_.push_back( 0 );
+    accepted_counts_.push_back( 0 );
+}
+
+// the accepted answers follow the wrong ones in extras_, so none may have been added yet
+void CardStore::addWrongAnswer( string_view answer ) {
+    extras_.push_back( strings_.intern( answer ) );
+    ++wrong_counts_.back();
+}
+
+void CardStore::addAcceptedAnswer( string_view answer ) {
+    extras_.push_back( strings_.intern( answer ) );
+    ++accepted_counts_.back();
+}
+
+void CardStore::reserve( size_t cards ) {
+    ids_.reserve( cards );
+    set_ids_.reserve( cards );
+    media_types_.reserve( cards );
+    answer_types_.reserve( cards );
+    questions_.reserve( cards );
+    correct_answers_.reserve( cards );
+    extras_begin_.reserve( cards );
+    wrong_counts_.reserve( cards );
+    accepted_counts_.reserve( cards );
+}
+
+void CardStore::clear() {
+    ids_.clear();
+    set_ids_.clear();
+    media_types_.clear();
+    answer_types_.clear();
+    questions_.clear();
+    correct_answers_.clear();
+    extras_begin_.clear();
+    wrong_counts_.clear();
+    accepted_counts_.clear();
+    extras_.clear();
+    strings_.clear();
+}
+
+CardView CardStore::view( size_t row ) const { return CardView( *this, row ); }
+
+string_view CardView::getQuestion() const {
+    return store_->strings_.view( store_->questions_[row_] );
+}
+
+string_view CardView::getCorrectAnswer() const {
+    return store_->strings_.view( store_->correct_answers_[row_] );
+}
+
+string_view CardView::getWrongAnswer( size_t i ) const {
+    return store_->strings_.view( store_->extras_[store_->extras_begin_[row_] + i] );
+}
+
+string_view CardView::getAcceptedAnswer( size_t i ) const {
+    size_t begin = store_->extras_begin_[row_] + store_->wrong_counts_[row_];
+    return store_->strings_.view( store_->extras_[begin + i] );
+}
+
+// same rule as Card::isChoiceCard
+bool CardView::isChoiceCard() const {
+    AnswerType type = getAnswerType();
+    return getWrongAnswerCount() > 0 || type == AnswerType::TEXT_CHOICE ||
+           type == AnswerType::IMAGE_CHOICE;
+}
+
+Card CardView::toCard() const {
+    CardData data;
+    data.id = getId();
+    data.set_id = getSetId();
+    data.answer_type = getAnswerType();
+
+    string question( getQuestion() );
+    if ( getMediaType() == MediaType::IMAGE ) {
+        data.question = ImageContent{ question };
+    } else if ( getMediaType() == MediaType::SOUND ) {
+        data.question = SoundContent{ question };
+    } else {
+        data.question = TextContent{ question };
+    }
+    data.correct_answer = string( getCorrectAnswer() );
+    for ( size_t i = 0; i < getWrongAnswerCount(); ++i ) {
+        data.wrong_answers.emplace_back( getWrongAnswer( i ) );
+    }
+    for ( size_t i = 0; i < getAcceptedAnswerCount(); ++i ) {
+        data.accepted_answers.emplace_back( getAcceptedAnswer( i ) );
+    }
+    return Card( data );
+}
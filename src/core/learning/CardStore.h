@@ -0,0 +1,86 @@
+/*
+ * @authors: Jakub Jurczak, Mateusz Woźniak
+ * summary: Class CardStore, columnar storage for all cards of large sets - header file.
+ */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "../utils/StringPool.h"
+#include "Card.h"
+#include "CardTypes.h"
+
+class CardView;
+
+// cards of whole sets for bulk work, stored column by column so a scan over one field (media
+// types, answer types, set ids...) reads only that field; every string is interned in the
+// store's pool, so distractors repeated across a set ("True", month names...) are kept once;
+// views and string_views stay valid until the store is cleared or destroyed
+class CardStore {
+public:
+    void add( const CardData& data );
+    // bulk filling straight from stored values, without a CardData per row: a row starts with
+    // its fixed columns and then gets its wrong answers, followed by its accepted answers
+    void beginRow( int id, int set_id, MediaType media_type, AnswerType answer_type,
+                   std::string_view question, std::string_view correct_answer );
+    void addWrongAnswer( std::string_view answer );
+    void addAcceptedAnswer( std::string_view answer );
+    void reserve( std::size_t cards );
+    void clear();
+    std::size_t size() const { return ids_.size(); }
+
+    CardView view( std::size_t row ) const;
+
+    // whole columns, indexed by row
+    const std::vector<int>& ids() const { return ids_; }
+    const std::vector<int>& setIds() const { return set_ids_; }
+    const std::vector<MediaType>& mediaTypes() const { return media_types_; }
+    const std::vector<AnswerType>& answerTypes() const { return answer_types_; }
+    const std::vector<std::uint32_t>& wrongAnswerCounts() const { return wrong_counts_; }
+
+    const StringPool& strings() const { return strings_; }
+
+private:
+    friend class CardView;
+
+    std::vector<int> ids_;
+    std::vector<int> set_ids_;
+    std::vector<MediaType> media_types_;
+    std::vector<AnswerType> answer_types_;
+    std::vector<StringPool::Handle> questions_;
+    std::vector<StringPool::Handle> correct_answers_;
+    // wrong answers, then accepted answers of a row start at extras_begin_ in extras_
+    std::vector<std::uint32_t> extras_begin_;
+    std::vector<std::uint32_t> wrong_counts_;
+    std::vector<std::uint32_t> accepted_counts_;
+    std::vector<StringPool::Handle> extras_;
+    StringPool strings_;
+};
+
+// one row of a CardStore, read in place; cheap to copy and only valid while the store is
+class CardView {
+public:
+    CardView( const CardStore& store, std::size_t row ) : store_( &store ), row_( row ) {}
+
+    int getId() const { return store_->ids_[row_]; }
+    int getSetId() const { return store_->set_ids_[row_]; }
+    MediaType getMediaType() const { return store_->media_types_[row_]; }
+    AnswerType getAnswerType() const { return store_->answer_types_[row_]; }
+    // text of text questions, relative media path otherwise
+    std::string_view getQuestion() const;
+    std::string_view getCorrectAnswer() const;
+    std::size_t getWrongAnswerCount() const { return store_->wrong_counts_[row_]; }
+    std::string_view getWrongAnswer( std::size_t i ) const;
+    std::size_t getAcceptedAnswerCount() const { return store_->accepted_counts_[row_]; }
+    std::string_view getAcceptedAnswer( std::size_t i ) const;
+    bool isChoiceCard() const;
+
+    // a standalone card with its own copies of the strings, e.g. for a learning session
+    Card toCard() const;
+
+private:
+    const CardStore* store_;
+    std::size_t row_;
+};
@@ -0,0 +1,16 @@
+/*
+ * @authors: Jakub Jurczak, Mateusz Woźniak
+ * summary: Structure representing a deck, a named group of sets and nested decks.
+ */
+#pragma once
+#include <string>
+
+// counters cover the whole subtree: the deck's own sets and the sets of every nested deck
+struct Deck {
+    int id = 0;
+    std::string name;
+    int parent_id = -1;  // -1 for a top level deck
+    int card_count = 0;
+    int due_count = 0;  // as of the last due recount, see DatabaseManager::refreshDueCounts
+    int mastered_count = 0;
+};
@@ -0,0 +1,86 @@
+/*
+ * @authors: Jakub Jurczak, Mateusz Woźniak
+ * summary: K-way merge of the due queues of several sets - source file.
+ */
+#include <algorithm>
+#include <climits>
+
+#include "DueQueueMerger.h"
+
+using namespace std;
+
+DueQueueMerger::DueQueueMerger( const DatabaseManager& db, vector<int> set_ids, int per_set_cap )
+    : db_( db ), per_set_cap_( max( per_set_cap, 0 ) ) {
+    cursors_.reserve( set_ids.size() );
+    for ( int set_id : set_ids ) {
+        cursors_.emplace_back( set_id );
+    }
+    head_keys_.assign( cursors_.size(), 0 );
+    heap_.reserve( cursors_.size() );
+}
+
+int DueQueueMerger::overdueDays( const ScheduledCard& card ) {
+    if ( card.elapsed_days < 0 ) return INT_MAX;
+    return card.elapsed_days - card.state.interval;
+}
+
+// nothing is read before the first take, and then only one short page per set: about its share
+// of the cards asked for, so starting over many sets reads little more than the session needs
+vector<ScheduledCard> DueQueueMerger::take( int limit ) {
+    vector<ScheduledCard> cards;
+    if ( limit <= 0 ) return cards;
+
+    auto below = [this]( size_t a, size_t b ) { return ranksBelow( a, b ); };
+    if ( !primed_ ) {
+        primed_ = true;
+        int sets = static_cast<int>( max<size_t>( cursors_.size(), 1 ) );
+        int share = clamp( ( limit + sets - 1 ) / sets, 1, FIRST_PAGE );
+        for ( size_t i = 0; i < cursors_.size(); ++i ) {
+            cursors_[i].page_size = share;
+            if ( advance( i ) ) heap_.push_back( i );
+        }
+        make_heap( heap_.begin(), heap_.end(), below );
+    }
+
+    cards.reserve( limit );
+    while ( static_cast<int>( cards.size() ) < limit && !heap_.empty() ) {
+        pop_heap( heap_.begin(), heap_.end(), below );
+        size_t index = heap_.back();
+        heap_.pop_back();
+
+        Cursor& cursor = cursors_[index];
+        cards.push_back( std::move( cursor.page[cursor.next++] ) );
+        ++cursor.taken;
+        ++taken_;
+        if ( advance( index ) ) {
+            heap_.push_back( index );
+            push_heap( heap_.begin(), heap_.end(), below );
+        }
+    }
+    return cards;
+}
+
+bool DueQueueMerger::advance( size_t index ) {
+    Cursor& cursor = cursors_[index];
+    if ( cursor.taken >= per_set_cap_ ) return false;
+
+    if ( cursor.next == cursor.page.size() ) {
+        if ( cursor.exhausted ) return false;
+        int size = min( cursor.page_size, per_set_cap_ - cursor.read );
+        cursor.page = db_.getDueScheduledPage( cursor.set_id, cursor.after, size );
+        cursor.next = 0;
+        cursor.read += static_cast<int>( cursor.page.size() );
+        cursor.exhausted = static_cast<int>( cursor.page.size() ) < size;
+        cursor.page_size = min( cursor.page_size * 2, MAX_PAGE );
+        loaded_ += cursor.page.size();
+        if ( cursor.page.empty() ) return false;
+    }
+    head_keys_[index] = overdueDays( cursor.page[cursor.next] );
+    return true;
+}
+
+// the heap keeps its largest element on top: the most overdue head, the earlier set on a tie
+bool DueQueueMerger::ranksBelow( size_t a, size_t b ) const {
+    if ( head_keys_[a] != head_keys_[b] ) return head_keys_[a] < head_keys_[b];
+    return a > b;
+}
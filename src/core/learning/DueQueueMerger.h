@@ -0,0 +1,60 @@
+/*
+ * @authors: Jakub Jurczak, Mateusz Woźniak
+ * summary: K-way merge of the due queues of several sets - header file.
+ */
+#pragma once
+#include <cstddef>
+#include <vector>
+
+#include "../../db/DatabaseManager.h"
+#include "ScheduledCard.h"
+
+// interleaves the due queues of several sets, the most overdue card of any set first; every set
+// is read page by page, only as far as the merge reaches into it
+class DueQueueMerger {
+public:
+    static constexpr int FIRST_PAGE = 4;
+    static constexpr int MAX_PAGE = 64;
+
+    // no set contributes more than per_set_cap cards
+    DueQueueMerger( const DatabaseManager& db, std::vector<int> set_ids, int per_set_cap );
+
+    // up to limit further cards in merged order
+    std::vector<ScheduledCard> take( int limit );
+    // rows read from the database so far
+    std::size_t loadedCount() const { return loaded_; }
+    // rows read but not taken yet, the cards the merge knows it can still give
+    std::size_t pendingCount() const { return loaded_ - taken_; }
+
+    // days past the due date, the order of every set's due queue; new cards come first there, so
+    // they rank above any reviewed card
+    static int overdueDays( const ScheduledCard& card );
+
+private:
+    struct Cursor {
+        explicit Cursor( int id ) : set_id( id ) {}
+
+        int set_id;
+        DueCursor after;  // past the last row read
+        int read = 0;     // rows of the set read so far, all of them taken but the current page
+        int taken = 0;
+        int page_size = FIRST_PAGE;
+        std::vector<ScheduledCard> page;
+        std::size_t next = 0;
+        bool exhausted = false;
+    };
+
+    const DatabaseManager& db_;
+    int per_set_cap_;
+    std::vector<Cursor> cursors_;
+    // indices of the cursors that have a head card, heap ordered with the most overdue on top
+    std::vector<std::size_t> heap_;
+    std::vector<int> head_keys_;
+    bool primed_ = false;
+    std::size_t loaded_ = 0;
+    std::size_t taken_ = 0;
+
+    // makes the cursor's next card available, reading a page if needed; false when it is done
+    bool advance( std::size_t index );
+    bool ranksBelow( std::size_t a, std::size_t b ) const;
+};
@@ -0,0 +1,45 @@
+/*
+ * @authors: Jakub Jurczak, Mateusz Woźniak
+ * summary: FSRS (Free Spaced Repetition Scheduler) memory model math - source file.
+ */
+#include "Fsrs.h"
+
+using namespace std;
+
+int Fsrs::ratingOfGrade( int grade ) {
+    if ( grade < SuperMemo::PASSING_GRADE ) return AGAIN;
+    if ( grade == SuperMemo::PASSING_GRADE ) return HARD;
+    return grade == 4 ? GOOD : EASY;
+}
+
+FsrsState Fsrs::review( const Weights& w, const FsrsState& state, int elapsed_days,
+                        int rating ) {
+    if ( elapsed_days < 0 || state.stability <= 0.0f ) {
+        return { static_cast<float>( initialStability<double>( w, rating ) ),
+                 static_cast<float>( initialDifficulty<double>( w, rating ) ) };
+    }
+
+    double stability = state.stability;
+    double difficulty = state.difficulty;
+    double recall = retrievability( elapsed_days, stability );
+    double next_stability = rating == AGAIN
+                                ? forgetStability( w, difficulty, stability, recall )
+                                : recallStability( w, difficulty, stability, recall, rating );
+    return { static_cast<float>( max( next_stability, MIN_STABILITY ) ),
+             static_cast<float>( nextDifficulty( w, difficulty, rating ) ) };
+}
+
+// inverts the forgetting curve, at 90% retention the interval equals the stability
+int Fsrs::nextInterval( float stability, double retention ) {
+    double days = stability / FACTOR * ( pow( retention, 1.0 / DECAY ) - 1.0 );
+    return clamp( static_cast<int>( lround( days ) ), 1, MAX_INTERVAL );
+}
+
+// the current interval stands in for stability, the default easiness of 2.5 maps to a
+// difficulty of 6 and lower easiness to harder cards
+FsrsState Fsrs::fromSuperMemo( const SuperMemoState& state ) {
+    if ( state.repetitions == 0 && state.interval == 0 ) return {};
+    double difficulty = clampDifficulty( 11.0 - 2.0 * state.easiness );
+    return { static_cast<float>( max<double>( state.interval, 1.0 ) ),
+             static_cast<float>( difficulty ) };
+}
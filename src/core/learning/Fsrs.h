@@ -0,0 +1,110 @@
+/*
+ * @authors: Jakub Jurczak, Mateusz Woźniak
+ * summary: FSRS (Free Spaced Repetition Scheduler) memory model math - header file.
+ */
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+#include "SuperMemo.h"
+
+// memory of one card under FSRS: stability is the interval (in days) at which recall drops to
+// 90%, difficulty runs from 1 (easy) to 10 (hard); a stability of 0 means no FSRS state yet
+struct FsrsState {
+    float stability = 0.0f;
+    float difficulty = 0.0f;
+};
+
+// FSRS-4.5 model; the formulas are templates over the number type, so the optimizer can run
+// them on dual numbers to get exact gradients with respect to the weights
+class Fsrs {
+public:
+    static constexpr std::size_t WEIGHT_COUNT = 17;
+    using Weights = std::array<double, WEIGHT_COUNT>;
+
+    // published FSRS-4.5 defaults, fitted on a large pool of Anki review logs
+    static constexpr Weights DEFAULT_WEIGHTS = { 0.4872, 1.4003, 3.7145, 13.8206, 5.1618, 1.2298,
+                                                 0.8975, 0.031,  1.6474, 0.1367,  1.0461, 2.1072,
+                                                 0.0793, 0.3246, 1.587,  0.2272,  2.8755 };
+    // bounds of each weight, kept by the optimizer so the model never degenerates
+    static constexpr Weights MIN_WEIGHTS = { 0.1, 0.1, 0.1, 0.1, 1.0,  0.1, 0.1,  0.0,  0.0,
+                                             0.1, 0.01, 0.5, 0.01, 0.01, 0.01, 0.0, 1.0 };
+    static constexpr Weights MAX_WEIGHTS = { 100.0, 100.0, 100.0, 100.0, 10.0, 5.0, 5.0, 0.5, 3.0,
+                                             0.8,   2.5,   5.0,   0.2,   0.9,  2.0, 1.0, 4.0 };
+
+    enum Rating { AGAIN = 1, HARD = 2, GOOD = 3, EASY = 4 };
+
+    static constexpr double DESIRED_RETENTION = 0.9;
+    static constexpr int MAX_INTERVAL = 36500;
+    static constexpr double MIN_DIFFICULTY = 1.0;
+    static constexpr double MAX_DIFFICULTY = 10.0;
+    static constexpr double MIN_STABILITY = 0.01;
+    // forgetting curve R(t) = (1 + FACTOR * t / S) ^ DECAY, chosen so that R(S) = 0.9
+    static constexpr double DECAY = -0.5;
+    static constexpr double FACTOR = 19.0 / 81.0;
+
+    // the 0-5 grades of the learning view: failed grades are AGAIN, then HARD, GOOD, EASY
+    static int ratingOfGrade( int grade );
+    // review of a card last seen elapsed_days ago, elapsed_days < 0 for the first review
+    static FsrsState review( const Weights& w, const FsrsState& state, int elapsed_days,
+                             int rating );
+    // days until recall is expected to fall to the desired retention
+    static int nextInterval( float stability, double retention = DESIRED_RETENTION );
+    // starting point for cards that were scheduled by SM-2 before
+    static FsrsState fromSuperMemo( const SuperMemoState& state );
+
+    template <typename T>
+    static T retrievability( double elapsed_days, const T& stability ) {
+        using std::pow;
+        return pow( 1.0 + FACTOR * elapsed_days / stability, DECAY );
+    }
+
+    template <typename T, typename W>
+    static T initialStability( const W& w, int rating ) {
+        return T( w[rating - 1] );
+    }
+
+    template <typename T, typename W>
+    static T initialDifficulty( const W& w, int rating ) {
+        return clampDifficulty( T( w[4] - w[5] * ( rating - GOOD ) ) );
+    }
+
+    // linear step by rating, then mean reversion towards the difficulty of a first GOOD
+    template <typename T, typename W>
+    static T nextDifficulty( const W& w, const T& difficulty, int rating ) {
+        T stepped = difficulty - w[6] * ( rating - GOOD );
+        return clampDifficulty( w[7] * initialDifficulty<T>( w, GOOD ) + ( 1.0 - w[7] ) * stepped );
+    }
+
+    template <typename T, typename W>
+    static T recallStability( const W& w, const T& difficulty, const T& stability,
+                              const T& recall, int rating ) {
+        using std::exp;
+        using std::pow;
+        T growth = exp( T( w[8] ) ) * ( 11.0 - difficulty ) * pow( stability, -w[9] ) *
+                   ( exp( w[10] * ( 1.0 - recall ) ) - 1.0 );
+        if ( rating == HARD ) growth = growth * w[15];
+        if ( rating == EASY ) growth = growth * w[16];
+        return stability * ( growth + 1.0 );
+    }
+
+    // stability after a lapse never exceeds the stability before it
+    template <typename T, typename W>
+    static T forgetStability( const W& w, const T& difficulty, const T& stability,
+                              const T& recall ) {
+        using std::exp;
+        using std::pow;
+        T after = w[11] * pow( difficulty, -w[12] ) * ( pow( stability + 1.0, w[13] ) - 1.0 ) *
+                  exp( w[14] * ( 1.0 - recall ) );
+        return after < stability ? after : stability;
+    }
+
+    template <typename T>
+    static T clampDifficulty( const T& difficulty ) {
+        if ( difficulty < MIN_DIFFICULTY ) return T( MIN_DIFFICULTY );
+        if ( difficulty > MAX_DIFFICULTY ) return T( MAX_DIFFICULTY );
+        return difficulty;
+    }
+};
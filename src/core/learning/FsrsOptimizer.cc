@@ -0,0 +1,381 @@
+/*
+ * @authors: Jakub Jurczak, Mateusz Woźniak
+ * summary: Fits FSRS weights to a user's review history with parallel gradient descent - source
+ * file.
+ */
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <tuple>
+
+#include "FsrsOptimizer.h"
+
+using namespace std;
+
+namespace {
+
+constexpr size_t N = Fsrs::WEIGHT_COUNT;
+// predicted recall is kept away from 0 and 1 so the log loss stays finite
+constexpr double EPSILON = 1e-6;
+
+// forward-mode dual number: a value and its partial derivatives with respect to every weight
+struct Dual {
+    double v = 0.0;
+    array<double, N> d{};
+
+    Dual() = default;
+    Dual( double value ) : v( value ) {}
+};
+
+Dual operator+( const Dual& a, const Dual& b ) {
+    Dual r( a.v + b.v );
+    for ( size_t i = 0; i < N; ++i ) r.d[i] = a.d[i] + b.d[i];
+    return r;
+}
+
+Dual operator-( const Dual& a, const Dual& b ) {
+    Dual r( a.v - b.v );
+    for ( size_t i = 0; i < N; ++i ) r.d[i] = a.d[i] - b.d[i];
+    return r;
+}
+
+Dual operator*( const Dual& a, const Dual& b ) {
+    Dual r( a.v * b.v );
+    for ( size_t i = 0; i < N; ++i ) r.d[i] = a.d[i] * b.v + b.d[i] * a.v;
+    return r;
+}
+
+// the result of f( a ), whose derivative at a.v is slope
+Dual chain( const Dual& a, double value, double slope ) {
+    Dual r( value );
+    for ( size_t i = 0; i < N; ++i ) r.d[i] = a.d[i] * slope;
+    return r;
+}
+
+Dual operator+( const Dual& a, double b ) { return chain( a, a.v + b, 1.0 ); }
+Dual operator+( double a, const Dual& b ) { return chain( b, a + b.v, 1.0 ); }
+Dual operator-( const Dual& a, double b ) { return chain( a, a.v - b, 1.0 ); }
+Dual operator-( double a, const Dual& b ) { return chain( b, a - b.v, -1.0 ); }
+Dual operator-( const Dual& a ) { return chain( a, -a.v, -1.0 ); }
+Dual operator*( const Dual& a, double b ) { return chain( a, a.v * b, b ); }
+Dual operator/( double a, const Dual& b ) { return chain( b, a / b.v, -a / ( b.v * b.v ) ); }
+
+bool operator<( const Dual& a, const Dual& b ) { return a.v < b.v; }
+bool operator<( const Dual& a, double b ) { return a.v < b; }
+bool operator>( const Dual& a, double b ) { return a.v > b; }
+
+Dual exp( const Dual& a ) {
+    double value = std::exp( a.v );
+    return chain( a, value, value );
+}
+
+Dual log( const Dual& a ) { return chain( a, std::log( a.v ), 1.0 / a.v ); }
+
+Dual pow( const Dual& a, double b ) {
+    double value = std::pow( a.v, b );
+    return chain( a, value, b * value / a.v );
+}
+
+// d( a^b ) = a^b * ( b / a * da + ln a * db )
+Dual pow( const Dual& a, const Dual& b ) {
+    Dual r( std::pow( a.v, b.v ) );
+    double by_a = r.v * b.v / a.v;
+    double by_b = r.v * std::log( a.v );
+    for ( size_t i = 0; i < N; ++i ) r.d[i] = a.d[i] * by_a + b.d[i] * by_b;
+    return r;
+}
+
+// the weights as variables, weight i has a derivative of 1 with respect to itself
+array<Dual, N> variables( const Fsrs::Weights& w ) {
+    array<Dual, N> vars;
+    for ( size_t i = 0; i < N; ++i ) {
+        vars[i].v = w[i];
+        vars[i].d[i] = 1.0;
+    }
+    return vars;
+}
+
+struct Totals {
+    double loss = 0.0;
+    array<double, N> gradient{};
+    size_t predictions = 0;
+};
+
+// replays the reviews [begin, end), which start at a card boundary; T is double for the loss
+// alone and Dual when the gradient is needed as well
+template <typename T, typename W>
+void accumulate( const vector<ReviewRecord>& history, size_t begin, size_t end, const W& w,
+                 Totals& totals ) {
+    using std::log;
+    T stability = T();
+    T difficulty = T();
+    for ( size_t i = begin; i < end; ++i ) {
+        const ReviewRecord& review = history[i];
+        bool first = i == begin || history[i - 1].card_id != review.card_id;
+        if ( first || review.elapsed_days < 0 ) {
+            stability = Fsrs::initialStability<T>( w, review.rating );
+            difficulty = Fsrs::initialDifficulty<T>( w, review.rating );
+            continue;
+        }
+
+        T recall = Fsrs::retrievability( review.elapsed_days, stability );
+        // a same-day review says nothing about the forgetting curve, it only updates the state
+        if ( review.elapsed_days > 0 ) {
+            T p = recall;
+            if ( p < EPSILON ) p = T( EPSILON );
+            if ( p > 1.0 - EPSILON ) p = T( 1.0 - EPSILON );
+            T sample_loss = review.rating == Fsrs::AGAIN ? -log( 1.0 - p ) : -log( p );
+            if constexpr ( is_same_v<T, Dual> ) {
+                totals.loss += sample_loss.v;
+                for ( size_t k = 0; k < N; ++k ) totals.gradient[k] += sample_loss.d[k];
+            } else {
+                totals.loss += sample_loss;
+            }
+            ++totals.predictions;
+        }
+
+        stability = review.rating == Fsrs::AGAIN
+                        ? Fsrs::forgetStability( w, difficulty, stability, recall )
+                        : Fsrs::recallStability( w, difficulty, stability, recall, review.rating );
+        if ( stability < Fsrs::MIN_STABILITY ) stability = T( Fsrs::MIN_STABILITY );
+        difficulty = Fsrs::nextDifficulty( w, difficulty, review.rating );
+    }
+}
+
+// index of the first review of every card, followed by the end of the history
+vector<size_t> cardStarts( const vector<ReviewRecord>& history ) {
+    vector<size_t> starts;
+    for ( size_t i = 0; i < history.size(); ++i ) {
+        if ( i == 0 || history[i].card_id != history[i - 1].card_id ) starts.push_back( i );
+    }
+    starts.push_back( history.size() );
+    return starts;
+}
+
+// threads started once for a whole fit; run calls job( t ) for every worker t, the calling
+// thread being worker 0, and returns once all of them are done
+class WorkerPool {
+public:
+    explicit WorkerPool( size_t workers ) {
+        for ( size_t t = 1; t < workers; ++t ) threads_.emplace_back( [this, t] { work( t ); } );
+    }
+    ~WorkerPool() {
+        {
+            lock_guard<mutex> lock( mutex_ );
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for ( auto& worker : threads_ ) worker.join();
+    }
+    WorkerPool( const WorkerPool& ) = delete;
+    WorkerPool& operator=( const WorkerPool& ) = delete;
+
+    size_t size() const { return threads_.size() + 1; }
+
+    void run( const function<void( size_t )>& job ) {
+        {
+            lock_guard<mutex> lock( mutex_ );
+            job_ = &job;
+            pending_ = threads_.size();
+            ++generation_;
+        }
+        wake_.notify_all();
+        job( 0 );
+        unique_lock<mutex> lock( mutex_ );
+        done_.wait( lock, [this] { return pending_ == 0; } );
+    }
+
+private:
+    vector<thread> threads_;
+    mutex mutex_;
+    condition_variable wake_;
+    condition_variable done_;
+    const function<void( size_t )>* job_ = nullptr;
+    size_t pending_ = 0;
+    uint64_t generation_ = 0;  // one per run, so a worker takes every job exactly once
+    bool stopping_ = false;
+
+    void work( size_t t ) {
+        uint64_t seen = 0;
+        for ( ;; ) {
+            const function<void( size_t )>* job = nullptr;
+            {
+                unique_lock<mutex> lock( mutex_ );
+                wake_.wait( lock, [&] { return stopping_ || generation_ != seen; } );
+                if ( stopping_ ) return;
+                seen = generation_;
+                job = job_;
+            }
+            ( *job )( t );
+            lock_guard<mutex> lock( mutex_ );
+            if ( --pending_ == 0 ) done_.notify_one();
+        }
+    }
+};
+
+// replays the given cards on all workers of the pool; cards differ a lot in length, so each
+// worker gets a run of cards holding about the same number of reviews
+template <typename T, typename W>
+Totals replayCards( WorkerPool& pool, const vector<ReviewRecord>& history,
+                    const vector<size_t>& starts, const uint32_t* cards, size_t count,
+                    const W& w ) {
+    auto reviews = [&]( size_t c ) { return starts[cards[c] + 1] - starts[cards[c]]; };
+    size_t workers = max<size_t>( 1, min( pool.size(), count ) );
+    size_t total = 0;
+    for ( size_t c = 0; c < count; ++c ) total += reviews( c );
+
+    // worker t replays the cards [cuts[t], cuts[t + 1])
+    vector<size_t> cuts( workers + 1, count );
+    cuts[0] = 0;
+    size_t replayed = 0;
+    size_t t = 1;
+    for ( size_t c = 0; c < count && t < workers; ++c ) {
+        replayed += reviews( c );
+        while ( t < workers && replayed * workers >= total * t ) cuts[t++] = c + 1;
+    }
+
+    vector<Totals> partial( workers );
+    pool.run( [&]( size_t worker ) {
+        if ( worker >= workers ) return;
+        for ( size_t c = cuts[worker]; c < cuts[worker + 1]; ++c ) {
+            accumulate<T>( history, starts[cards[c]], starts[cards[c] + 1], w, partial[worker] );
+        }
+    } );
+
+    Totals sum;
+    for ( const Totals& part : partial ) {
+        sum.loss += part.loss;
+        sum.predictions += part.predictions;
+        for ( size_t k = 0; k < N; ++k ) sum.gradient[k] += part.gradient[k];
+    }
+    return sum;
+}
+
+// binary cross-entropy of a fixed stability against (elapsed days, recalled) samples
+double curveLoss( const vector<pair<int, bool>>& samples, double stability ) {
+    double total = 0.0;
+    for ( const auto& [elapsed, recalled] : samples ) {
+        double p = clamp( Fsrs::retrievability( elapsed, stability ), EPSILON, 1.0 - EPSILON );
+        total -= recalled ? std::log( p ) : std::log( 1.0 - p );
+    }
+    return total;
+}
+
+}  // namespace
+
+double FsrsOptimizer::loss( const vector<ReviewRecord>& history, const Fsrs::Weights& w ) {
+    Totals totals;
+    accumulate<double>( history, 0, history.size(), w, totals );
+    return totals.predictions ? totals.loss / totals.predictions : 0.0;
+}
+
+FsrsFit FsrsOptimizer::optimize( const vector<ReviewRecord>& history, const Fsrs::Weights& start,
+                                 const FsrsFitOptions& options ) {
+    unsigned workers = options.threads ? options.threads : thread::hardware_concurrency();
+    WorkerPool pool( max( workers, 1u ) );
+    vector<size_t> starts = cardStarts( history );
+    vector<uint32_t> cards( starts.size() - 1 );
+    iota( cards.begin(), cards.end(), 0 );
+
+    auto fullLoss = [&]( const Fsrs::Weights& w ) {
+        Totals totals = replayCards<double>( pool, history, starts, cards.data(), cards.size(),
+                                             w );
+        return make_pair( totals.predictions ? totals.loss / totals.predictions : 0.0,
+                          totals.predictions );
+    };
+
+    FsrsFit result;
+    result.weights = start;
+    tie( result.initial_loss, result.predictions ) = fullLoss( start );
+    result.loss = result.initial_loss;
+    if ( result.predictions < MIN_PREDICTIONS ) return result;
+
+    Fsrs::Weights w = start;
+    fitInitialStabilities( history, w );
+
+    // whole cards go into a batch until it holds batch_reviews reviews; small histories run
+    // more epochs so that Adam still takes min_steps steps
+    size_t batches = max<size_t>( 1, history.size() / options.batch_reviews );
+    size_t cards_per_batch = ( cards.size() + batches - 1 ) / batches;
+    int epochs = max<int>( options.epochs,
+                           static_cast<int>( ( options.min_steps + batches - 1 ) / batches ) );
+
+    mt19937 rng( options.seed );
+    array<double, N> m{};
+    array<double, N> v{};
+    constexpr double BETA1 = 0.9;
+    constexpr double BETA2 = 0.999;
+    int step = 0;
+    for ( int epoch = 0; epoch < epochs; ++epoch ) {
+        shuffle( cards.begin(), cards.end(), rng );
+        for ( size_t first = 0; first < cards.size(); first += cards_per_batch ) {
+            size_t count = min( cards_per_batch, cards.size() - first );
+            Totals batch = replayCards<Dual>( pool, history, starts, cards.data() + first, count,
+                                              variables( w ) );
+            if ( batch.predictions == 0 ) continue;
+
+            ++step;
+            for ( size_t k = 0; k < N; ++k ) {
+                double g = batch.gradient[k] / batch.predictions;
+                m[k] = BETA1 * m[k] + ( 1.0 - BETA1 ) * g;
+                v[k] = BETA2 * v[k] + ( 1.0 - BETA2 ) * g * g;
+                double m_hat = m[k] / ( 1.0 - std::pow( BETA1, step ) );
+                double v_hat = v[k] / ( 1.0 - std::pow( BETA2, step ) );
+                w[k] -= options.learning_rate * m_hat / ( sqrt( v_hat ) + 1e-8 );
+                w[k] = clamp( w[k], Fsrs::MIN_WEIGHTS[k], Fsrs::MAX_WEIGHTS[k] );
+            }
+        }
+
+        // batches are noisy, the weights are judged on the whole history after every epoch
+        double epoch_loss = fullLoss( w ).first;
+        if ( epoch_loss < result.loss ) {
+            result.loss = epoch_loss;
+            result.weights = w;
+        }
+    }
+    return result;
+}
+
+// the stability after a first rating has the largest range of all weights, which plain gradient
+// steps would take long to cover; it is fitted directly on the second review of each card,
+// searching over log stability, and kept increasing from AGAIN to EASY
+void FsrsOptimizer::fitInitialStabilities( const vector<ReviewRecord>& history,
+                                           Fsrs::Weights& w ) {
+    constexpr size_t MIN_SAMPLES = 20;
+    array<vector<pair<int, bool>>, 4> samples;
+    for ( size_t i = 1; i < history.size(); ++i ) {
+        const ReviewRecord& second = history[i];
+        const ReviewRecord& first = history[i - 1];
+        bool starts_card = i == 1 || history[i - 2].card_id != first.card_id ||
+                           first.elapsed_days < 0;
+        if ( first.card_id != second.card_id || !starts_card || second.elapsed_days <= 0 ) {
+            continue;
+        }
+        samples[first.rating - 1].push_back(
+            { second.elapsed_days, second.rating != Fsrs::AGAIN } );
+    }
+
+    for ( size_t r = 0; r < samples.size(); ++r ) {
+        if ( samples[r].size() < MIN_SAMPLES ) continue;
+        double lo = std::log( Fsrs::MIN_WEIGHTS[r] );
+        double hi = std::log( Fsrs::MAX_WEIGHTS[r] );
+        for ( int round = 0; round < 60; ++round ) {
+            double a = lo + ( hi - lo ) / 3.0;
+            double b = hi - ( hi - lo ) / 3.0;
+            if ( curveLoss( samples[r], std::exp( a ) ) < curveLoss( samples[r], std::exp( b ) ) ) {
+                hi = b;
+            } else {
+                lo = a;
+            }
+        }
+        w[r] = std::exp( ( lo + hi ) / 2.0 );
+    }
+    for ( size_t r = 1; r < samples.size(); ++r ) w[r] = max( w[r], w[r - 1] );
+}
@@ -0,0 +1,54 @@
+/*
+ * @authors: Jakub Jurczak, Mateusz Woźniak
+ * summary: Fits FSRS weights to a user's review history with parallel gradient descent - header
+ * file.
+ */
+#pragma once
+#include <cstddef>
+#include <vector>
+
+#include "Fsrs.h"
+
+// one logged review; elapsed_days is -1 for the first review of a card (or after a reset)
+struct ReviewRecord {
+    int card_id = 0;
+    int rating = Fsrs::GOOD;
+    int elapsed_days = -1;
+};
+
+struct FsrsFitOptions {
+    int epochs = 5;
+    int min_steps = 80;
+    std::size_t batch_reviews = 8192;
+    double learning_rate = 0.04;
+    unsigned threads = 0;  // 0 runs one worker per core
+    unsigned seed = 1;     // order of the cards in each epoch
+};
+
+struct FsrsFit {
+    Fsrs::Weights weights;
+    double initial_loss = 0.0;  // log loss of the starting weights
+    double loss = 0.0;          // log loss of the returned weights, never above initial_loss
+    std::size_t predictions = 0;
+};
+
+class FsrsOptimizer {
+public:
+    // at least this many predicted recalls are needed before weights are fitted at all
+    static constexpr std::size_t MIN_PREDICTIONS = 100;
+
+    // the history must be grouped by card and ordered by time within each card; the initial
+    // stabilities are fitted first from each card's second review, then all weights are refined
+    // by mini-batch Adam, every batch replayed by all cores with its reviews split between them;
+    // the worker threads are started once per fit
+    static FsrsFit optimize( const std::vector<ReviewRecord>& history,
+                             const Fsrs::Weights& start = Fsrs::DEFAULT_WEIGHTS,
+                             const FsrsFitOptions& options = FsrsFitOptions() );
+    // mean binary cross-entropy between predicted recall and the outcome of each review that
+    // came at least a day after the previous one
+    static double loss( const std::vector<ReviewRecord>& history, const Fsrs::Weights& w );
+
+private:
+    static void fitInitialStabilities( const std::vector<ReviewRecord>& history,
+                                       Fsrs::Weights& w );
+};
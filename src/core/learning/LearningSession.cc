@@ -2,64 +2,128 @@
  * @authors: Jakub Jurczak, Mateusz Woźniak
  * summary: Learning session implementation.
  */
+#include <algorithm>
+#include <limits>
 #include <stdexcept>
 
 #include "LearningSession.h"
+#include "schedulers/Schedulers.h"
+#include "strategies/SelectionStrategies.h"
 
 using namespace std;
 
-LearningSession::LearningSession( DatabaseManager& db ) : db_( db ) {}
+LearningSession::LearningSession( DatabaseManager& db, uint32_t seed )
+    : db_( db ),
+      rng_( seed ),
+      scheduler_( make_unique<SuperMemoScheduler>() ),
+      clock_( make_unique<SteadySessionClock>() ) {}
+
+void LearningSession::setScheduler( unique_ptr<IScheduler> scheduler ) {
+    if ( !scheduler ) {
+        throw invalid_argument( "Scheduler cannot be null" );
+    }
+    scheduler_ = std::move( scheduler );
+}
+
+void LearningSession::setRelearningOptions( RelearningOptions options ) {
+    queue_.setOptions( std::move( options ) );
+}
+
+void LearningSession::setClock( unique_ptr<ISessionClock> clock ) {
+    if ( !clock ) {
+        throw invalid_argument( "Clock cannot be null" );
+    }
+    clock_ = std::move( clock );
+}
 
 void LearningSession::start( int set_id, unique_ptr<ICardSelectionStrategy> strategy, int limit ) {
     if ( !strategy ) {
         throw invalid_argument( "Strategy cannot be null" );
     }
-    vector<Card> cards = strategy->selectCards( db_, set_id, limit );
+    strategy->open( db_, set_id );
+    strategy_ = std::move( strategy );
+    limit_ = limit < 0 ? UNLIMITED : limit;
 
-    session_queue_.clear();
-    for ( const auto& c : cards ) {
-        session_queue_.push_back( c );
-    }
+    cards_.clear();
+    queue_.reset( 0 );
+    current_ = NO_CARD;
 
-    total_cards_initial_ = session_queue_.size();
+    cards_passed_ = 0;
     nextCard();
 }
 
+// the merge is read page by page like any strategy, so an UNLIMITED session counts nothing up
+// front and reads each set only as far as the cards shown reach into it
+void LearningSession::start( const vector<int>& set_ids, int limit, int per_set_cap ) {
+    if ( per_set_cap < 0 ) per_set_cap = numeric_limits<int>::max();
+    start( MERGED_SETS, make_unique<MergedDueStrategy>( set_ids, per_set_cap ), limit );
+}
+
 bool LearningSession::nextCard() {
-    if ( session_queue_.empty() ) {
-        current_card_.reset();
-        return false;
+    if ( queue_.unseenCount() == 0 ) fetchPage();
+    current_ = queue_.pop( clock_->now() );
+    return current_ != NO_CARD;
+}
+
+// a short page means the strategy has nothing more, it is dropped so it is not asked again
+void LearningSession::fetchPage() {
+    if ( !strategy_ ) return;
+    int count = PAGE_SIZE;
+    if ( limit_ != UNLIMITED ) count = min( count, limit_ - static_cast<int>( cards_.size() ) );
+    if ( count <= 0 ) {
+        strategy_.reset();
+        return;
+    }
+
+    vector<ScheduledCard> page = strategy_->fetch( count );
+    if ( static_cast<int>( page.size() ) < count ) strategy_.reset();
+    for ( ScheduledCard& card : page ) {
+        card.card.setAnswerKeyOptions( key_options_ );
+        cards_.push_back( std::move( card ) );
     }
+    queue_.append( page.size() );
+}
 
-    current_card_ = session_queue_.front();
-    session_queue_.pop_front();
-    return true;
+size_t LearningSession::fetchable() const {
+    if ( !strategy_ ) return 0;
+    if ( limit_ == UNLIMITED ) return strategy_->remaining();
+    return min( strategy_->remaining(), static_cast<size_t>( limit_ ) - cards_.size() );
 }
 
 const Card& LearningSession::getCurrentCard() const {
-    if ( !current_card_.has_value() ) {
+    if ( current_ == NO_CARD ) {
         throw runtime_error( "No active card" );
     }
-    return *current_card_;
+    return cards_[current_].card;
 }
 
-void LearningSession::submitGrade( int grade ) {
-    if ( !current_card_.has_value() ) return;
+ChoiceOrder LearningSession::shuffleCurrentChoices() {
+    return getCurrentCard().shuffleChoices( rng_ );
+}
 
-    auto [iv, rep, ef] = db_.getCardProgress( current_card_->getId() );
-    SuperMemoState currentState{ iv, rep, ef };
+// the state selected with the card is kept up to date here, so grading is a single write; a
+// card graded again in the same session was last seen 0 days ago
+void LearningSession::submitGrade( int grade ) {
+    if ( current_ == NO_CARD ) return;
 
-    SuperMemoState newState = SuperMemo::calculate( grade, currentState );
-    string nextDate = DatabaseManager::calculateNextDate( newState.interval );
-    db_.updateCardProgress( current_card_->getId(), newState.interval, newState.repetitions,
-                            newState.easiness, nextDate );
+    ScheduledCard& current = cards_[current_];
+    ReviewOutcome next = scheduler_->review( current, grade );
+    if ( db_.saveReview( current.card.getId(), grade, current.elapsed_days, next.state,
+                         next.memory ) ) {
+        current.state = next.state;
+        current.memory = next.memory;
+        current.elapsed_days = 0;
+    }
 
-    if ( grade < 3 ) {
-        session_queue_.push_back( *current_card_ );
+    if ( grade < SuperMemo::PASSING_GRADE ) {
+        queue_.relearn( current_, clock_->now() );
+    } else {
+        ++cards_passed_;
     }
 }
 
 float LearningSession::getProgress() const {
-    if ( total_cards_initial_ == 0 ) return FULL_PROGRESS;
-    return FULL_PROGRESS - ( static_cast<float>( session_queue_.size() ) / total_cards_initial_ );
+    size_t total = cards_.size() + fetchable();
+    if ( total == 0 ) return FULL_PROGRESS;
+    return static_cast<float>( cards_passed_ ) / total;
 }
\ No newline at end of file
@@ -3,13 +3,17 @@
  * summary: Learning session managing card flow and logic.
  */
 #pragma once
-#include <vector>
 #include <deque>
+#include <vector>
 #include <memory>
-#include <optional>
+#include <random>
 
 #include "Card.h"
+#include "ScheduledCard.h"
 #include "../../db/DatabaseManager.h"
+#include "RelearningQueue.h"
+#include "SessionClock.h"
+#include "schedulers/IScheduler.h"
 #include "strategies/ICardSelectionStrategy.h"
 #include "SuperMemo.h"
 
@@ -17,21 +21,65 @@ enum class LearningMode { SpacedRepetition, Random };
 
 class LearningSession {
 public:
-    explicit LearningSession( DatabaseManager& db );
+    // the seed fixes the order of quiz choices, tests pass their own
+    explicit LearningSession( DatabaseManager& db,
+                              std::uint32_t seed = std::random_device{}() );
+
+    static constexpr int UNLIMITED = -1;
+    // cards fetched from the strategy at once, only when the session has shown all the others
+    static constexpr int PAGE_SIZE = 10;
 
+    // the strategy is read page by page as the session goes, so the limit costs nothing until
+    // the cards are shown; UNLIMITED runs until the strategy has no more
     void start( int set_id, std::unique_ptr<ICardSelectionStrategy> strategy, int limit = 20 );
+    // due cards of all the sets, the most overdue first whichever set they are in; no set gives
+    // more than per_set_cap of the limit, either of which may be UNLIMITED
+    void start( const std::vector<int>& set_ids, int limit, int per_set_cap );
+    // SM-2 until another scheduler is set, the choice holds for all following sessions
+    void setScheduler( std::unique_ptr<IScheduler> scheduler );
+    // learning steps and gap for failed cards, and the clock they are measured with; both hold
+    // for all following sessions
+    void setRelearningOptions( RelearningOptions options );
+    void setClock( std::unique_ptr<ISessionClock> clock );
+    // how typed answers are compared, applied to every card as it is fetched; holds for all
+    // following sessions
+    void setAnswerKeyOptions( AnswerKeyOptions options ) { key_options_ = options; }
 
     bool nextCard();
+    // the reference stays valid until the next start(): fetched cards are moved into the session
+    // once and stay where they are while later pages are appended
     const Card& getCurrentCard() const;
+    // a fresh order of the current card's choices, drawn from the session's generator
+    ChoiceOrder shuffleCurrentChoices();
     void submitGrade( int grade );
 
+    // share of the session's cards already passed, a failed card counts once it is passed; the
+    // cards not fetched yet count as far as the strategy knows them
     float getProgress() const;
     static constexpr float NO_PROGRESS = 0.0f;
     static constexpr float FULL_PROGRESS = 1.0f;
 
 private:
+    static constexpr size_t NO_CARD = RelearningQueue::NO_CARD;
+    // the set id a merged strategy is opened with, it reads the sets it was given
+    static constexpr int MERGED_SETS = -1;
+
     DatabaseManager& db_;
-    std::deque<Card> session_queue_;
-    std::optional<Card> current_card_;
-    int total_cards_initial_ = 0;
+    // the session owns its cards, the queue holds indices into them; a deque keeps them in place
+    // while pages are appended
+    std::deque<ScheduledCard> cards_;
+    RelearningQueue queue_;
+    size_t current_ = NO_CARD;
+    int cards_passed_ = 0;
+    // null once the strategy is exhausted or the limit is reached
+    std::unique_ptr<ICardSelectionStrategy> strategy_;
+    int limit_ = UNLIMITED;
+    AnswerKeyOptions key_options_;
+    std::mt19937 rng_;
+    std::unique_ptr<IScheduler> scheduler_;
+    std::unique_ptr<ISessionClock> clock_;
+
+    void fetchPage();
+    // cards the session may still fetch, within the limit
+    size_t fetchable() const;
 };
\ No newline at end of file
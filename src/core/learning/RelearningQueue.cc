@@ -0,0 +1,92 @@
+/*
+ * @authors: Jakub Jurczak, Mateusz Woźniak
+ * summary: Order in which a learning session shows its cards and brings back failed ones - source
+ * file.
+ */
+#include <algorithm>
+
+#include "RelearningQueue.h"
+
+using namespace std;
+
+RelearningQueue::RelearningQueue( RelearningOptions options ) : options_( std::move( options ) ) {}
+
+void RelearningQueue::setOptions( RelearningOptions options ) {
+    options_ = std::move( options );
+}
+
+// a card waits in the heap at most once, so nothing grows while the session is graded
+void RelearningQueue::reset( size_t count ) {
+    unseen_count_ = count;
+    next_unseen_ = 0;
+    heap_.clear();
+    heap_.reserve( count );
+    held_.clear();
+    held_.reserve( options_.min_gap + 1 );
+    lapses_.assign( count, 0 );
+    allowed_from_.assign( count, 0 );
+    picks_ = 0;
+    failures_ = 0;
+}
+
+void RelearningQueue::append( size_t count ) {
+    unseen_count_ += count;
+    lapses_.resize( unseen_count_, 0 );
+    allowed_from_.resize( unseen_count_, 0 );
+}
+
+// failed cards that are due come first, then the cards not seen yet, then failed cards ahead of
+// their time; at most min_gap cards are held back by the gap, so a pick stays O(log n)
+size_t RelearningQueue::pop( TimePoint now ) {
+    held_.clear();
+    size_t card = popAllowed( now );
+    if ( card == NO_CARD && next_unseen_ < unseen_count_ ) card = next_unseen_++;
+    if ( card == NO_CARD ) card = popAllowed( TimePoint::max() );
+    // only recently failed cards are left, the earliest of them comes back despite the gap
+    if ( card == NO_CARD && !held_.empty() ) {
+        card = held_.front().card;
+        held_.erase( held_.begin() );
+    }
+    for ( const Entry& entry : held_ ) push( entry );
+
+    if ( card != NO_CARD ) ++picks_;
+    return card;
+}
+
+void RelearningQueue::relearn( size_t card, TimePoint now ) {
+    chrono::minutes step( 0 );
+    if ( !options_.steps.empty() ) {
+        size_t last = options_.steps.size() - 1;
+        step = options_.steps[min( static_cast<size_t>( lapses_[card] ), last )];
+    }
+    ++lapses_[card];
+    // the card was the last one picked, picks_ already counts it
+    allowed_from_[card] = picks_ + options_.min_gap;
+    push( { now + step, failures_++, card } );
+}
+
+// the std heap algorithms keep the largest element on top, so the order is reversed
+bool RelearningQueue::laterThan( const Entry& a, const Entry& b ) {
+    return a.due != b.due ? a.due > b.due : a.order > b.order;
+}
+
+void RelearningQueue::push( const Entry& entry ) {
+    heap_.push_back( entry );
+    push_heap( heap_.begin(), heap_.end(), laterThan );
+}
+
+RelearningQueue::Entry RelearningQueue::popTop() {
+    pop_heap( heap_.begin(), heap_.end(), laterThan );
+    Entry top = heap_.back();
+    heap_.pop_back();
+    return top;
+}
+
+size_t RelearningQueue::popAllowed( TimePoint deadline ) {
+    while ( !heap_.empty() && heap_.front().due <= deadline ) {
+        Entry top = popTop();
+        if ( allowed_from_[top.card] <= picks_ ) return top.card;
+        held_.push_back( top );
+    }
+    return NO_CARD;
+}
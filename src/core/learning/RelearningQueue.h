@@ -0,0 +1,69 @@
+/*
+ * @authors: Jakub Jurczak, Mateusz Woźniak
+ * summary: Order in which a learning session shows its cards and brings back failed ones - header
+ * file.
+ */
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "SessionClock.h"
+
+struct RelearningOptions {
+    // a card failed for the n-th time in a session is due again after steps[n - 1], the last step
+    // repeats for further failures
+    std::vector<std::chrono::minutes> steps = { std::chrono::minutes( 1 ),
+                                                std::chrono::minutes( 10 ) };
+    // other cards shown before a failed card may come back, as long as there are any
+    std::size_t min_gap = 3;
+};
+
+// cards are indices 0 to count - 1, first shown in that order; failed cards wait in a min-heap
+// keyed by due time and are shown as soon as they are due, ahead of the cards not seen yet
+class RelearningQueue {
+public:
+    using TimePoint = ISessionClock::TimePoint;
+    static constexpr std::size_t NO_CARD = static_cast<std::size_t>( -1 );
+
+    explicit RelearningQueue( RelearningOptions options = RelearningOptions() );
+
+    void setOptions( RelearningOptions options );
+    const RelearningOptions& getOptions() const { return options_; }
+
+    void reset( std::size_t count );
+    // count further cards after the ones queued so far, first shown after all of them
+    void append( std::size_t count );
+    // the next card to show, taken out of the queue; O(log n), NO_CARD when the queue is empty
+    std::size_t pop( TimePoint now );
+    // queue a card that was just failed again, due after its next learning step
+    void relearn( std::size_t card, TimePoint now );
+
+    bool empty() const { return size() == 0; }
+    std::size_t size() const { return unseen_count_ - next_unseen_ + heap_.size(); }
+    std::size_t unseenCount() const { return unseen_count_ - next_unseen_; }
+
+private:
+    struct Entry {
+        TimePoint due;
+        std::uint64_t order;  // cards due at the same time come back in the order they failed
+        std::size_t card;
+    };
+
+    RelearningOptions options_;
+    std::size_t unseen_count_ = 0;
+    std::size_t next_unseen_ = 0;
+    std::vector<Entry> heap_;
+    std::vector<Entry> held_;                 // popped while blocked by the gap, pushed back after
+    std::vector<std::uint32_t> lapses_;       // failures of each card in this session
+    std::vector<std::uint64_t> allowed_from_;  // first pick a card may be shown at
+    std::uint64_t picks_ = 0;
+    std::uint64_t failures_ = 0;
+
+    static bool laterThan( const Entry& a, const Entry& b );
+    void push( const Entry& entry );
+    Entry popTop();
+    // the earliest queued card due by the deadline and allowed by the gap, NO_CARD if none is
+    std::size_t popAllowed( TimePoint deadline );
+};
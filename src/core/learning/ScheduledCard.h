@@ -0,0 +1,16 @@
+/*
+ * @authors: Jakub Jurczak, Mateusz Woźniak
+ * summary: Structure pairing a card with its scheduling state, as selected for a learning session.
+ */
+#pragma once
+#include "Card.h"
+#include "Fsrs.h"
+#include "SuperMemo.h"
+
+// state is the initial SM-2 state and memory is empty for cards that were never reviewed
+struct ScheduledCard {
+    Card card;
+    SuperMemoState state;
+    FsrsState memory{};
+    int elapsed_days = -1;  // days since the last review, -1 when there is none
+};
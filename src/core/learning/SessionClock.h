@@ -0,0 +1,19 @@
+/*
+ * @authors: Jakub Jurczak, Mateusz Woźniak
+ * summary: Clock a learning session reads when it schedules failed cards - header file.
+ */
+#pragma once
+#include <chrono>
+
+class ISessionClock {
+public:
+    using TimePoint = std::chrono::steady_clock::time_point;
+
+    virtual ~ISessionClock() = default;
+    virtual TimePoint now() const = 0;
+};
+
+class SteadySessionClock : public ISessionClock {
+public:
+    TimePoint now() const override { return std::chrono::steady_clock::now(); }
+};
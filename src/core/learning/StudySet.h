@@ -9,6 +9,8 @@ struct StudySet {
     int id;
     std::string name;
     int card_count = 0;
+    std::string last_activity;  // local "yyyy-MM-dd HH:mm:ss" of the last added card or review
+    int due_count = 0;          // as of the last due recount, see DatabaseManager::refreshDueCounts
 
     StudySet() = default;
     StudySet( int id, std::string name, int count = 0 )
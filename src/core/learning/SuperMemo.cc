@@ -2,37 +2,158 @@
  * @authors: Jakub Jurczak, Mateusz Woźniak
  * summary: SuperMemo-2 algorithm math logic - source file.
  */
-#include <cmath>
+#include <cstring>
+
+#if defined( __x86_64__ ) || defined( _M_X64 )
+#include <immintrin.h>
+#define SUPERMEMO_SSE2 1
+#endif
+#if defined( SUPERMEMO_SSE2 ) && defined( __GNUC__ )
+#define SUPERMEMO_AVX2 1
+#endif
 
 #include "SuperMemo.h"
 
 using namespace std;
 
-SuperMemoState SuperMemo::calculate( int grade, const SuperMemoState& current_state ) {
-    int next_interval = 0;
-    int next_rep = 0;
-    float next_ef = current_state.easiness;
-
-    // If the grade is greater than or equal to 3, the review is considered successful
-    if ( grade >= 3 ) {
-        if ( current_state.repetitions == 0 )
-            next_interval = 1;
-        else if ( current_state.repetitions == 1 )
-            next_interval = 6;
-        else
-            next_interval =
-                static_cast<int>( ceil( current_state.interval * current_state.easiness ) );
-
-        next_rep = current_state.repetitions + 1;
-
-        // from the formula: EF':=EF+(0.1-(5-q)*(0.08+(5-q)*0.02))
-        next_ef = current_state.easiness +
-                  ( 0.1f - ( 5.0f - grade ) * ( 0.08f + ( 5.0f - grade ) * 0.02f ) );
-        if ( next_ef < MIN_EASINESS ) next_ef = MIN_EASINESS;
-    } else {
-        next_rep = 0;
-        next_interval = 1;
+namespace {
+
+// the vector paths repeat Sm2::calculate lane by lane: int to float conversion, one float
+// multiply, ceil, one float add and the clamp are all exactly rounded, so every lane matches the
+// scalar result; steps, deltas and clamps are the policy's own compile-time constants
+
+#ifdef SUPERMEMO_SSE2
+inline __m128i selectInt( __m128i mask, __m128i yes, __m128i no ) {
+    return _mm_or_si128( _mm_and_si128( mask, yes ), _mm_andnot_si128( mask, no ) );
+}
+
+inline __m128 selectFloat( __m128 mask, __m128 yes, __m128 no ) {
+    return _mm_or_ps( _mm_and_ps( mask, yes ), _mm_andnot_ps( mask, no ) );
+}
+
+// four cards per step, the rest is left to the caller
+size_t calculateSse2( size_t count, const uint8_t* grades, int32_t* intervals,
+                      int32_t* repetitions, float* easiness ) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi32( 1 );
+    const __m128i lapse = _mm_set1_epi32( Sm2::LAPSE_INTERVAL );
+    const __m128i failing = _mm_set1_epi32( Sm2::PASSING_GRADE - 1 );
+    const __m128 min_ef = _mm_set1_ps( Sm2::MIN_EASINESS );
+
+    size_t i = 0;
+    for ( ; i + 4 <= count; i += 4 ) {
+        int32_t packed;
+        memcpy( &packed, grades + i, sizeof( packed ) );
+        __m128i grade = _mm_unpacklo_epi16(
+            _mm_unpacklo_epi8( _mm_cvtsi32_si128( packed ), zero ), zero );
+        __m128i interval = _mm_loadu_si128( reinterpret_cast<const __m128i*>( intervals + i ) );
+        __m128i rep = _mm_loadu_si128( reinterpret_cast<const __m128i*>( repetitions + i ) );
+        __m128 ef = _mm_loadu_ps( easiness + i );
+
+        // ceil as truncation plus one where the product has a fraction
+        __m128 product = _mm_mul_ps( _mm_cvtepi32_ps( interval ), ef );
+        __m128i truncated = _mm_cvttps_epi32( product );
+        __m128i fraction =
+            _mm_castps_si128( _mm_cmplt_ps( _mm_cvtepi32_ps( truncated ), product ) );
+        __m128i next = _mm_sub_epi32( truncated, fraction );
+        for ( size_t step = 0; step < Sm2::STEPS.size(); ++step ) {
+            __m128i at_step = _mm_cmpeq_epi32( rep, _mm_set1_epi32( static_cast<int>( step ) ) );
+            next = selectInt( at_step, _mm_set1_epi32( Sm2::STEPS[step] ), next );
+        }
+
+        // grades above the table share its last delta, as in Sm2::easinessDelta
+        __m128 delta = _mm_set1_ps( Sm2::DELTAS[Sm2::GRADES - 1] );
+        for ( int g = Sm2::PASSING_GRADE; g < Sm2::GRADES - 1; ++g ) {
+            __m128i is_grade = _mm_cmpeq_epi32( grade, _mm_set1_epi32( g ) );
+            delta = selectFloat( _mm_castsi128_ps( is_grade ), _mm_set1_ps( Sm2::DELTAS[g] ),
+                                 delta );
+        }
+        __m128 next_ef = _mm_max_ps( min_ef, _mm_add_ps( ef, delta ) );
+
+        __m128i passed = _mm_cmpgt_epi32( grade, failing );
+        _mm_storeu_si128( reinterpret_cast<__m128i*>( intervals + i ),
+                          selectInt( passed, next, lapse ) );
+        _mm_storeu_si128( reinterpret_cast<__m128i*>( repetitions + i ),
+                          _mm_and_si128( passed, _mm_add_epi32( rep, one ) ) );
+        _mm_storeu_ps( easiness + i, selectFloat( _mm_castsi128_ps( passed ), next_ef, ef ) );
+    }
+    return i;
+}
+#endif
+
+#ifdef SUPERMEMO_AVX2
+static_assert( Sm2::GRADES <= 8, "the deltas must fit one AVX2 register" );
+
+// eight cards per step, compiled for AVX2 only here so the rest of the build keeps its baseline
+__attribute__( ( target( "avx2" ) ) ) size_t calculateAvx2( size_t count, const uint8_t* grades,
+                                                           int32_t* intervals,
+                                                           int32_t* repetitions,
+                                                           float* easiness ) {
+    const __m256i one = _mm256_set1_epi32( 1 );
+    const __m256i lapse = _mm256_set1_epi32( Sm2::LAPSE_INTERVAL );
+    const __m256i failing = _mm256_set1_epi32( Sm2::PASSING_GRADE - 1 );
+    const __m256i last_grade = _mm256_set1_epi32( Sm2::GRADES - 1 );
+    const __m256 min_ef = _mm256_set1_ps( Sm2::MIN_EASINESS );
+    float table[8] = {};
+    for ( int g = 0; g < Sm2::GRADES; ++g ) table[g] = Sm2::DELTAS[g];
+    const __m256 deltas = _mm256_loadu_ps( table );
+
+    size_t i = 0;
+    for ( ; i + 8 <= count; i += 8 ) {
+        __m256i grade = _mm256_cvtepu8_epi32(
+            _mm_loadl_epi64( reinterpret_cast<const __m128i*>( grades + i ) ) );
+        __m256i interval =
+            _mm256_loadu_si256( reinterpret_cast<const __m256i*>( intervals + i ) );
+        __m256i rep = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( repetitions + i ) );
+        __m256 ef = _mm256_loadu_ps( easiness + i );
+
+        __m256 product = _mm256_mul_ps( _mm256_cvtepi32_ps( interval ), ef );
+        __m256i next = _mm256_cvttps_epi32( _mm256_ceil_ps( product ) );
+        for ( size_t step = 0; step < Sm2::STEPS.size(); ++step ) {
+            __m256i at_step =
+                _mm256_cmpeq_epi32( rep, _mm256_set1_epi32( static_cast<int>( step ) ) );
+            next = _mm256_blendv_epi8( next, _mm256_set1_epi32( Sm2::STEPS[step] ), at_step );
+        }
+
+        // lanes of failing grades pick some delta too, their easiness is not changed anyway
+        __m256i index = _mm256_min_epu32( grade, last_grade );
+        __m256 next_ef =
+            _mm256_max_ps( min_ef, _mm256_add_ps( ef, _mm256_permutevar8x32_ps( deltas, index ) ) );
+
+        __m256i passed = _mm256_cmpgt_epi32( grade, failing );
+        _mm256_storeu_si256( reinterpret_cast<__m256i*>( intervals + i ),
+                             _mm256_blendv_epi8( lapse, next, passed ) );
+        _mm256_storeu_si256( reinterpret_cast<__m256i*>( repetitions + i ),
+                             _mm256_and_si256( passed, _mm256_add_epi32( rep, one ) ) );
+        _mm256_storeu_ps( easiness + i,
+                          _mm256_blendv_ps( ef, next_ef, _mm256_castsi256_ps( passed ) ) );
     }
+    return i;
+}
+
+bool hasAvx2() {
+    static const bool supported = __builtin_cpu_supports( "avx2" );
+    return supported;
+}
+#endif
+
+}  // namespace
 
-    return { next_interval, next_rep, next_ef };
+void SuperMemo::calculateBatch( size_t count, const uint8_t* grades, int32_t* intervals,
+                                int32_t* repetitions, float* easiness ) {
+    size_t done = 0;
+#ifdef SUPERMEMO_AVX2
+    if ( hasAvx2() ) done = calculateAvx2( count, grades, intervals, repetitions, easiness );
+#endif
+#ifdef SUPERMEMO_SSE2
+    done += calculateSse2( count - done, grades + done, intervals + done, repetitions + done,
+                           easiness + done );
+#endif
+    // whatever the vector paths left over, or everything on other architectures
+    for ( size_t i = done; i < count; ++i ) {
+        SuperMemoState next = calculate( grades[i], { intervals[i], repetitions[i], easiness[i] } );
+        intervals[i] = next.interval;
+        repetitions[i] = next.repetitions;
+        easiness[i] = next.easiness;
+    }
 }
@@ -3,22 +3,28 @@
  * summary: SuperMemo-2 algorithm math logic - header file.
  */
 #pragma once
+#include <cstddef>
+#include <cstdint>
 
-struct SuperMemoState {
-    int interval;     // days to next review
-    int repetitions;  // number of successful reviews
-    float easiness;   // easiness factor (interval modifier)
-};
+#include "SuperMemoPolicy.h"
 
+// the SM-2 variant the application schedules with
 class SuperMemo {
 public:
-    static constexpr int INITIAL_INTERVAL = 0;
-    static constexpr int INITIAL_REPETITIONS = 0;
-    static constexpr float INITIAL_EASINESS = 2.5f;
-    static constexpr float MIN_EASINESS = 1.3f;
+    static constexpr int INITIAL_INTERVAL = Sm2::INITIAL_INTERVAL;
+    static constexpr int INITIAL_REPETITIONS = Sm2::INITIAL_REPETITIONS;
+    static constexpr float INITIAL_EASINESS = Sm2::INITIAL_EASINESS;
+    static constexpr float MIN_EASINESS = Sm2::MIN_EASINESS;
+    static constexpr int PASSING_GRADE = Sm2::PASSING_GRADE;
 
-    static SuperMemoState getInitialState() {
-        return { INITIAL_INTERVAL, INITIAL_REPETITIONS, INITIAL_EASINESS };
+    static constexpr SuperMemoState getInitialState() { return Sm2::initialState(); }
+    static constexpr SuperMemoState calculate( int grade, const SuperMemoState& current ) {
+        return Sm2::calculate( grade, current );
     }
-    static SuperMemoState calculate( int grade, const SuperMemoState& current );
-};
\ No newline at end of file
+    static constexpr float easinessDelta( int grade ) { return Sm2::easinessDelta( grade ); }
+    // calculate for count cards with grades 0-5 and states stored column by column, updated in
+    // place; vectorized with AVX2 or SSE2 when the CPU has them and bit-identical to calculate
+    static void calculateBatch( std::size_t count, const std::uint8_t* grades,
+                                std::int32_t* intervals, std::int32_t* repetitions,
+                                float* easiness );
+};
@@ -0,0 +1,88 @@
+/*
+ * @authors: Jakub Jurczak, Mateusz Woźniak
+ * summary: SuperMemo-2 variants configured and tabulated at compile time - header file.
+ */
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+struct SuperMemoState {
+    int interval;     // days to next review
+    int repetitions;  // number of successful reviews
+    float easiness;   // easiness factor (interval modifier)
+};
+
+// parameters of the original SM-2; a variant derives from it and redeclares what it changes
+struct Sm2Config {
+    static constexpr int PASSING_GRADE = 3;
+    static constexpr float INITIAL_EASINESS = 2.5f;
+    static constexpr float MIN_EASINESS = 1.3f;
+    // intervals after the first successful reviews, later ones multiply by the easiness
+    static constexpr std::array<int, 2> STEPS = { 1, 6 };
+    static constexpr int LAPSE_INTERVAL = 1;
+
+    // from the formula: EF':=EF+(0.1-(5-q)*(0.08+(5-q)*0.02))
+    static constexpr float easinessDelta( int grade ) {
+        return 0.1f - ( 5.0f - grade ) * ( 0.08f + ( 5.0f - grade ) * 0.02f );
+    }
+};
+
+template <typename Config>
+constexpr std::array<float, 6> easinessDeltas() {
+    std::array<float, 6> deltas{};
+    for ( std::size_t grade = 0; grade < deltas.size(); ++grade ) {
+        deltas[grade] = Config::easinessDelta( static_cast<int>( grade ) );
+    }
+    return deltas;
+}
+
+// SM-2 with everything the configuration decides folded into constants and tables, so each
+// variant is its own instantiation and review has no branches beyond those of SM-2 itself
+template <typename Config>
+class SuperMemoPolicy {
+public:
+    static constexpr int GRADES = 6;
+    static constexpr int INITIAL_INTERVAL = 0;
+    static constexpr int INITIAL_REPETITIONS = 0;
+    static constexpr int PASSING_GRADE = Config::PASSING_GRADE;
+    static constexpr float INITIAL_EASINESS = Config::INITIAL_EASINESS;
+    static constexpr float MIN_EASINESS = Config::MIN_EASINESS;
+    static constexpr int LAPSE_INTERVAL = Config::LAPSE_INTERVAL;
+    static constexpr auto STEPS = Config::STEPS;
+    static constexpr std::array<float, GRADES> DELTAS = easinessDeltas<Config>();
+
+    static_assert( PASSING_GRADE > 0 && PASSING_GRADE < GRADES, "grades are 0-5" );
+    static_assert( MIN_EASINESS > 0.0f && MIN_EASINESS <= INITIAL_EASINESS );
+    static_assert( STEPS.size() > 0 && LAPSE_INTERVAL > 0 );
+
+    static constexpr SuperMemoState initialState() {
+        return { INITIAL_INTERVAL, INITIAL_REPETITIONS, INITIAL_EASINESS };
+    }
+    static constexpr float easinessDelta( int grade ) {
+        return DELTAS[std::min( std::max( grade, 0 ), GRADES - 1 )];
+    }
+
+    static constexpr SuperMemoState calculate( int grade, const SuperMemoState& current ) {
+        if ( grade < PASSING_GRADE ) return { LAPSE_INTERVAL, 0, current.easiness };
+
+        int next_interval = 0;
+        if ( current.repetitions >= 0 && current.repetitions < static_cast<int>( STEPS.size() ) ) {
+            next_interval = STEPS[current.repetitions];
+        } else {
+            next_interval = ceilToInt( current.interval * current.easiness );
+        }
+        float next_ef = current.easiness + easinessDelta( grade );
+        if ( next_ef < MIN_EASINESS ) next_ef = MIN_EASINESS;
+        return { next_interval, current.repetitions + 1, next_ef };
+    }
+
+private:
+    // std::ceil is not constexpr; truncation rounds towards zero, so add one for a fraction
+    static constexpr int ceilToInt( float value ) {
+        int truncated = static_cast<int>( value );
+        return truncated + ( truncated < value );
+    }
+};
+
+using Sm2 = SuperMemoPolicy<Sm2Config>;
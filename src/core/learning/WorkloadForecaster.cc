@@ -0,0 +1,121 @@
+/*
+ * @authors: Jakub Jurczak, Mateusz Woźniak
+ * summary: Simulates the daily number of upcoming reviews under SM-2 - source file.
+ */
+#include <algorithm>
+#include <numeric>
+
+#include "WorkloadForecaster.h"
+
+using namespace std;
+
+namespace {
+
+constexpr uint32_t NO_CARD = static_cast<uint32_t>( -1 );
+constexpr int GRADES = 6;
+
+// counter based generator, so a card's grade on a day does not depend on the processing order
+uint32_t mix( uint32_t seed, uint32_t card, uint32_t day ) {
+    uint64_t x = ( static_cast<uint64_t>( card ) << 32 | day ) ^
+                 ( static_cast<uint64_t>( seed ) * 0x9E3779B97F4A7C15ull );
+    x = ( x ^ ( x >> 30 ) ) * 0xBF58476D1CE4E5B9ull;
+    x = ( x ^ ( x >> 27 ) ) * 0x94D049BB133111EBull;
+    return static_cast<uint32_t>( ( x ^ ( x >> 31 ) ) >> 32 );
+}
+
+}  // namespace
+
+void ProgressColumns::add( const SuperMemoState& state, int due ) {
+    due_in_days.push_back( due );
+    intervals.push_back( state.interval );
+    repetitions.push_back( state.repetitions );
+    easiness.push_back( state.easiness );
+}
+
+void ProgressColumns::reserve( size_t cards ) {
+    due_in_days.reserve( cards );
+    intervals.reserve( cards );
+    repetitions.reserve( cards );
+    easiness.reserve( cards );
+}
+
+WorkloadForecast WorkloadForecaster::forecast( const ProgressColumns& progress,
+                                               const ForecastOptions& options ) {
+    int days = max( options.days, 0 );
+    WorkloadForecast result{ vector<int>( days, 0 ), vector<int>( days, 0 ) };
+    if ( days == 0 ) return result;
+
+    // a draw below thresholds[g] (but not below thresholds[g - 1]) is grade g
+    array<uint64_t, GRADES - 1> thresholds{};
+    double total = accumulate( options.grade_weights.begin(), options.grade_weights.end(), 0.0 );
+    double cumulative = 0.0;
+    for ( int g = 0; g < GRADES - 1; ++g ) {
+        cumulative += total > 0.0 ? options.grade_weights[g] / total : 0.0;
+        thresholds[g] = static_cast<uint64_t>( min( cumulative, 1.0 ) * 4294967296.0 );
+    }
+
+    // cards due on a day are chained through next_due, head[day] is the first of them
+    size_t cards = progress.size();
+    vector<uint32_t> head( days, NO_CARD );
+    vector<uint32_t> next_due( cards, NO_CARD );
+    for ( size_t c = cards; c-- > 0; ) {
+        int day = max( progress.due_in_days[c], 0 );
+        if ( day >= days ) continue;
+        next_due[c] = head[day];
+        head[day] = static_cast<uint32_t>( c );
+    }
+
+    vector<int32_t> intervals( progress.intervals );
+    vector<int32_t> repetitions( progress.repetitions );
+    vector<float> easiness( progress.easiness );
+
+    // the day's due cards, gathered so the kernel runs over contiguous memory
+    vector<uint32_t> batch;
+    vector<uint8_t> grades;
+    vector<int32_t> batch_intervals;
+    vector<int32_t> batch_repetitions;
+    vector<float> batch_easiness;
+
+    for ( int day = 0; day < days; ++day ) {
+        batch.clear();
+        for ( uint32_t c = head[day]; c != NO_CARD; c = next_due[c] ) batch.push_back( c );
+        size_t count = batch.size();
+        if ( count == 0 ) continue;
+
+        grades.resize( count );
+        batch_intervals.resize( count );
+        batch_repetitions.resize( count );
+        batch_easiness.resize( count );
+        int failed = 0;
+        for ( size_t i = 0; i < count; ++i ) {
+            uint32_t c = batch[i];
+            uint32_t draw = mix( options.seed, c, static_cast<uint32_t>( day ) );
+            uint8_t grade = 0;
+            for ( uint64_t threshold : thresholds ) grade += draw >= threshold;
+            grades[i] = grade;
+            failed += grade < SuperMemo::PASSING_GRADE;
+            batch_intervals[i] = intervals[c];
+            batch_repetitions[i] = repetitions[c];
+            batch_easiness[i] = easiness[c];
+        }
+
+        SuperMemo::calculateBatch( count, grades.data(), batch_intervals.data(),
+                                   batch_repetitions.data(), batch_easiness.data() );
+        result.reviews[day] = static_cast<int>( count );
+        result.failed[day] = failed;
+
+        for ( size_t i = 0; i < count; ++i ) {
+            uint32_t c = batch[i];
+            intervals[c] = batch_intervals[i];
+            repetitions[c] = batch_repetitions[i];
+            easiness[c] = batch_easiness[i];
+            // intervals are at least one day, so a card never lands on the day being processed
+            int64_t due = static_cast<int64_t>( day ) + batch_intervals[i];
+            if ( due < days ) {
+                next_due[c] = head[due];
+                head[due] = c;
+            }
+        }
+    }
+    return result;
+}
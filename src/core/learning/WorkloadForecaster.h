@@ -0,0 +1,44 @@
+/*
+ * @authors: Jakub Jurczak, Mateusz Woźniak
+ * summary: Simulates the daily number of upcoming reviews under SM-2 - header file.
+ */
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "SuperMemo.h"
+
+// SM-2 state of many cards, one column per field, as the forecast kernel reads it
+struct ProgressColumns {
+    std::vector<std::int32_t> due_in_days;  // 0 or less when due today, new cards included
+    std::vector<std::int32_t> intervals;
+    std::vector<std::int32_t> repetitions;
+    std::vector<float> easiness;
+
+    void add( const SuperMemoState& state, int due_in_days );
+    void reserve( std::size_t cards );
+    std::size_t size() const { return intervals.size(); }
+};
+
+struct ForecastOptions {
+    int days = 30;
+    // relative frequency of grades 0-5, every review draws its grade from it
+    std::array<double, 6> grade_weights = { 0.02, 0.03, 0.05, 0.15, 0.5, 0.25 };
+    std::uint32_t seed = 1;
+};
+
+// day 0 is today; reviews count each due card once, failed ones are included in reviews
+struct WorkloadForecast {
+    std::vector<int> reviews;
+    std::vector<int> failed;
+};
+
+class WorkloadForecaster {
+public:
+    // cards are only touched on the days they are due: each day's due cards are gathered into
+    // contiguous columns, graded by SuperMemo::calculateBatch and queued for their next day
+    static WorkloadForecast forecast( const ProgressColumns& progress,
+                                      const ForecastOptions& options = ForecastOptions() );
+};
@@ -0,0 +1,21 @@
+/*
+ * @authors: Jakub Jurczak, Mateusz Woźniak
+ * summary: Interface for review schedulers.
+ */
+#pragma once
+#include "../ScheduledCard.h"
+
+// a scheduler's answer for one review: the interval lands in state.interval either way, so the
+// progress row, the due dates and the mastered counters work the same for every scheduler
+struct ReviewOutcome {
+    SuperMemoState state;
+    FsrsState memory;
+};
+
+class IScheduler {
+public:
+    virtual ~IScheduler() = default;
+
+    // grade is 0-5 as given by the learning view
+    virtual ReviewOutcome review( const ScheduledCard& card, int grade ) const = 0;
+};
@@ -0,0 +1,43 @@
+/*
+ * @authors: Jakub Jurczak, Mateusz Woźniak
+ * summary: Concrete implementations of review schedulers.
+ */
+#pragma once
+#include "../Fsrs.h"
+#include "../SuperMemo.h"
+#include "IScheduler.h"
+
+class SuperMemoScheduler : public IScheduler {
+public:
+    ReviewOutcome review( const ScheduledCard& card, int grade ) const override {
+        return { SuperMemo::calculate( grade, card.state ), card.memory };
+    }
+};
+
+// cards without FSRS memory yet start from their SM-2 state, or as new cards
+class FsrsScheduler : public IScheduler {
+public:
+    explicit FsrsScheduler( const Fsrs::Weights& weights = Fsrs::DEFAULT_WEIGHTS,
+                            double retention = Fsrs::DESIRED_RETENTION )
+        : weights_( weights ), retention_( retention ) {}
+
+    ReviewOutcome review( const ScheduledCard& card, int grade ) const override {
+        int rating = Fsrs::ratingOfGrade( grade );
+        FsrsState memory = card.memory;
+        int elapsed_days = card.elapsed_days;
+        if ( memory.stability <= 0.0f ) {
+            memory = Fsrs::fromSuperMemo( card.state );
+            if ( memory.stability <= 0.0f ) elapsed_days = -1;
+        }
+        memory = Fsrs::review( weights_, memory, elapsed_days, rating );
+
+        SuperMemoState state = card.state;
+        state.interval = Fsrs::nextInterval( memory.stability, retention_ );
+        state.repetitions = rating == Fsrs::AGAIN ? 0 : state.repetitions + 1;
+        return { state, memory };
+    }
+
+private:
+    Fsrs::Weights weights_;
+    double retention_;
+};
@@ -3,14 +3,27 @@
  * summary: Interface for card selection strategies.
  */
 #pragma once
+#include <cstddef>
 #include <vector>
 
-#include "../Card.h"
+#include "../ScheduledCard.h"
 #include "../../../db/DatabaseManager.h"
 
+// a cursor over the cards of a set in the order the strategy picks them, read a page at a time
 class ICardSelectionStrategy {
 public:
     virtual ~ICardSelectionStrategy() = default;
 
-    virtual std::vector<Card> selectCards( DatabaseManager& db, int set_id, int limit ) = 0;
-};
\ No newline at end of file
+    // starts over at the first card of the set, the database must outlive the following fetches
+    virtual void open( DatabaseManager& db, int set_id ) = 0;
+    // cards come with their SM-2 state, so the session can grade them without reading progress;
+    // fewer than count only when the set has no more
+    virtual std::vector<ScheduledCard> fetch( int count ) = 0;
+    // cards the following fetches can still return
+    virtual std::size_t remaining() const = 0;
+
+    std::vector<ScheduledCard> selectCards( DatabaseManager& db, int set_id, int limit ) {
+        open( db, set_id );
+        return fetch( limit );
+    }
+};
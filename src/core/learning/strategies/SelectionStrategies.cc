@@ -0,0 +1,68 @@
+/*
+ * @authors: Jakub Jurczak, Mateusz Woźniak
+ * summary: Concrete implementations of selection strategies - source file.
+ */
+#include <algorithm>
+
+#include "SelectionStrategies.h"
+
+using namespace std;
+
+RandomSelectionStrategy::RandomSelectionStrategy( uint32_t seed ) : rng_( seed ) {}
+
+// only the ids are loaded up front, a few bytes per card even for the largest sets
+void RandomSelectionStrategy::open( DatabaseManager& db, int set_id ) {
+    db_ = &db;
+    ids_ = db.getCardIds( set_id );
+    shuffle( ids_.begin(), ids_.end(), rng_ );
+    next_ = 0;
+}
+
+// cards deleted since open are skipped, so the page is topped up from the following ids
+vector<ScheduledCard> RandomSelectionStrategy::fetch( int count ) {
+    vector<ScheduledCard> cards;
+    if ( !db_ ) return cards;
+    while ( static_cast<int>( cards.size() ) < count && next_ < ids_.size() ) {
+        size_t take = min<size_t>( count - cards.size(), ids_.size() - next_ );
+        vector<int> page( ids_.begin() + next_, ids_.begin() + next_ + take );
+        next_ += take;
+        for ( ScheduledCard& card : db_->getScheduledCards( page ) ) {
+            cards.push_back( std::move( card ) );
+        }
+    }
+    return cards;
+}
+
+void SpacedRepetitionStrategy::open( DatabaseManager& db, int set_id ) {
+    db_ = &db;
+    set_id_ = set_id;
+    after_ = DueCursor();
+    remaining_ = static_cast<size_t>( max( db.getDueCount( set_id ), 0 ) );
+}
+
+// the cursor is keyed by due date and id, so cards graded since the last page do not shift it
+vector<ScheduledCard> SpacedRepetitionStrategy::fetch( int count ) {
+    vector<ScheduledCard> cards;
+    if ( !db_ || count <= 0 ) return cards;
+    cards = db_->getDueScheduledPage( set_id_, after_, count );
+    remaining_ = static_cast<int>( cards.size() ) < count
+                     ? 0
+                     : remaining_ - min( remaining_, cards.size() );
+    return cards;
+}
+
+MergedDueStrategy::MergedDueStrategy( vector<int> set_ids, int per_set_cap )
+    : set_ids_( std::move( set_ids ) ), per_set_cap_( per_set_cap ) {}
+
+void MergedDueStrategy::open( DatabaseManager& db, int /*set_id*/ ) {
+    merger_.emplace( db, set_ids_, per_set_cap_ );
+}
+
+vector<ScheduledCard> MergedDueStrategy::fetch( int count ) {
+    if ( !merger_ ) return {};
+    return merger_->take( count );
+}
+
+size_t MergedDueStrategy::remaining() const {
+    return merger_ ? merger_->pendingCount() : 0;
+}
@@ -3,18 +3,56 @@
  * summary: Concrete implementations of selection strategies.
  */
 #pragma once
+#include <cstdint>
+#include <optional>
+#include <random>
+
+#include "../DueQueueMerger.h"
 #include "ICardSelectionStrategy.h"
 
+// the set's ids are shuffled on open, cards are read by id as they are fetched
 class RandomSelectionStrategy : public ICardSelectionStrategy {
 public:
-    std::vector<Card> selectCards( DatabaseManager& db, int set_id, int limit ) override {
-        return db.getRandomCards( set_id, limit );
-    }
+    explicit RandomSelectionStrategy( std::uint32_t seed = std::random_device{}() );
+
+    void open( DatabaseManager& db, int set_id ) override;
+    std::vector<ScheduledCard> fetch( int count ) override;
+    std::size_t remaining() const override { return ids_.size() - next_; }
+
+private:
+    DatabaseManager* db_ = nullptr;
+    std::mt19937 rng_;
+    std::vector<int> ids_;
+    std::size_t next_ = 0;
 };
 
+// due cards, the most overdue first; every fetch resumes after the last card read
 class SpacedRepetitionStrategy : public ICardSelectionStrategy {
 public:
-    std::vector<Card> selectCards( DatabaseManager& db, int set_id, int limit ) override {
-        return db.getDueCards( set_id, limit );
-    }
-};
\ No newline at end of file
+    void open( DatabaseManager& db, int set_id ) override;
+    std::vector<ScheduledCard> fetch( int count ) override;
+    std::size_t remaining() const override { return remaining_; }
+
+private:
+    DatabaseManager* db_ = nullptr;
+    int set_id_ = -1;
+    DueCursor after_;
+    std::size_t remaining_ = 0;
+};
+
+// due cards of several sets, the most overdue of any set first; the sets are given up front, so
+// open starts the merge over and ignores its set id
+class MergedDueStrategy : public ICardSelectionStrategy {
+public:
+    MergedDueStrategy( std::vector<int> set_ids, int per_set_cap );
+
+    void open( DatabaseManager& db, int set_id ) override;
+    std::vector<ScheduledCard> fetch( int count ) override;
+    // nothing is counted up front, only the cards already read are known
+    std::size_t remaining() const override;
+
+private:
+    std::vector<int> set_ids_;
+    int per_set_cap_;
+    std::optional<DueQueueMerger> merger_;
+};
@@ -0,0 +1,116 @@
+/*
+ * @authors: Jakub Jurczak, Mateusz Woźniak
+ * summary: MediaProbe utility class, reads metadata of card media files - source file.
+ */
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QImageReader>
+#include <QtEndian>
+
+#include "MediaProbe.h"
+
+using namespace std;
+
+optional<MediaInfo> MediaProbe::probe( const QString& media_root, const string& rel_path ) {
+    QString rel = QString::fromStdString( rel_path );
+    QString abs_path = QDir( media_root ).filePath( rel );
+
+    QFile file( abs_path );
+    if ( !file.open( QIODevice::ReadOnly ) ) {
+        qWarning() << "MediaProbe: cannot open" << abs_path;
+        return nullopt;
+    }
+
+    MediaInfo info;
+    info.path = rel_path;
+    info.byte_size = file.size();
+
+    QCryptographicHash hash( QCryptographicHash::Sha1 );
+    hash.addData( &file );
+    info.hash = hash.result().toHex().toStdString();
+    file.close();
+
+    if ( rel.startsWith( "images/" ) ) {
+        if ( !probeImage( media_root, abs_path, info ) ) return nullopt;
+    } else if ( rel.endsWith( ".wav", Qt::CaseInsensitive ) ) {
+        info.duration_ms = wavDurationMs( abs_path );
+    }
+    return info;
+}
+
+// thumbnails are named after a hash of the whole relative path, so removing a card can remove
+// its thumbnail too; files of the same name in other directories or formats keep their own
+QString MediaProbe::thumbnailPath( const string& rel_path ) {
+    QByteArray key = QCryptographicHash::hash( QByteArray::fromStdString( rel_path ),
+                                               QCryptographicHash::Sha1 );
+    return "thumbnails/" + QString::fromLatin1( key.toHex() ) + ".png";
+}
+
+QImage MediaProbe::readFitted( const QString& abs_path, const MediaInfo& info,
+                              const QSize& box ) {
+    QImageReader reader( abs_path );
+    if ( info.width > 0 && info.height > 0 ) {
+        reader.setScaledSize( QSize( info.width, info.height ).scaled( box, Qt::KeepAspectRatio ) );
+    }
+    return reader.read();
+}
+
+// dimensions come from the image header, the thumbnail is decoded straight at the reduced size
+bool MediaProbe::probeImage( const QString& media_root, const QString& abs_path,
+                             MediaInfo& info ) {
+    QImageReader reader( abs_path );
+    QSize size = reader.size();
+    if ( !size.isValid() ) {
+        qWarning() << "MediaProbe: not a readable image" << abs_path << reader.errorString();
+        return false;
+    }
+    info.width = size.width();
+    info.height = size.height();
+
+    reader.setScaledSize( size.scaled( THUMBNAIL_SIZE, THUMBNAIL_SIZE, Qt::KeepAspectRatio ) );
+    QImage thumbnail = reader.read();
+    QString thumbnail_rel = thumbnailPath( info.path );
+    QDir( media_root ).mkpath( "thumbnails" );
+    if ( !thumbnail.isNull() && thumbnail.save( QDir( media_root ).filePath( thumbnail_rel ) ) ) {
+        info.thumbnail = thumbnail_rel.toStdString();
+    } else {
+        qWarning() << "MediaProbe: could not write thumbnail for" << abs_path;
+    }
+    return true;
+}
+
+// walks the RIFF chunks: byte rate comes from "fmt ", the sample data length from "data"
+int MediaProbe::wavDurationMs( const QString& abs_path ) {
+    QFile file( abs_path );
+    if ( !file.open( QIODevice::ReadOnly ) ) return 0;
+
+    QByteArray header = file.read( 12 );
+    if ( header.size() < 12 || !header.startsWith( "RIFF" ) || header.mid( 8, 4 ) != "WAVE" ) {
+        return 0;
+    }
+
+    quint32 byte_rate = 0;
+    while ( !file.atEnd() ) {
+        QByteArray chunk = file.read( 8 );
+        if ( chunk.size() < 8 ) break;
+        quint32 chunk_size = qFromLittleEndian<quint32>( chunk.constData() + 4 );
+
+        if ( chunk.startsWith( "fmt " ) ) {
+            QByteArray fmt = file.read( chunk_size );
+            if ( fmt.size() < 12 ) return 0;
+            byte_rate = qFromLittleEndian<quint32>( fmt.constData() + 8 );
+        } else if ( chunk.startsWith( "data" ) ) {
+            if ( byte_rate == 0 ) return 0;
+            return static_cast<int>( qint64( chunk_size ) * 1000 / byte_rate );
+        } else {
+            file.skip( chunk_size );
+        }
+        // chunks are padded to an even size
+        if ( chunk_size % 2 ) file.skip( 1 );
+    }
+    return 0;
+}
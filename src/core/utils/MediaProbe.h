@@ -0,0 +1,37 @@
+/*
+ * @authors: Jakub Jurczak, Mateusz Woźniak
+ * summary: MediaProbe utility class, reads metadata of card media files - header file.
+ */
+#pragma once
+#include <QImage>
+#include <QSize>
+#include <QString>
+#include <QtGlobal>
+#include <optional>
+#include <string>
+
+// metadata stored in the media catalog, so views can lay out and validate media without the file
+struct MediaInfo {
+    std::string path;  // relative to the media directory, e.g. "images/cat.png"
+    std::string hash;  // SHA-1 of the file content, hex encoded
+    qint64 byte_size = 0;
+    int width = 0;        // images only
+    int height = 0;       // images only
+    int duration_ms = 0;  // sounds only, 0 when the format is not recognised
+    std::string thumbnail;  // relative to the media directory, empty for sounds
+};
+
+class MediaProbe {
+public:
+    static constexpr int THUMBNAIL_SIZE = 160;
+
+    // reads the file at media_root/rel_path, writes a thumbnail for images
+    static std::optional<MediaInfo> probe( const QString& media_root, const std::string& rel_path );
+    static QString thumbnailPath( const std::string& rel_path );
+    // decodes an image straight at the size that fits into box, using the cataloged dimensions
+    static QImage readFitted( const QString& abs_path, const MediaInfo& info, const QSize& box );
+
+private:
+    static bool probeImage( const QString& media_root, const QString& abs_path, MediaInfo& info );
+    static int wavDurationMs( const QString& abs_path );
+};
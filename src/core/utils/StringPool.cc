@@ -0,0 +1,77 @@
+/*
+ * @authors: Jakub Jurczak, Mateusz Woźniak
+ * summary: StringPool, interned storage for repeated card strings - source file.
+ */
+#include <cstring>
+
+#include "StringPool.h"
+
+using namespace std;
+
+StringPool::StringPool() { clear(); }
+
+StringPool::StringPool( StringPool&& other ) noexcept
+    : chunks_( move( other.chunks_ ) ),
+      cursor_( other.cursor_ ),
+      remaining_( other.remaining_ ),
+      stored_bytes_( other.stored_bytes_ ),
+      views_( move( other.views_ ) ),
+      index_( move( other.index_ ) ) {
+    other.clear();
+}
+
+StringPool& StringPool::operator=( StringPool&& other ) noexcept {
+    if ( this == &other ) return *this;
+    chunks_ = move( other.chunks_ );
+    cursor_ = other.cursor_;
+    remaining_ = other.remaining_;
+    stored_bytes_ = other.stored_bytes_;
+    views_ = move( other.views_ );
+    index_ = move( other.index_ );
+    other.clear();
+    return *this;
+}
+
+StringPool::Handle StringPool::intern( string_view text ) {
+    if ( text.empty() ) return EMPTY;
+
+    auto it = index_.find( text );
+    if ( it != index_.end() ) return it->second;
+
+    string_view stored = store( text );
+    Handle handle = static_cast<Handle>( views_.size() );
+    views_.push_back( stored );
+    index_.emplace( stored, handle );
+    return handle;
+}
+
+void StringPool::clear() {
+    chunks_.clear();
+    cursor_ = nullptr;
+    remaining_ = 0;
+    stored_bytes_ = 0;
+    views_.assign( 1, string_view() );
+    index_.clear();
+}
+
+// strings larger than a quarter chunk get a chunk of their own, so they do not waste the rest of
+// the current one
+string_view StringPool::store( string_view text ) {
+    char* target;
+    if ( text.size() > CHUNK_SIZE / 4 ) {
+        chunks_.push_back( make_unique<char[]>( text.size() ) );
+        target = chunks_.back().get();
+    } else {
+        if ( text.size() > remaining_ ) {
+            chunks_.push_back( make_unique<char[]>( CHUNK_SIZE ) );
+            cursor_ = chunks_.back().get();
+            remaining_ = CHUNK_SIZE;
+        }
+        target = cursor_;
+        cursor_ += text.size();
+        remaining_ -= text.size();
+    }
+    memcpy( target, text.data(), text.size() );
+    stored_bytes_ += text.size();
+    return string_view( target, text.size() );
+}
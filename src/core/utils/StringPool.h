@@ -0,0 +1,46 @@
+/*
+ * @authors: Jakub Jurczak, Mateusz Woźniak
+ * summary: StringPool, interned storage for repeated card strings - header file.
+ */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// every distinct string is stored once, in large chunks that never move, so the views handed out
+// stay valid for the lifetime of the pool (also when it is moved)
+class StringPool {
+public:
+    using Handle = std::uint32_t;
+    static constexpr Handle EMPTY = 0;  // handle of "", present in every pool
+    static constexpr std::size_t CHUNK_SIZE = 64 * 1024;
+
+    StringPool();
+    // the source is left as an empty pool, still holding EMPTY
+    StringPool( StringPool&& other ) noexcept;
+    StringPool& operator=( StringPool&& other ) noexcept;
+    StringPool( const StringPool& ) = delete;
+    StringPool& operator=( const StringPool& ) = delete;
+
+    Handle intern( std::string_view text );
+    std::string_view view( Handle handle ) const { return views_[handle]; }
+
+    std::size_t size() const { return views_.size(); }
+    // characters held, without the bookkeeping of the index
+    std::size_t storedBytes() const { return stored_bytes_; }
+    void clear();
+
+private:
+    std::vector<std::unique_ptr<char[]>> chunks_;
+    char* cursor_ = nullptr;
+    std::size_t remaining_ = 0;
+    std::size_t stored_bytes_ = 0;
+
+    std::vector<std::string_view> views_;
+    std::unordered_map<std::string_view, Handle> index_;
+
+    std::string_view store( std::string_view text );
+};
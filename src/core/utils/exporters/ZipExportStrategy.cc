@@ -12,11 +12,14 @@
 #include <QProcess>
 
 #include "ZipExportStrategy.h"
-#include "../../learning/Card.h"
-#include "../../utils/Overloaded.h"
+#include "../../learning/CardStore.h"
 
 using namespace std;
 
+static QString toQString( string_view text ) {
+    return QString::fromUtf8( text.data(), static_cast<qsizetype>( text.size() ) );
+}
+
 static QString copyMediaToExport( const string& relative_path, const QString& export_root ) {
     QString rel = QString::fromStdString( relative_path );
 
@@ -53,7 +56,8 @@ static QString copyMediaToExport( const string& relative_path, const QString& ex
 
 bool ZipExportStrategy::exportSet( int set_id, const DatabaseManager& db,
                                    const QString& dest_path ) {
-    auto cards = db.getCardsForSet( set_id );
+    // rows are read in place, the export never builds a Card
+    CardStore cards = db.getCardStore( set_id );
 
     QString set_name = "Exported Set";
     auto set_opt = db.getSet( set_id );
@@ -74,37 +78,44 @@ bool ZipExportStrategy::exportSet( int set_id, const DatabaseManager& db,
 
     QJsonArray cards_arr;
 
-    for ( const auto& card : cards ) {
-        const auto& data = card.getData();
+    for ( size_t row = 0; row < cards.size(); ++row ) {
+        CardView card = cards.view( row );
         QJsonObject c_obj;
 
         // Basic fields
-        c_obj["correct_answer"] = QString::fromStdString( data.correct_answer );
+        c_obj["correct_answer"] = toQString( card.getCorrectAnswer() );
 
         QJsonArray wrongs;
-        for ( const auto& w : data.wrong_answers ) {
-            wrongs.append( QString::fromStdString( w ) );
+        for ( size_t i = 0; i < card.getWrongAnswerCount(); ++i ) {
+            wrongs.append( toQString( card.getWrongAnswer( i ) ) );
         }
         if ( !wrongs.empty() ) {
             c_obj["wrong_answers"] = wrongs;
         }
 
+        QJsonArray accepted;
+        for ( size_t i = 0; i < card.getAcceptedAnswerCount(); ++i ) {
+            accepted.append( toQString( card.getAcceptedAnswer( i ) ) );
+        }
+        if ( !accepted.empty() ) {
+            c_obj["accepted_answers"] = accepted;
+        }
+
         // Question Payload & Media
-        visit( overloaded{ [&]( const TextContent& c ) {
-                              c_obj["question"] = QString::fromStdString( c.text );
-                              c_obj["media_type"] = "text";
-                          },
-                           [&]( const ImageContent& c ) {
-                               QString rel = copyMediaToExport( c.image_path, temp_path );
-                               c_obj["question"] = rel;
-                               c_obj["media_type"] = "image";
-                           },
-                           [&]( const SoundContent& c ) {
-                               QString rel = copyMediaToExport( c.sound_path, temp_path );
-                               c_obj["question"] = rel;
-                               c_obj["media_type"] = "sound";
-                           } },
-               data.question );
+        switch ( card.getMediaType() ) {
+            case MediaType::TEXT:
+                c_obj["question"] = toQString( card.getQuestion() );
+                c_obj["media_type"] = "text";
+                break;
+            case MediaType::IMAGE:
+                c_obj["question"] = copyMediaToExport( string( card.getQuestion() ), temp_path );
+                c_obj["media_type"] = "image";
+                break;
+            case MediaType::SOUND:
+                c_obj["question"] = copyMediaToExport( string( card.getQuestion() ), temp_path );
+                c_obj["media_type"] = "sound";
+                break;
+        }
 
         cards_arr.append( c_obj );
     }
@@ -78,6 +78,18 @@ bool JsonImportStrategy::import( const QString& file_path, DatabaseManager& db,
                 wrongs.push_back( w.toString().toStdString() );
             }
         }
+        if ( wrongs.size() >= ChoiceOrder::MAX_CHOICES ) {
+            set_name_out = QString( "Pytanie może mieć najwyżej %1 błędnych odpowiedzi." )
+                               .arg( ChoiceOrder::MAX_CHOICES - 1 );
+            return false;
+        }
+
+        vector<string> accepted;
+        if ( obj.contains( "accepted_answers" ) && obj["accepted_answers"].isArray() ) {
+            for ( const auto& a : obj["accepted_answers"].toArray() ) {
+                accepted.push_back( a.toString().toStdString() );
+            }
+        }
 
         if ( !media_root_.isEmpty() && ( obj["media_type"].toString() == "image" ||
                                          obj["media_type"].toString() == "sound" ) ) {
@@ -135,6 +147,7 @@ bool JsonImportStrategy::import( const QString& file_path, DatabaseManager& db,
 
         draft.correct_answer = c_str;
         draft.wrong_answers = wrongs;
+        draft.accepted_answers = accepted;
 
         if ( !wrongs.empty() ) {
             draft.answer_type = AnswerType::TEXT_CHOICE;
@@ -0,0 +1,168 @@
+/*
+ * @authors: Jakub Jurczak, Mateusz Woźniak
+ * summary: Class DatabaseMaintenance, idle-time SQLite housekeeping - source file.
+ */
+#include <QDebug>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QVariant>
+
+#include "DatabaseMaintenance.h"
+#include "DatabaseManager.h"
+
+DatabaseMaintenance::DatabaseMaintenance( DatabaseManager& db ) : db_( db ) { restart(); }
+
+void DatabaseMaintenance::restart() {
+    step_ = Step::OPTIMIZE;
+    tables_to_check_ = { "sets", "cards", "learning_progress", "media" };
+    integrity_ok_ = true;
+    size_before_ = -1;
+    time_spent_ms_ = 0;
+}
+
+// every step is split so that a single call returns to the event loop within the given budget
+bool DatabaseMaintenance::runSlice( int budget_ms ) {
+    if ( step_ == Step::DONE ) return false;
+
+    QElapsedTimer timer;
+    timer.start();
+    if ( size_before_ < 0 ) size_before_ = databaseSizeBytes();
+
+    while ( step_ != Step::DONE && timer.elapsed() < budget_ms ) {
+        bool step_done = true;
+        switch ( step_ ) {
+            case Step::OPTIMIZE:
+                step_done = runOptimize();
+                if ( step_done ) step_ = Step::ANALYZE;
+                break;
+            case Step::ANALYZE:
+                step_done = runAnalyze();
+                if ( step_done ) step_ = Step::AUTO_VACUUM_MODE;
+                break;
+            case Step::AUTO_VACUUM_MODE:
+                step_done = runAutoVacuumMode();
+                if ( step_done ) step_ = Step::INCREMENTAL_VACUUM;
+                break;
+            case Step::INCREMENTAL_VACUUM:
+                step_done = runIncrementalVacuum( timer, budget_ms );
+                if ( step_done ) step_ = Step::INTEGRITY_CHECK;
+                break;
+            case Step::INTEGRITY_CHECK:
+                step_done = runIntegrityCheck();
+                if ( step_done ) step_ = Step::DUE_COUNTS;
+                break;
+            case Step::DUE_COUNTS:
+                // keeps the set list's due order right when the app stays open past midnight
+                db_.refreshDueCounts();
+                step_ = Step::DONE;
+                break;
+            case Step::DONE:
+                break;
+        }
+    }
+
+    time_spent_ms_ += timer.elapsed();
+    if ( step_ == Step::DONE ) {
+        finish();
+        return false;
+    }
+    return true;
+}
+
+bool DatabaseMaintenance::runOptimize() {
+    QSqlQuery query;
+    if ( !query.exec( "PRAGMA optimize" ) ) {
+        qWarning() << "Maintenance: PRAGMA optimize failed:" << query.lastError().text();
+    }
+    return true;
+}
+
+// analysis_limit makes ANALYZE sample each index instead of reading it whole
+bool DatabaseMaintenance::runAnalyze() {
+    QSqlQuery query;
+    query.exec( QString( "PRAGMA analysis_limit = %1" ).arg( ANALYSIS_LIMIT ) );
+    if ( !query.exec( "ANALYZE" ) ) {
+        qWarning() << "Maintenance: ANALYZE failed:" << query.lastError().text();
+    }
+    return true;
+}
+
+// a file created before schema 1 only switches to incremental auto-vacuum with a full VACUUM,
+// which cannot be split, so it runs once here while the app is idle instead of at startup
+bool DatabaseMaintenance::runAutoVacuumMode() {
+    QSqlQuery query;
+    if ( query.exec( "PRAGMA auto_vacuum" ) && query.next() && query.value( 0 ).toInt() == 2 ) {
+        return true;
+    }
+    query.exec( "PRAGMA auto_vacuum = INCREMENTAL" );
+    if ( !query.exec( "VACUUM" ) ) {
+        qWarning() << "Maintenance: switching to incremental auto-vacuum failed:"
+                   << query.lastError().text();
+    }
+    return true;
+}
+
+// gives free pages back in small batches until the freelist is empty or the budget runs out
+bool DatabaseMaintenance::runIncrementalVacuum( const QElapsedTimer& timer, int budget_ms ) {
+    QSqlQuery query;
+    while ( timer.elapsed() < budget_ms ) {
+        if ( freePages() <= 0 ) return true;
+
+        QString sql = QString( "PRAGMA incremental_vacuum(%1)" ).arg( VACUUM_PAGES_PER_CALL );
+        if ( !query.exec( sql ) ) {
+            qWarning() << "Maintenance: incremental vacuum failed:" << query.lastError().text();
+            return true;
+        }
+    }
+    return false;
+}
+
+// checks one table per call, so a large table does not block the others' budget
+bool DatabaseMaintenance::runIntegrityCheck() {
+    if ( tables_to_check_.isEmpty() ) return true;
+
+    QString table = tables_to_check_.takeFirst();
+    QSqlQuery query;
+    if ( !query.exec( QString( "PRAGMA integrity_check(%1)" ).arg( table ) ) ) {
+        qWarning() << "Maintenance: integrity check failed to run on" << table
+                   << query.lastError().text();
+        return tables_to_check_.isEmpty();
+    }
+    while ( query.next() ) {
+        QString result = query.value( 0 ).toString();
+        if ( result != "ok" ) {
+            integrity_ok_ = false;
+            qCritical() << "Maintenance: integrity problem in" << table << ":" << result;
+        }
+    }
+    return tables_to_check_.isEmpty();
+}
+
+void DatabaseMaintenance::finish() {
+    qint64 size_after = databaseSizeBytes();
+    qDebug() << "Maintenance finished in" << time_spent_ms_ << "ms."
+             << "Database size:" << size_before_ << "->" << size_after << "bytes,"
+             << "reclaimed" << ( size_before_ - size_after ) << "bytes."
+             << "Integrity:" << ( integrity_ok_ ? "ok" : "FAILED" );
+}
+
+qint64 DatabaseMaintenance::databaseSizeBytes() {
+    QSqlQuery query;
+    qint64 page_count = 0;
+    qint64 page_size = 0;
+    if ( query.exec( "PRAGMA page_count" ) && query.next() ) {
+        page_count = query.value( 0 ).toLongLong();
+    }
+    if ( query.exec( "PRAGMA page_size" ) && query.next() ) {
+        page_size = query.value( 0 ).toLongLong();
+    }
+    return page_count * page_size;
+}
+
+qint64 DatabaseMaintenance::freePages() {
+    QSqlQuery query;
+    if ( query.exec( "PRAGMA freelist_count" ) && query.next() ) {
+        return query.value( 0 ).toLongLong();
+    }
+    return 0;
+}
@@ -0,0 +1,54 @@
+/*
+ * @authors: Jakub Jurczak, Mateusz Woźniak
+ * summary: Class DatabaseMaintenance, idle-time SQLite housekeeping - header file.
+ */
+#pragma once
+#include <QElapsedTimer>
+#include <QStringList>
+
+class DatabaseManager;
+
+class DatabaseMaintenance {
+public:
+    enum class Step {
+        OPTIMIZE,
+        ANALYZE,
+        AUTO_VACUUM_MODE,
+        INCREMENTAL_VACUUM,
+        INTEGRITY_CHECK,
+        DUE_COUNTS,
+        DONE
+    };
+
+    static constexpr int VACUUM_PAGES_PER_CALL = 64;
+    static constexpr int ANALYSIS_LIMIT = 400;
+
+    // the manager's connection keeps the due counters, it must outlive the maintenance
+    explicit DatabaseMaintenance( DatabaseManager& db );
+
+    // runs maintenance work for at most (roughly) budget_ms, returns true if work remains
+    bool runSlice( int budget_ms );
+    void restart();
+
+    bool isFinished() const { return step_ == Step::DONE; }
+    Step currentStep() const { return step_; }
+    bool integrityOk() const { return integrity_ok_; }
+
+    static qint64 databaseSizeBytes();
+    static qint64 freePages();
+
+private:
+    bool runOptimize();
+    bool runAnalyze();
+    bool runAutoVacuumMode();
+    bool runIncrementalVacuum( const QElapsedTimer& timer, int budget_ms );
+    bool runIntegrityCheck();
+    void finish();
+
+    DatabaseManager& db_;
+    Step step_ = Step::OPTIMIZE;
+    QStringList tables_to_check_;
+    bool integrity_ok_ = true;
+    qint64 size_before_ = -1;
+    qint64 time_spent_ms_ = 0;
+};
@@ -12,11 +12,14 @@
 #include <QDate>
 #include <QJsonDocument>
 #include <QJsonArray>
+#include <limits>
 #include <variant>
 #include <QFile>
+#include <QThread>
 #include <QDebug>
 
 #include "DatabaseManager.h"
+#include "Queries.h"
 
 using namespace std;
 
@@ -29,6 +32,121 @@ static QString getAbsMediaPath( const QString& relPath ) {
 #endif
 }
 
+// long text goes in as a compressed blob, plain TEXT and blobs are told apart by their type
+static QVariant encodeText( const string& text, bool compress ) {
+    QByteArray utf8 = QByteArray::fromStdString( text );
+    if ( compress && utf8.size() >= DatabaseManager::COMPRESSION_THRESHOLD ) {
+        QByteArray packed = qCompress( utf8 );
+        if ( packed.size() < utf8.size() ) return packed;
+    }
+    return QString::fromStdString( text );
+}
+
+static QString decodeText( const QVariant& value ) {
+    if ( value.typeId() == QMetaType::QByteArray ) {
+        return QString::fromUtf8( qUncompress( value.toByteArray() ) );
+    }
+    return value.toString();
+}
+
+static QByteArray toJsonArray( const vector<string>& values ) {
+    QJsonArray array;
+    for ( const auto& value : values ) {
+        array.append( QString::fromStdString( value ) );
+    }
+    return QJsonDocument( array ).toJson( QJsonDocument::Compact );
+}
+
+static vector<string> fromJsonArray( const QJsonArray& array ) {
+    vector<string> values;
+    for ( const auto& value : array ) {
+        values.push_back( value.toString().toStdString() );
+    }
+    return values;
+}
+
+// reads the card columns of a row returned by one of the card selection queries
+static CardData readCardData( const QSqlQuery& query ) {
+    CardData data;
+    data.id = query.value( "id" ).toInt();
+    data.set_id = query.value( "set_id" ).toInt();
+    data.correct_answer = decodeText( query.value( "correct_answer" ) ).toStdString();
+    data.answer_type = (AnswerType)query.value( "answer_type" ).toInt();
+
+    int m_val = query.value( "media_type" ).toInt();
+    string q_str = decodeText( query.value( "question" ) ).toStdString();
+
+    if ( m_val == 1 ) {
+        data.question = ImageContent{ q_str };
+    } else if ( m_val == 2 ) {
+        data.question = SoundContent{ q_str };
+    } else {
+        data.question = TextContent{ q_str };
+    }
+
+    QString w_raw = query.value( "wrong_answers" ).toString();
+
+    QJsonDocument doc = QJsonDocument::fromJson( w_raw.toUtf8() );
+    if ( !doc.isNull() && doc.isArray() ) {
+        data.wrong_answers = fromJsonArray( doc.array() );
+    } else if ( !w_raw.isEmpty() ) {
+        for ( const auto& part : w_raw.split( ';', Qt::SkipEmptyParts ) ) {
+            data.wrong_answers.push_back( part.toStdString() );
+        }
+    }
+
+    QJsonDocument accepted =
+        QJsonDocument::fromJson( query.value( "accepted_answers" ).toByteArray() );
+    if ( accepted.isArray() ) data.accepted_answers = fromJsonArray( accepted.array() );
+    return data;
+}
+
+// a card row of the scheduled queries, new cards keep the initial state and empty memory
+static ScheduledCard readScheduledCard( const QSqlQuery& query ) {
+    ScheduledCard scheduled{ Card( readCardData( query ) ), SuperMemo::getInitialState() };
+    if ( !query.value( "interval" ).isNull() ) {
+        scheduled.state = { query.value( "interval" ).toInt(), query.value( "repetitions" ).toInt(),
+                            query.value( "easiness_factor" ).toFloat() };
+        scheduled.memory = { query.value( "stability" ).toFloat(),
+                             query.value( "difficulty" ).toFloat() };
+        scheduled.elapsed_days = query.value( "elapsed_days" ).toInt();
+    }
+    return scheduled;
+}
+
+// reads a row of SET_BY_ID or one of the SETS_PAGE queries
+static StudySet readSet( const QSqlQuery& query ) {
+    StudySet s;
+    s.id = query.value( "id" ).toInt();
+    s.name = query.value( "name" ).toString().toStdString();
+    s.last_activity = query.value( "last_activity" ).toString().toStdString();
+    s.due_count = query.value( "due_count" ).toInt();
+    s.card_count = query.value( "card_count" ).toInt();
+    return s;
+}
+
+static Deck readDeck( const QSqlQuery& query ) {
+    Deck d;
+    d.id = query.value( "id" ).toInt();
+    d.name = query.value( "name" ).toString().toStdString();
+    d.parent_id = query.value( "parent_id" ).isNull() ? -1 : query.value( "parent_id" ).toInt();
+    d.card_count = query.value( "card_count" ).toInt();
+    d.due_count = query.value( "due_count" ).toInt();
+    d.mastered_count = query.value( "mastered_count" ).toInt();
+    return d;
+}
+
+// top level decks and ungrouped sets store NULL
+static QVariant deckKey( int deck_id ) {
+    return deck_id < 0 ? QVariant( QMetaType::fromType<int>() ) : QVariant( deck_id );
+}
+
+// thumbnails are generated by MediaProbe for images only and go away together with their file
+static void removeThumbnail( const QString& relPath ) {
+    if ( !relPath.startsWith( "images/" ) ) return;
+    QFile::remove( getAbsMediaPath( MediaProbe::thumbnailPath( relPath.toStdString() ) ) );
+}
+
 DatabaseManager::DatabaseManager( const QString& db_name ) : db_name_( db_name ) {}
 
 DatabaseManager::~DatabaseManager() {
@@ -66,11 +184,23 @@ bool DatabaseManager::connect() {
 
     qDebug() << "Database path:" << dbPath;
     database_.setDatabaseName( dbPath );
+    // other processes may hold the write lock for a moment, SQLite waits for it up to this long
+    database_.setConnectOptions( QString( "QSQLITE_BUSY_TIMEOUT=%1" ).arg( BUSY_TIMEOUT_MS ) );
 
     if ( !database_.open() ) {
         qCritical() << "Error: connection with database failed:" << database_.lastError().text();
         return false;
     }
+
+    // only takes effect on a new file, before its first table (and before WAL writes the header)
+    QSqlQuery pragma( database_ );
+    pragma.exec( "PRAGMA auto_vacuum = INCREMENTAL" );
+    // with a write-ahead log readers keep working while long writes are in progress
+    if ( !pragma.exec( "PRAGMA journal_mode = WAL" ) ) {
+        qWarning() << "Could not enable WAL journal:" << pragma.lastError().text();
+    }
+    // the first poll only records the version later polls compare against
+    pollExternalChanges();
     return true;
 }
 
@@ -106,7 +236,298 @@ bool DatabaseManager::createTables() {
         "FOREIGN KEY(card_id) REFERENCES cards(id) ON DELETE CASCADE"
         ")" );
 
-    return sets_ok && cards_ok && progress_ok;
+    bool schema_ok = sets_ok && cards_ok && progress_ok && migrateSchema();
+    if ( schema_ok ) refreshDueCounts();
+    return schema_ok;
+}
+
+// the statements of a migration step, stopping at the first failure
+static bool execAll( QSqlQuery& query, const QStringList& statements ) {
+    for ( const QString& statement : statements ) {
+        if ( !query.exec( statement ) ) return false;
+    }
+    return true;
+}
+
+// upgrades an existing database step by step, PRAGMA user_version holds the applied version;
+// each step commits together with its version, so one that fails is retried whole next time
+bool DatabaseManager::migrateSchema() {
+    QSqlQuery query;
+    int version = 0;
+    if ( query.exec( "PRAGMA user_version" ) && query.next() ) {
+        version = query.value( 0 ).toInt();
+    }
+    if ( version >= SCHEMA_VERSION ) return true;
+
+    if ( version < 1 ) {
+        // incremental auto-vacuum lets DatabaseMaintenance return free pages in small steps;
+        // connect() asks for it before a new file gets its first table, an older file needs a
+        // full VACUUM, which cannot run in a transaction, so maintenance does it while idle
+        if ( !beginWriteTransaction() || !finishMigration( query, 1, true ) ) return false;
+    }
+
+    if ( version < 2 ) {
+        if ( !beginWriteTransaction() ) return false;
+        bool ok = query.exec( "CREATE INDEX IF NOT EXISTS idx_cards_set_id ON cards(set_id)" );
+        if ( !finishMigration( query, 2, ok ) ) return false;
+    }
+
+    if ( version < 3 ) {
+        if ( !beginWriteTransaction() ) return false;
+        bool media_ok = query.exec(
+            "CREATE TABLE IF NOT EXISTS media ("
+            "path TEXT PRIMARY KEY, "
+            "hash TEXT NOT NULL, "
+            "byte_size INTEGER NOT NULL, "
+            "width INTEGER DEFAULT 0, "
+            "height INTEGER DEFAULT 0, "
+            "duration_ms INTEGER DEFAULT 0, "
+            "thumbnail TEXT"
+            ")" );
+
+        // media added before the catalog existed is probed once here
+        vector<string> uncataloged;
+        if ( media_ok &&
+             query.exec( "SELECT DISTINCT question FROM cards WHERE media_type <> 0" ) ) {
+            while ( query.next() ) {
+                uncataloged.push_back( query.value( 0 ).toString().toStdString() );
+            }
+        }
+        for ( const auto& path : uncataloged ) {
+            catalogMedia( path );
+        }
+        if ( !finishMigration( query, 3, media_ok ) ) return false;
+    }
+
+    // building blocks of the counter triggers
+    const QString now = "datetime('now', 'localtime')";
+    const QString due_on =
+        "IFNULL((SELECT value FROM app_meta WHERE key = 'due_counted_on'), "
+        "date('now', 'localtime'))";
+    // 1 when the progress row puts the card's review after the counted day
+    auto not_due = [&due_on]( const QString& row ) {
+        return QString( "IFNULL(%1.next_review_date > %2, 0)" ).arg( row, due_on );
+    };
+    // 1 when the progress row counts the card as mastered, same bound as getSetStatistics
+    auto mastered = []( const QString& row ) {
+        return QString( "IFNULL(%1.interval >= 21, 0)" ).arg( row );
+    };
+    const QString set_of_progress = "(SELECT set_id FROM cards WHERE id = %1.card_id)";
+
+    if ( version < 4 ) {
+        // sets carry their last activity and due count so the set list can be sorted by an
+        // index, triggers keep both in step with cards and learning_progress
+        QStringList statements = {
+            "ALTER TABLE sets ADD COLUMN last_activity TEXT NOT NULL DEFAULT ''",
+            "ALTER TABLE sets ADD COLUMN due_count INTEGER NOT NULL DEFAULT 0",
+            "CREATE TABLE IF NOT EXISTS app_meta (key TEXT PRIMARY KEY, value TEXT)",
+            "UPDATE sets SET last_activity = " + now,
+            "CREATE INDEX IF NOT EXISTS idx_sets_name ON sets(name COLLATE NOCASE, id)",
+            "CREATE INDEX IF NOT EXISTS idx_sets_activity ON sets(last_activity, id)",
+            "CREATE INDEX IF NOT EXISTS idx_sets_due ON sets(due_count, id)",
+            "CREATE INDEX IF NOT EXISTS idx_progress_next_review "
+            "ON learning_progress(next_review_date)",
+            "CREATE TRIGGER IF NOT EXISTS trg_sets_created AFTER INSERT ON sets BEGIN "
+            "UPDATE sets SET last_activity = " + now + " WHERE id = NEW.id; END",
+            "CREATE TRIGGER IF NOT EXISTS trg_cards_added AFTER INSERT ON cards BEGIN "
+            "UPDATE sets SET due_count = due_count + 1, last_activity = " + now +
+                " WHERE id = NEW.set_id; END",
+            "CREATE TRIGGER IF NOT EXISTS trg_cards_removed AFTER DELETE ON cards BEGIN "
+            "UPDATE sets SET due_count = due_count - 1 + IFNULL((SELECT " + not_due( "lp" ) +
+                " FROM learning_progress lp WHERE lp.card_id = OLD.id), 0) "
+                "WHERE id = OLD.set_id; END",
+            "CREATE TRIGGER IF NOT EXISTS trg_progress_added AFTER INSERT ON learning_progress "
+            "BEGIN UPDATE sets SET due_count = due_count - " + not_due( "NEW" ) +
+                ", last_activity = " + now + " WHERE id = " + set_of_progress.arg( "NEW" ) +
+                "; END",
+            "CREATE TRIGGER IF NOT EXISTS trg_progress_updated AFTER UPDATE ON learning_progress "
+            "BEGIN UPDATE sets SET due_count = due_count + " + not_due( "OLD" ) + " - " +
+                not_due( "NEW" ) + ", last_activity = " + now +
+                " WHERE id = " + set_of_progress.arg( "NEW" ) + "; END",
+            "CREATE TRIGGER IF NOT EXISTS trg_progress_removed AFTER DELETE ON learning_progress "
+            "BEGIN UPDATE sets SET due_count = due_count + " + not_due( "OLD" ) +
+                " WHERE id = " + set_of_progress.arg( "OLD" ) + "; END",
+        };
+        if ( !beginWriteTransaction() ) return false;
+        if ( !finishMigration( query, 4, execAll( query, statements ) ) ) return false;
+    }
+
+    if ( version < 5 ) {
+        // sets are grouped into nested decks, deck_closure holds one row per ancestor-descendant
+        // pair (including the deck itself at depth 0), so a subtree is a single indexed lookup;
+        // every deck keeps the card, due and mastered totals of its whole subtree, which the set
+        // triggers push to all ancestors whenever a set's own counters move
+        auto ancestors_of = []( const QString& deck ) {
+            return QString( "(SELECT ancestor_id FROM deck_closure WHERE descendant_id = %1)" )
+                .arg( deck );
+        };
+        auto add_set_to_decks = [&ancestors_of]( const QString& sign, const QString& row ) {
+            return QString( "UPDATE decks SET card_count = card_count %1 %2.card_count, "
+                            "due_count = due_count %1 %2.due_count, "
+                            "mastered_count = mastered_count %1 %2.mastered_count "
+                            "WHERE id IN %3;" )
+                .arg( sign, row, ancestors_of( row + ".deck_id" ) );
+        };
+
+        QStringList statements = {
+            "CREATE TABLE IF NOT EXISTS decks ("
+            "id INTEGER PRIMARY KEY AUTOINCREMENT, "
+            "name TEXT NOT NULL, "
+            "parent_id INTEGER, "
+            "card_count INTEGER NOT NULL DEFAULT 0, "
+            "due_count INTEGER NOT NULL DEFAULT 0, "
+            "mastered_count INTEGER NOT NULL DEFAULT 0, "
+            "FOREIGN KEY(parent_id) REFERENCES decks(id)"
+            ")",
+            "CREATE TABLE IF NOT EXISTS deck_closure ("
+            "ancestor_id INTEGER NOT NULL, "
+            "descendant_id INTEGER NOT NULL, "
+            "depth INTEGER NOT NULL, "
+            "PRIMARY KEY(ancestor_id, descendant_id)"
+            ")",
+            "CREATE INDEX IF NOT EXISTS idx_deck_closure_descendant "
+            "ON deck_closure(descendant_id, ancestor_id)",
+            "CREATE INDEX IF NOT EXISTS idx_decks_parent ON decks(parent_id)",
+            "ALTER TABLE sets ADD COLUMN deck_id INTEGER REFERENCES decks(id)",
+            "ALTER TABLE sets ADD COLUMN card_count INTEGER NOT NULL DEFAULT 0",
+            "ALTER TABLE sets ADD COLUMN mastered_count INTEGER NOT NULL DEFAULT 0",
+            "CREATE INDEX IF NOT EXISTS idx_sets_deck ON sets(deck_id)",
+            "UPDATE sets SET card_count = (SELECT COUNT(*) FROM cards WHERE set_id = sets.id), "
+            "mastered_count = (SELECT COUNT(*) FROM cards c "
+            "JOIN learning_progress lp ON lp.card_id = c.id "
+            "WHERE c.set_id = sets.id AND lp.interval >= 21)",
+
+            // the schema 4 card and progress triggers now also count cards and mastered cards
+            "DROP TRIGGER IF EXISTS trg_cards_added",
+            "DROP TRIGGER IF EXISTS trg_cards_removed",
+            "DROP TRIGGER IF EXISTS trg_progress_added",
+            "DROP TRIGGER IF EXISTS trg_progress_updated",
+            "DROP TRIGGER IF EXISTS trg_progress_removed",
+            "CREATE TRIGGER trg_cards_added AFTER INSERT ON cards BEGIN "
+            "UPDATE sets SET card_count = card_count + 1, due_count = due_count + 1, "
+            "last_activity = " + now + " WHERE id = NEW.set_id; END",
+            "CREATE TRIGGER trg_cards_removed AFTER DELETE ON cards BEGIN "
+            "UPDATE sets SET card_count = card_count - 1, "
+            "due_count = due_count - 1 + IFNULL((SELECT " + not_due( "lp" ) +
+                " FROM learning_progress lp WHERE lp.card_id = OLD.id), 0), "
+                "mastered_count = mastered_count - IFNULL((SELECT " + mastered( "lp" ) +
+                " FROM learning_progress lp WHERE lp.card_id = OLD.id), 0) "
+                "WHERE id = OLD.set_id; END",
+            "CREATE TRIGGER trg_progress_added AFTER INSERT ON learning_progress BEGIN "
+            "UPDATE sets SET due_count = due_count - " + not_due( "NEW" ) +
+                ", mastered_count = mastered_count + " + mastered( "NEW" ) +
+                ", last_activity = " + now + " WHERE id = " + set_of_progress.arg( "NEW" ) +
+                "; END",
+            "CREATE TRIGGER trg_progress_updated AFTER UPDATE ON learning_progress BEGIN "
+            "UPDATE sets SET due_count = due_count + " + not_due( "OLD" ) + " - " +
+                not_due( "NEW" ) + ", mastered_count = mastered_count + " + mastered( "NEW" ) +
+                " - " + mastered( "OLD" ) + ", last_activity = " + now +
+                " WHERE id = " + set_of_progress.arg( "NEW" ) + "; END",
+            "CREATE TRIGGER trg_progress_removed AFTER DELETE ON learning_progress BEGIN "
+            "UPDATE sets SET due_count = due_count + " + not_due( "OLD" ) +
+                ", mastered_count = mastered_count - " + mastered( "OLD" ) +
+                " WHERE id = " + set_of_progress.arg( "OLD" ) + "; END",
+
+            // a set moving between decks leaves the old ancestors and joins the new ones at once,
+            // so the counter trigger only handles sets that stay where they are
+            "CREATE TRIGGER IF NOT EXISTS trg_sets_counters AFTER UPDATE OF card_count, due_count, "
+            "mastered_count ON sets WHEN NEW.deck_id IS NOT NULL AND NEW.deck_id IS OLD.deck_id "
+            "BEGIN UPDATE decks SET card_count = card_count + NEW.card_count - OLD.card_count, "
+            "due_count = due_count + NEW.due_count - OLD.due_count, "
+            "mastered_count = mastered_count + NEW.mastered_count - OLD.mastered_count "
+            "WHERE id IN " + ancestors_of( "NEW.deck_id" ) + "; END",
+            "CREATE TRIGGER IF NOT EXISTS trg_sets_moved AFTER UPDATE OF deck_id ON sets "
+            "WHEN NEW.deck_id IS NOT OLD.deck_id BEGIN " + add_set_to_decks( "-", "OLD" ) +
+                add_set_to_decks( "+", "NEW" ) + " END",
+            "CREATE TRIGGER IF NOT EXISTS trg_sets_removed AFTER DELETE ON sets "
+            "WHEN OLD.deck_id IS NOT NULL BEGIN " + add_set_to_decks( "-", "OLD" ) + " END",
+        };
+        if ( !beginWriteTransaction() ) return false;
+        if ( !finishMigration( query, 5, execAll( query, statements ) ) ) return false;
+    }
+
+    if ( version < 6 ) {
+        // alternative spellings an INPUT card accepts besides correct_answer, a JSON array
+        if ( !beginWriteTransaction() ) return false;
+        bool ok = query.exec(
+            "ALTER TABLE cards ADD COLUMN accepted_answers TEXT NOT NULL DEFAULT ''" );
+        if ( !finishMigration( query, 6, ok ) ) return false;
+    }
+
+    if ( version < 7 ) {
+        // FSRS memory of every card next to its SM-2 state, and a log of all reviews to fit
+        // FSRS weights to; review_log rows go away with their card
+        QStringList statements = {
+            "ALTER TABLE learning_progress ADD COLUMN stability REAL NOT NULL DEFAULT 0",
+            "ALTER TABLE learning_progress ADD COLUMN difficulty REAL NOT NULL DEFAULT 0",
+            "CREATE TABLE IF NOT EXISTS review_log ("
+            "id INTEGER PRIMARY KEY AUTOINCREMENT, "
+            "card_id INTEGER NOT NULL, "
+            "reviewed_on TEXT NOT NULL, "
+            "grade INTEGER NOT NULL, "
+            "elapsed_days INTEGER NOT NULL"
+            ")",
+            "CREATE INDEX IF NOT EXISTS idx_review_log_card ON review_log(card_id)",
+            "CREATE TRIGGER IF NOT EXISTS trg_cards_reviews_removed AFTER DELETE ON cards "
+            "BEGIN DELETE FROM review_log WHERE card_id = OLD.id; END",
+        };
+        if ( !beginWriteTransaction() ) return false;
+        if ( !finishMigration( query, 7, execAll( query, statements ) ) ) return false;
+    }
+
+    if ( version < 8 ) {
+        // a progress row carries the grade that produced it, the triggers append it to
+        // review_log, so saving a review is a single UPSERT; rows written without a grade, e.g.
+        // by updateCardProgress, are not logged
+        const QString log_review =
+            "INSERT INTO review_log (card_id, reviewed_on, grade, elapsed_days) "
+            "VALUES (NEW.card_id, date('now', 'localtime'), NEW.last_grade, "
+            "NEW.last_elapsed_days); END";
+        QStringList statements = {
+            "ALTER TABLE learning_progress ADD COLUMN last_grade INTEGER",
+            "ALTER TABLE learning_progress ADD COLUMN last_elapsed_days INTEGER",
+            "CREATE TRIGGER IF NOT EXISTS trg_progress_review_added AFTER INSERT ON "
+            "learning_progress WHEN NEW.last_grade IS NOT NULL BEGIN " + log_review,
+            "CREATE TRIGGER IF NOT EXISTS trg_progress_reviewed AFTER UPDATE OF last_grade ON "
+            "learning_progress BEGIN " + log_review,
+        };
+        if ( !beginWriteTransaction() ) return false;
+        if ( !finishMigration( query, 8, execAll( query, statements ) ) ) return false;
+    }
+
+    if ( version < 9 ) {
+        // a progress row repeats the set of its card, which never changes, so the due reviews of
+        // one set are read from their own index in date order
+        QStringList statements = {
+            "ALTER TABLE learning_progress ADD COLUMN set_id INTEGER",
+            "UPDATE learning_progress SET set_id = "
+            "(SELECT set_id FROM cards WHERE cards.id = learning_progress.card_id)",
+            "CREATE INDEX IF NOT EXISTS idx_progress_set_due "
+            "ON learning_progress(set_id, next_review_date, card_id)",
+        };
+        if ( !beginWriteTransaction() ) return false;
+        if ( !finishMigration( query, 9, execAll( query, statements ) ) ) return false;
+    }
+
+    return true;
+}
+
+// ends the transaction of a migration step: a step that went through records its version and
+// commits, a failed one is rolled back and leaves the database at the previous version
+bool DatabaseManager::finishMigration( QSqlQuery& query, int to_version, bool step_ok ) {
+    if ( !step_ok ||
+         !query.exec( QString( "PRAGMA user_version = %1" ).arg( to_version ) ) ) {
+        qCritical() << "Migration to schema" << to_version
+                    << "failed:" << query.lastError().text();
+        database_.rollback();
+        return false;
+    }
+    if ( !database_.commit() ) {
+        qCritical() << "Could not commit schema" << to_version << ":"
+                    << database_.lastError().text();
+        return false;
+    }
+    return true;
 }
 
 // seeding database with initial data for testing
@@ -144,27 +565,23 @@ void DatabaseManager::seedData() {
 // deletes all data from the database
 void DatabaseManager::flushData() {
     QSqlQuery q;
+    q.exec( "DELETE FROM review_log" );
+    q.exec( "DELETE FROM app_meta WHERE key = 'fsrs_weights'" );
     q.exec( "DELETE FROM learning_progress" );
     q.exec( "DELETE FROM cards" );
     q.exec( "DELETE FROM sets" );
+    q.exec( "DELETE FROM media" );
+    q.exec( "DELETE FROM deck_closure" );
+    q.exec( "DELETE FROM decks" );
 }
 
 // select query for all study sets
 vector<StudySet> DatabaseManager::getAllSets() const {
     vector<StudySet> results;
-    QSqlQuery query( "SELECT id, name FROM sets ORDER BY id DESC" );
+    QSqlQuery query( Queries::ALL_SETS );
 
     while ( query.next() ) {
-        StudySet s;
-        s.id = query.value( "id" ).toInt();
-        s.name = query.value( "name" ).toString().toStdString();
-
-        QSqlQuery count_q;
-        count_q.prepare( "SELECT COUNT(*) FROM cards WHERE set_id = :id" );
-        count_q.bindValue( ":id", s.id );
-        if ( count_q.exec() && count_q.next() ) s.card_count = count_q.value( 0 ).toInt();
-
-        results.push_back( s );
+        results.push_back( readSet( query ) );
     }
     return results;
 }
@@ -172,54 +589,267 @@ vector<StudySet> DatabaseManager::getAllSets() const {
 // select query for a specific study set by id
 optional<StudySet> DatabaseManager::getSet( int set_id ) const {
     QSqlQuery query;
-    query.prepare( "SELECT id, name FROM sets WHERE id = :id" );
+    query.prepare( Queries::SET_BY_ID );
     query.bindValue( ":id", set_id );
 
-    if ( query.exec() && query.next() ) {
-        StudySet s;
-        s.id = query.value( "id" ).toInt();
-        s.name = query.value( "name" ).toString().toStdString();
-        return s;
-    }
+    if ( query.exec() && query.next() ) return readSet( query );
     return nullopt;
 }
 
+// select query for one page of sets, cursor values of the first page sort before every row
+vector<StudySet> DatabaseManager::getSetsPage( SetSort sort, int limit,
+                                               const optional<StudySet>& after ) const {
+    QSqlQuery query;
+    QVariant key;
+    switch ( sort ) {
+        case SetSort::NEWEST:
+            query.prepare( Queries::SETS_PAGE_NEWEST );
+            break;
+        case SetSort::NAME:
+            query.prepare( Queries::SETS_PAGE_NAME );
+            key = after ? QString::fromStdString( after->name ) : QString( "" );
+            break;
+        case SetSort::RECENT_ACTIVITY:
+            query.prepare( Queries::SETS_PAGE_ACTIVITY );
+            key = after ? QString::fromStdString( after->last_activity ) : QString( "~" );
+            break;
+        case SetSort::DUE_COUNT:
+            query.prepare( Queries::SETS_PAGE_DUE );
+            key = after ? after->due_count : numeric_limits<int>::max();
+            break;
+    }
+
+    int first_id = sort == SetSort::NAME ? 0 : numeric_limits<int>::max();
+    query.bindValue( ":id", after ? after->id : first_id );
+    if ( key.isValid() ) query.bindValue( ":key", key );
+    query.bindValue( ":limit", limit );
+
+    vector<StudySet> results;
+    if ( !query.exec() ) {
+        qCritical() << "Error fetching sets page:" << query.lastError().text();
+        return results;
+    }
+    while ( query.next() ) {
+        results.push_back( readSet( query ) );
+    }
+    return results;
+}
+
 // select query for all cards in a given set
 vector<Card> DatabaseManager::getCardsForSet( int set_id ) const {
-    QString sql =
-        "SELECT id, set_id, question, correct_answer, wrong_answers, answer_type, media_type "
-        "FROM cards WHERE set_id = :id";
-    return getCardsWithQuery( sql, set_id, -1 );
+    return getCardsWithQuery( Queries::CARDS_OF_SET, set_id, -1 );
+}
+
+// select query for all cards in a given set, loaded straight into the pooled store
+// the columns are appended straight from the row values by position, strings go from their
+// UTF-8 bytes into the pool without a CardData or std::string per card
+CardStore DatabaseManager::getCardStore( int set_id ) const {
+    CardStore store;
+    store.reserve( getCardCount( set_id ) );
+    QSqlQuery query;
+    query.setForwardOnly( true );
+    query.prepare( Queries::CARDS_OF_SET );
+    query.bindValue( ":id", set_id );
+    if ( !query.exec() ) {
+        qCritical() << "Error loading card store:" << query.lastError().text();
+        return store;
+    }
+
+    auto utf8View = []( const QByteArray& bytes ) {
+        return string_view( bytes.constData(), static_cast<size_t>( bytes.size() ) );
+    };
+    while ( query.next() ) {
+        QByteArray question = decodeText( query.value( 2 ) ).toUtf8();
+        QByteArray correct_answer = decodeText( query.value( 3 ) ).toUtf8();
+        int m_val = query.value( 7 ).toInt();
+        MediaType media_type = m_val == 1   ? MediaType::IMAGE
+                               : m_val == 2 ? MediaType::SOUND
+                                            : MediaType::TEXT;
+        store.beginRow( query.value( 0 ).toInt(), query.value( 1 ).toInt(), media_type,
+                        static_cast<AnswerType>( query.value( 6 ).toInt() ), utf8View( question ),
+                        utf8View( correct_answer ) );
+
+        // same formats as readCardData: a JSON array, or the old ';' separated list
+        QString wrong_raw = query.value( 4 ).toString();
+        QJsonDocument wrong = QJsonDocument::fromJson( wrong_raw.toUtf8() );
+        if ( wrong.isArray() ) {
+            for ( const auto& value : wrong.array() ) {
+                store.addWrongAnswer( utf8View( value.toString().toUtf8() ) );
+            }
+        } else if ( !wrong_raw.isEmpty() ) {
+            for ( const auto& part : wrong_raw.split( ';', Qt::SkipEmptyParts ) ) {
+                store.addWrongAnswer( utf8View( part.toUtf8() ) );
+            }
+        }
+        QJsonDocument accepted = QJsonDocument::fromJson( query.value( 5 ).toByteArray() );
+        if ( accepted.isArray() ) {
+            for ( const auto& value : accepted.array() ) {
+                store.addAcceptedAnswer( utf8View( value.toString().toUtf8() ) );
+            }
+        }
+    }
+    return store;
+}
+
+// select query for a single card by id
+optional<Card> DatabaseManager::getCard( int card_id ) const {
+    vector<Card> cards = getCardsWithQuery( Queries::CARD_BY_ID, card_id, -1 );
+    if ( cards.empty() ) return nullopt;
+    return cards.front();
+}
+
+// select query for a page of card list rows, media paths and answers are not loaded
+vector<CardSummary> DatabaseManager::getCardSummaries( int set_id, int offset, int limit ) const {
+    vector<CardSummary> summaries;
+    QSqlQuery query;
+    query.prepare( Queries::CARD_SUMMARIES );
+    query.bindValue( ":len", SUMMARY_QUESTION_LENGTH );
+    query.bindValue( ":id", set_id );
+    query.bindValue( ":limit", limit );
+    query.bindValue( ":offset", offset );
+
+    if ( !query.exec() ) {
+        qCritical() << "Error loading card summaries:" << query.lastError().text();
+        return summaries;
+    }
+
+    while ( query.next() ) {
+        CardSummary summary;
+        summary.id = query.value( 0 ).toInt();
+        int m_val = query.value( 1 ).toInt();
+        if ( m_val == 1 ) {
+            summary.media_type = MediaType::IMAGE;
+        } else if ( m_val == 2 ) {
+            summary.media_type = MediaType::SOUND;
+        } else {
+            summary.media_type = MediaType::TEXT;
+        }
+        summary.question =
+            summary.media_type == MediaType::TEXT
+                ? decodeText( query.value( 2 ) ).left( SUMMARY_QUESTION_LENGTH ).toStdString()
+                : "[Media Content]";
+        summaries.push_back( std::move( summary ) );
+    }
+    return summaries;
 }
 
 // retrieved random cards
 vector<Card> DatabaseManager::getRandomCards( int set_id, int limit ) const {
-    QString sql =
-        "SELECT id, set_id, question, correct_answer, wrong_answers, answer_type, media_type "
-        "FROM cards WHERE set_id = :id ORDER BY RANDOM() LIMIT :limit";
-    return getCardsWithQuery( sql, set_id, limit );
+    return getCardsWithQuery( Queries::RANDOM_CARDS, set_id, limit );
 }
 
 // retrieved cards due for review (SM-2 logic)
 vector<Card> DatabaseManager::getDueCards( int set_id, int limit ) const {
-    QString sql = R"(
-        SELECT c.id, c.set_id, c.question, c.correct_answer, c.wrong_answers, c.answer_type, c.media_type
-        FROM cards c
-        LEFT JOIN learning_progress lp ON c.id = lp.card_id
-        WHERE c.set_id = :id
-          AND (lp.next_review_date IS NULL OR lp.next_review_date <= date('now', 'localtime'))
-        ORDER BY lp.next_review_date ASC
-        LIMIT :limit
-    )";
-    return getCardsWithQuery( sql, set_id, limit );
+    return getCardsWithQuery( Queries::DUE_CARDS, set_id, limit );
+}
+
+// random cards together with their SM-2 state
+vector<ScheduledCard> DatabaseManager::getRandomScheduledCards( int set_id, int limit ) const {
+    return getScheduledCardsWithQuery( Queries::RANDOM_CARDS_SCHEDULED, set_id, limit );
+}
+
+// due cards together with their SM-2 state
+vector<ScheduledCard> DatabaseManager::getDueScheduledCards( int set_id, int limit ) const {
+    return getScheduledCardsWithQuery( Queries::DUE_CARDS_SCHEDULED, set_id, limit );
+}
+
+// the page of the due queue following the cursor, which is moved past its last card; the order
+// is that of getDueScheduledCards with ties broken by id, new cards are read until they run out
+// and the reviewed ones after them
+vector<ScheduledCard> DatabaseManager::getDueScheduledPage( int set_id, DueCursor& after,
+                                                            int limit ) const {
+    vector<ScheduledCard> cards;
+    QSqlQuery query;
+    query.setForwardOnly( true );
+    if ( after.review_date.empty() ) {
+        query.prepare( Queries::DUE_NEW_CARDS_PAGE );
+        query.bindValue( ":id", set_id );
+        query.bindValue( ":after_id", after.card_id );
+        query.bindValue( ":limit", limit );
+        if ( !query.exec() ) {
+            qCritical() << "Error loading new cards page:" << query.lastError().text();
+            return cards;
+        }
+        while ( query.next() ) {
+            cards.push_back( readScheduledCard( query ) );
+            after.card_id = cards.back().card.getId();
+        }
+        if ( static_cast<int>( cards.size() ) == limit ) return cards;
+    }
+
+    query.prepare( Queries::DUE_REVIEWS_PAGE );
+    query.bindValue( ":id", set_id );
+    query.bindValue( ":after_date", QString::fromStdString( after.review_date ) );
+    query.bindValue( ":after_id", after.card_id );
+    query.bindValue( ":limit", limit - static_cast<int>( cards.size() ) );
+    if ( !query.exec() ) {
+        qCritical() << "Error loading due page:" << query.lastError().text();
+        return cards;
+    }
+    while ( query.next() ) {
+        cards.push_back( readScheduledCard( query ) );
+        after.review_date = query.value( "review_date" ).toString().toStdString();
+        after.card_id = cards.back().card.getId();
+    }
+    return cards;
+}
+
+int DatabaseManager::getDueCount( int set_id ) const {
+    QSqlQuery query;
+    query.prepare( Queries::DUE_COUNT_OF_SET );
+    query.bindValue( ":id", set_id );
+    if ( query.exec() && query.next() ) return query.value( 0 ).toInt();
+    return 0;
+}
+
+// ids only, so a caller can order a large set without loading its cards
+vector<int> DatabaseManager::getCardIds( int set_id ) const {
+    vector<int> ids;
+    QSqlQuery query;
+    query.setForwardOnly( true );
+    query.prepare( Queries::CARD_IDS_OF_SET );
+    query.bindValue( ":id", set_id );
+    if ( !query.exec() ) {
+        qCritical() << "Error loading card ids:" << query.lastError().text();
+        return ids;
+    }
+    while ( query.next() ) {
+        ids.push_back( query.value( 0 ).toInt() );
+    }
+    return ids;
+}
+
+// cards in the order of the ids, the ones deleted in the meantime are left out
+vector<ScheduledCard> DatabaseManager::getScheduledCards( const vector<int>& card_ids ) const {
+    vector<ScheduledCard> cards;
+    cards.reserve( card_ids.size() );
+    QSqlQuery query;
+    query.setForwardOnly( true );
+    query.prepare( Queries::SCHEDULED_CARD_BY_ID );
+    for ( int card_id : card_ids ) {
+        query.bindValue( ":id", card_id );
+        if ( !query.exec() ) {
+            qCritical() << "Error loading card:" << query.lastError().text();
+            continue;
+        }
+        if ( query.next() ) cards.push_back( readScheduledCard( query ) );
+    }
+    return cards;
+}
+
+// counts cards of a set using the set_id index
+int DatabaseManager::getCardCount( int set_id ) const {
+    QSqlQuery query;
+    query.prepare( Queries::CARD_COUNT );
+    query.bindValue( ":id", set_id );
+    if ( query.exec() && query.next() ) return query.value( 0 ).toInt();
+    return 0;
 }
 
 // retrieves learning progress for a specific card
 tuple<int, int, float> DatabaseManager::getCardProgress( int card_id ) const {
     QSqlQuery query;
-    query.prepare(
-        "SELECT interval, repetitions, easiness_factor FROM learning_progress WHERE card_id = "
-        ":id" );
+    query.prepare( Queries::CARD_PROGRESS );
     query.bindValue( ":id", card_id );
 
     if ( query.exec() && query.next() ) {
@@ -232,14 +862,61 @@ QString DatabaseManager::getImagesPath() const { return data_path_ + "/media/ima
 
 QString DatabaseManager::getSoundsPath() const { return data_path_ + "/media/sounds/"; }
 
+QString DatabaseManager::getMediaRoot() const { return data_path_ + "/media/"; }
+
+// select query for the catalog entry of a media file, nullopt when it was never cataloged
+optional<MediaInfo> DatabaseManager::getMediaInfo( const string& rel_path ) const {
+    QSqlQuery query;
+    query.prepare( Queries::MEDIA_BY_PATH );
+    query.bindValue( ":path", QString::fromStdString( rel_path ) );
+
+    if ( !query.exec() ) {
+        qCritical() << "Error fetching media info:" << query.lastError().text();
+        return nullopt;
+    }
+    if ( !query.next() ) return nullopt;
+
+    MediaInfo info;
+    info.path = query.value( 0 ).toString().toStdString();
+    info.hash = query.value( 1 ).toString().toStdString();
+    info.byte_size = query.value( 2 ).toLongLong();
+    info.width = query.value( 3 ).toInt();
+    info.height = query.value( 4 ).toInt();
+    info.duration_ms = query.value( 5 ).toInt();
+    info.thumbnail = query.value( 6 ).toString().toStdString();
+    return info;
+}
+
+// probes a media file and stores its metadata, the file itself stays where it is
+bool DatabaseManager::catalogMedia( const string& rel_path ) {
+    optional<MediaInfo> info = MediaProbe::probe( getMediaRoot(), rel_path );
+    if ( !info ) return false;
+
+    QSqlQuery query;
+    query.prepare( Queries::SAVE_MEDIA );
+    query.bindValue( ":path", QString::fromStdString( info->path ) );
+    query.bindValue( ":hash", QString::fromStdString( info->hash ) );
+    query.bindValue( ":size", info->byte_size );
+    query.bindValue( ":width", info->width );
+    query.bindValue( ":height", info->height );
+    query.bindValue( ":duration", info->duration_ms );
+    query.bindValue( ":thumbnail", QString::fromStdString( info->thumbnail ) );
+
+    if ( !query.exec() ) {
+        qCritical() << "Error saving media info:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
 // insert query to create a new set with its cards
 bool DatabaseManager::createSet( const string& set_name, const vector<DraftCard>& cards ) {
     if ( set_name.empty() ) return false;
 
-    database_.transaction();
+    if ( !beginWriteTransaction() ) return false;
 
     QSqlQuery query;
-    query.prepare( "INSERT INTO sets (name) VALUES (:name)" );
+    query.prepare( Queries::INSERT_SET );
     query.bindValue( ":name", QString::fromStdString( set_name ) );
 
     if ( !query.exec() ) {
@@ -250,22 +927,28 @@ bool DatabaseManager::createSet( const string& set_name, const vector<DraftCard>
 
     int new_set_id = query.lastInsertId().toInt();
 
+    // listeners get a single SET_ADDED instead of one event per card
+    notifications_muted_ = true;
     for ( const auto& card : cards ) {
         if ( !addCardToSet( new_set_id, card ) ) {
+            notifications_muted_ = false;
             database_.rollback();
             return false;
         }
     }
+    notifications_muted_ = false;
 
-    return database_.commit();
+    if ( !database_.commit() ) return false;
+    notify( { ChangeType::SET_ADDED, new_set_id } );
+    return true;
 }
 
 // delete query to remove a set by id
 bool DatabaseManager::deleteSet( int set_id ) {
-    database_.transaction();
+    if ( !beginWriteTransaction() ) return false;
     QSqlQuery query;
 
-    query.prepare( "SELECT question FROM cards WHERE set_id = :id" );
+    query.prepare( Queries::QUESTIONS_OF_SET );
     query.bindValue( ":id", set_id );
 
     if ( query.exec() ) {
@@ -274,15 +957,21 @@ bool DatabaseManager::deleteSet( int set_id ) {
             if ( content.startsWith( "images/" ) || content.startsWith( "sounds/" ) ) {
                 QString fullPath = getAbsMediaPath( content );
                 QFile::remove( fullPath );
+                removeThumbnail( content );
             }
         }
     } else {
         qWarning() << "Could not fetch cards to delete files for set:" << set_id;
     }
 
-    query.prepare(
-        "DELETE FROM learning_progress WHERE card_id IN (SELECT id FROM cards WHERE set_id = "
-        ":id)" );
+    query.prepare( Queries::DELETE_MEDIA_OF_SET );
+    query.bindValue( ":id", set_id );
+    if ( !query.exec() ) {
+        qWarning() << "Failed to delete media catalog for set:" << set_id
+                   << query.lastError().text();
+    }
+
+    query.prepare( Queries::DELETE_PROGRESS_OF_SET );
     query.bindValue( ":id", set_id );
     if ( !query.exec() ) {
         qCritical() << "Failed to delete learning progress for set:" << set_id
@@ -291,7 +980,7 @@ bool DatabaseManager::deleteSet( int set_id ) {
         return false;
     }
 
-    query.prepare( "DELETE FROM cards WHERE set_id = :id" );
+    query.prepare( Queries::DELETE_CARDS_OF_SET );
     query.bindValue( ":id", set_id );
     if ( !query.exec() ) {
         qCritical() << "Failed to delete cards for set:" << set_id << query.lastError().text();
@@ -299,7 +988,7 @@ bool DatabaseManager::deleteSet( int set_id ) {
         return false;
     }
 
-    query.prepare( "DELETE FROM sets WHERE id = :id" );
+    query.prepare( Queries::DELETE_SET );
     query.bindValue( ":id", set_id );
     if ( !query.exec() ) {
         qCritical() << "Could not delete set ID:" << set_id
@@ -313,16 +1002,21 @@ bool DatabaseManager::deleteSet( int set_id ) {
          return false;
     }
 
-    return database_.commit();
+    if ( !database_.commit() ) return false;
+    notify( { ChangeType::SET_DELETED, set_id } );
+    return true;
 }
 
 // insert query to add a single card to an existing set
 bool DatabaseManager::addCardToSet( int set_id, const DraftCard& draft ) {
+    if ( draft.wrong_answers.size() >= ChoiceOrder::MAX_CHOICES ) {
+        qWarning() << "Card has more wrong answers than a quiz can show:"
+                   << draft.wrong_answers.size();
+        return false;
+    }
+
     QSqlQuery query;
-    query.prepare(
-        "INSERT INTO cards (set_id, question, correct_answer, wrong_answers, answer_type, "
-        "media_type) "
-        "VALUES (:set_id, :question, :correct, :wrong, :ans_type, :media_type)" );
+    query.prepare( Queries::INSERT_CARD );
 
     query.bindValue( ":set_id", set_id );
 
@@ -340,16 +1034,13 @@ bool DatabaseManager::addCardToSet( int set_id, const DraftCard& draft ) {
         media_type_int = 2;
     }
 
-    query.bindValue( ":question", QString::fromStdString( q_text ) );
+    // media paths stay plain text, they are matched by prefix when files are removed
+    query.bindValue( ":question", encodeText( q_text, text_compression_ && media_type_int == 0 ) );
     query.bindValue( ":media_type", media_type_int );
 
-    query.bindValue( ":correct", QString::fromStdString( draft.correct_answer ) );
-    QJsonArray wrong_arr;
-    for ( const auto& w : draft.wrong_answers ) {
-        wrong_arr.append( QString::fromStdString( w ) );
-    }
-    QJsonDocument doc( wrong_arr );
-    query.bindValue( ":wrong", doc.toJson( QJsonDocument::Compact ) );
+    query.bindValue( ":correct", encodeText( draft.correct_answer, text_compression_ ) );
+    query.bindValue( ":wrong", toJsonArray( draft.wrong_answers ) );
+    query.bindValue( ":accepted", toJsonArray( draft.accepted_answers ) );
 
     query.bindValue( ":ans_type", (int)draft.answer_type );
 
@@ -357,6 +1048,11 @@ bool DatabaseManager::addCardToSet( int set_id, const DraftCard& draft ) {
         qCritical() << "AddCard Error:" << query.lastError().text();
         return false;
     }
+    // a card whose file cannot be probed is still added, views then report the media as missing
+    if ( media_type_int != 0 && !catalogMedia( q_text ) ) {
+        qWarning() << "Could not catalog media:" << QString::fromStdString( q_text );
+    }
+    notify( { ChangeType::CARD_ADDED, set_id, query.lastInsertId().toInt() } );
     return true;
 }
 
@@ -364,10 +1060,12 @@ bool DatabaseManager::addCardToSet( int set_id, const DraftCard& draft ) {
 bool DatabaseManager::deleteCard( int card_id ) {
     QSqlQuery query;
 
-    query.prepare( "SELECT question FROM cards WHERE id = :id" );
+    query.prepare( Queries::QUESTION_OF_CARD );
     query.bindValue( ":id", card_id );
 
+    int set_id = -1;
     if ( query.exec() && query.next() ) {
+        set_id = query.value( 1 ).toInt();
         QString content = query.value( 0 ).toString();
         if ( content.startsWith( "images/" ) || content.startsWith( "sounds/" ) ) {
             QString fullPath = getAbsMediaPath( content );
@@ -379,10 +1077,16 @@ bool DatabaseManager::deleteCard( int card_id ) {
                     qWarning() << "Nie udało się usunąć pliku:" << fullPath;
                 }
             }
+            removeThumbnail( content );
+
+            QSqlQuery media_query;
+            media_query.prepare( Queries::DELETE_MEDIA );
+            media_query.bindValue( ":path", content );
+            media_query.exec();
         }
     }
 
-    query.prepare( "DELETE FROM cards WHERE id = :id" );
+    query.prepare( Queries::DELETE_CARD );
     query.bindValue( ":id", card_id );
 
     if ( !query.exec() ) {
@@ -394,6 +1098,7 @@ bool DatabaseManager::deleteCard( int card_id ) {
     if ( query.numRowsAffected() == 0 ) {
         return false;
     }
+    notify( { ChangeType::CARD_DELETED, set_id, card_id } );
     return true;
 }
 
@@ -401,10 +1106,7 @@ bool DatabaseManager::deleteCard( int card_id ) {
 bool DatabaseManager::updateCardProgress( int card_id, int interval, int repetitions,
                                           float easiness, const string& next_date ) {
     QSqlQuery query;
-    query.prepare( R"(
-        INSERT OR REPLACE INTO learning_progress (card_id, interval, repetitions, easiness_factor, next_review_date)
-        VALUES (:id, :iv, :rep, :ef, :date)
-    )" );
+    query.prepare( Queries::SAVE_PROGRESS );
 
     query.bindValue( ":id", card_id );
     query.bindValue( ":iv", interval );
@@ -416,29 +1118,241 @@ bool DatabaseManager::updateCardProgress( int card_id, int interval, int repetit
         qCritical() << "Error saving progress:" << query.lastError().text();
         return false;
     }
+    notify( { ChangeType::PROGRESS_CHANGED, -1, card_id } );
+    return true;
+}
+
+// one statement: the progress UPSERT carries the grade and its trigger writes the review_log row
+// in the same implicit transaction
+bool DatabaseManager::saveReview( int card_id, int grade, int elapsed_days,
+                                  const SuperMemoState& state, const FsrsState& memory ) {
+    QSqlQuery query;
+    query.prepare( Queries::SAVE_REVIEW_PROGRESS );
+    query.bindValue( ":id", card_id );
+    query.bindValue( ":iv", state.interval );
+    query.bindValue( ":rep", state.repetitions );
+    query.bindValue( ":ef", state.easiness );
+    query.bindValue( ":stability", memory.stability );
+    query.bindValue( ":difficulty", memory.difficulty );
+    query.bindValue( ":offset", QString( "+%1 days" ).arg( state.interval ) );
+    query.bindValue( ":grade", grade );
+    query.bindValue( ":elapsed", elapsed_days );
+    if ( !query.exec() ) {
+        qCritical() << "Error saving review:" << query.lastError().text();
+        return false;
+    }
+    notify( { ChangeType::PROGRESS_CHANGED, -1, card_id } );
+    return true;
+}
+
+// forward only, the history of a large collection is read straight into the records
+static vector<ReviewRecord> readReviewHistory( QSqlQuery& query ) {
+    vector<ReviewRecord> history;
+    query.setForwardOnly( true );
+    if ( !query.exec( Queries::REVIEW_HISTORY ) ) {
+        qCritical() << "Error reading review history:" << query.lastError().text();
+        return history;
+    }
+    while ( query.next() ) {
+        int grade = query.value( 1 ).toInt();
+        history.push_back(
+            { query.value( 0 ).toInt(), Fsrs::ratingOfGrade( grade ), query.value( 2 ).toInt() } );
+    }
+    return history;
+}
+
+vector<ReviewRecord> DatabaseManager::getReviewHistory() const {
+    QSqlQuery query;
+    return readReviewHistory( query );
+}
+
+// a connection belongs to the thread that opened it, so every call opens and drops its own;
+// with the write-ahead log the read does not hold up the main connection
+vector<ReviewRecord> DatabaseManager::getReviewHistoryDetached() const {
+    QString name = QString( "review_history_%1" )
+                       .arg( reinterpret_cast<quintptr>( QThread::currentThreadId() ) );
+    vector<ReviewRecord> history;
+    {
+        QSqlDatabase database = QSqlDatabase::addDatabase( "QSQLITE", name );
+        database.setDatabaseName( data_path_ + "/" + db_name_ );
+        database.setConnectOptions( QString( "QSQLITE_BUSY_TIMEOUT=%1;QSQLITE_OPEN_READONLY" )
+                                        .arg( BUSY_TIMEOUT_MS ) );
+        if ( database.open() ) {
+            QSqlQuery query( database );
+            history = readReviewHistory( query );
+        } else {
+            qCritical() << "Error opening database for review history:"
+                        << database.lastError().text();
+        }
+    }
+    QSqlDatabase::removeDatabase( name );
+    return history;
+}
+
+// weights are kept in app_meta as a comma separated list
+optional<Fsrs::Weights> DatabaseManager::getFsrsWeights() const {
+    QSqlQuery query;
+    if ( !query.exec( Queries::FSRS_WEIGHTS ) || !query.next() ) return nullopt;
+
+    QStringList values = query.value( 0 ).toString().split( ',' );
+    if ( values.size() != static_cast<int>( Fsrs::WEIGHT_COUNT ) ) return nullopt;
+    Fsrs::Weights weights;
+    for ( size_t i = 0; i < Fsrs::WEIGHT_COUNT; ++i ) {
+        bool ok = false;
+        weights[i] = values[i].toDouble( &ok );
+        if ( !ok ) return nullopt;
+    }
+    return weights;
+}
+
+bool DatabaseManager::saveFsrsWeights( const Fsrs::Weights& weights ) {
+    QStringList values;
+    for ( double weight : weights ) values << QString::number( weight, 'g', 17 );
+
+    QSqlQuery query;
+    query.prepare( Queries::SAVE_FSRS_WEIGHTS );
+    query.bindValue( ":weights", values.join( ',' ) );
+    if ( !query.exec() ) {
+        qCritical() << "Could not save FSRS weights:" << query.lastError().text();
+        return false;
+    }
     return true;
 }
 
+// one indexed query per set, so the forecast never scans the whole progress table
+ProgressColumns DatabaseManager::getProgressColumns( const vector<int>& set_ids ) const {
+    ProgressColumns progress;
+    QSqlQuery query;
+    query.setForwardOnly( true );
+    query.prepare( Queries::PROGRESS_OF_SET );
+    for ( int set_id : set_ids ) {
+        query.bindValue( ":id", set_id );
+        if ( !query.exec() ) {
+            qCritical() << "Error reading progress of set:" << query.lastError().text();
+            continue;
+        }
+        while ( query.next() ) {
+            if ( query.value( 0 ).isNull() ) {
+                progress.add( SuperMemo::getInitialState(), 0 );
+                continue;
+            }
+            SuperMemoState state{ query.value( 0 ).toInt(), query.value( 1 ).toInt(),
+                                  query.value( 2 ).toFloat() };
+            progress.add( state, query.value( 3 ).toInt() );
+        }
+    }
+    return progress;
+}
+
 // Clears learning progress for all cards in a set
 bool DatabaseManager::resetSetProgress( int set_id ) {
     QSqlQuery query;
-    query.prepare(
-        "DELETE FROM learning_progress WHERE card_id IN (SELECT id FROM cards WHERE set_id = "
-        ":id)" );
+    query.prepare( Queries::DELETE_PROGRESS_OF_SET );
     query.bindValue( ":id", set_id );
 
     if ( !query.exec() ) {
         qCritical() << "Failed to reset progress:" << query.lastError().text();
         return false;
     }
+    notify( { ChangeType::PROGRESS_CHANGED, set_id } );
     return true;
 }
 
+// clears progress of the next batch_size cards (by id) after after_card_id and moves the cursor,
+// returns the number of cards covered (0 once the set is done) or -1 on error
+int DatabaseManager::resetSetProgressBatch( int set_id, int& after_card_id, int batch_size ) {
+    QSqlQuery query;
+    query.prepare( Queries::RESET_BATCH_RANGE );
+    query.bindValue( ":id", set_id );
+    query.bindValue( ":after", after_card_id );
+    query.bindValue( ":limit", batch_size );
+    if ( !query.exec() || !query.next() ) {
+        qCritical() << "Failed to read reset batch:" << query.lastError().text();
+        return -1;
+    }
+
+    int covered = query.value( 0 ).toInt();
+    if ( covered == 0 ) return 0;
+    int upto = query.value( 1 ).toInt();
+
+    query.prepare( Queries::RESET_BATCH_DELETE );
+    query.bindValue( ":id", set_id );
+    query.bindValue( ":after", after_card_id );
+    query.bindValue( ":upto", upto );
+    if ( !query.exec() ) {
+        qCritical() << "Failed to reset progress batch:" << query.lastError().text();
+        return -1;
+    }
+
+    after_card_id = upto;
+    return covered;
+}
+
+void DatabaseManager::endProgressReset( int set_id ) {
+    notify( { ChangeType::PROGRESS_CHANGED, set_id } );
+}
+
 // calculates the next review date based on the current date and a given offset
 string DatabaseManager::calculateNextDate( int days_from_now ) {
     return QDate::currentDate().addDays( days_from_now ).toString( "yyyy-MM-dd" ).toStdString();
 }
 
+// cards whose review date arrived since the last count are added to their set's due_count, the
+// first call (or a clock that went backwards) recounts every set
+bool DatabaseManager::refreshDueCounts() {
+    QString today = QDate::currentDate().toString( "yyyy-MM-dd" );
+    QSqlQuery query( database_ );
+    QString counted_on;
+    if ( query.exec( Queries::DUE_COUNTED_ON ) && query.next() ) {
+        counted_on = query.value( 0 ).toString();
+    }
+    if ( counted_on == today ) return true;
+
+    if ( !beginWriteTransaction() ) return false;
+
+    bool full_recount = counted_on.isEmpty() || counted_on > today;
+    query.prepare( full_recount ? Queries::RECOUNT_DUE : Queries::ADD_NEWLY_DUE );
+    query.bindValue( ":today", today );
+    if ( !full_recount ) query.bindValue( ":since", counted_on );
+    if ( !query.exec() ) {
+        qCritical() << "Could not refresh due counts:" << query.lastError().text();
+        database_.rollback();
+        return false;
+    }
+
+    query.prepare( Queries::SAVE_DUE_COUNTED_ON );
+    query.bindValue( ":today", today );
+    if ( !query.exec() ) {
+        qCritical() << "Could not store due count date:" << query.lastError().text();
+        database_.rollback();
+        return false;
+    }
+    return database_.commit();
+}
+
+// BEGIN IMMEDIATE takes the write lock up front: a writer in another process makes us wait in
+// the busy timeout instead of failing half way through; the wait is bounded by
+// BUSY_TIMEOUT_MS, after that the write fails and the caller reports it
+bool DatabaseManager::beginWriteTransaction() {
+    QSqlQuery query( database_ );
+    if ( query.exec( "BEGIN IMMEDIATE" ) ) return true;
+    qCritical() << "Could not start a transaction:" << query.lastError().text();
+    return false;
+}
+
+// PRAGMA data_version only moves when another connection commits, our own writes never cause a
+// refresh, and the check is cheap enough to run on a timer
+bool DatabaseManager::pollExternalChanges() {
+    QSqlQuery query( database_ );
+    if ( !query.exec( "PRAGMA data_version" ) || !query.next() ) return false;
+
+    qint64 version = query.value( 0 ).toLongLong();
+    bool changed = data_version_ >= 0 && version != data_version_;
+    data_version_ = version;
+    if ( changed ) notify( { ChangeType::EXTERNAL } );
+    return changed;
+}
+
 // helper function to execute card retrieval queries
 vector<Card> DatabaseManager::getCardsWithQuery( const QString& sql, int set_id, int limit ) const {
     vector<Card> cards;
@@ -453,64 +1367,212 @@ vector<Card> DatabaseManager::getCardsWithQuery( const QString& sql, int set_id,
     }
 
     while ( query.next() ) {
-        CardData data;
-        data.id = query.value( "id" ).toInt();
-        data.set_id = query.value( "set_id" ).toInt();
-        data.correct_answer = query.value( "correct_answer" ).toString().toStdString();
-        data.answer_type = (AnswerType)query.value( "answer_type" ).toInt();
-
-        int m_val = query.value( "media_type" ).toInt();
-        string q_str = query.value( "question" ).toString().toStdString();
+        cards.emplace_back( readCardData( query ) );
+    }
+    return cards;
+}
 
-        if ( m_val == 1 ) {
-            data.question = ImageContent{ q_str };
-        } else if ( m_val == 2 ) {
-            data.question = SoundContent{ q_str };
-        } else {
-            data.question = TextContent{ q_str };
-        }
+// cards without a learning_progress row start from the initial SM-2 state and no FSRS memory
+vector<ScheduledCard> DatabaseManager::getScheduledCardsWithQuery( const QString& sql, int set_id,
+                                                                   int limit ) const {
+    vector<ScheduledCard> cards;
+    QSqlQuery query;
+    query.prepare( sql );
+    query.bindValue( ":id", set_id );
+    query.bindValue( ":limit", limit );
 
-        QString w_raw = query.value( "wrong_answers" ).toString();
+    if ( !query.exec() ) {
+        qCritical() << "Error executing card query:" << query.lastError().text();
+        return cards;
+    }
 
-        QJsonDocument doc = QJsonDocument::fromJson( w_raw.toUtf8() );
-        if ( !doc.isNull() && doc.isArray() ) {
-            QJsonArray arr = doc.array();
-            for ( const auto& val : arr ) {
-                data.wrong_answers.push_back( val.toString().toStdString() );
-            }
-        } else if ( !w_raw.isEmpty() ) {
-            for ( const auto& part : w_raw.split( ';', Qt::SkipEmptyParts ) ) {
-                data.wrong_answers.push_back( part.toStdString() );
-            }
-        }
-        cards.emplace_back( data );
+    while ( query.next() ) {
+        cards.push_back( readScheduledCard( query ) );
     }
     return cards;
 }
 
+// counts new, learning and mastered cards of a set in a single aggregate query
 SetStats DatabaseManager::getSetStatistics( int set_id ) const {
     SetStats stats;
-    vector<Card> cards = getCardsForSet( set_id );
-    stats.total = cards.size();
 
     QSqlQuery query( database_ );
-    query.prepare( "SELECT interval FROM learning_progress WHERE card_id = :cid" );
+    query.prepare( Queries::SET_STATISTICS );
+    query.bindValue( ":id", set_id );
 
-    for ( const auto& card : cards ) {
-        query.bindValue( ":cid", card.getId() );
+    if ( query.exec() && query.next() ) {
+        stats.total = query.value( 0 ).toInt();
+        stats.new_cards = query.value( 1 ).toInt();
+        stats.learning = query.value( 2 ).toInt();
+        stats.mastered = query.value( 3 ).toInt();
+    } else {
+        qCritical() << "Error computing set statistics:" << query.lastError().text();
+    }
+    return stats;
+}
 
-        int interval = 0;
-        if ( query.exec() && query.next() ) {
-            interval = query.value( 0 ).toInt();
-        }
-        if ( interval == 0 ) {
-            stats.new_cards++;
-        } else if ( interval < 21 ) {
-            stats.learning++;
-        } else {
-            stats.mastered++;
+// insert query for a deck and its paths: the parent's ancestors one level further, plus itself
+optional<int> DatabaseManager::createDeck( const string& name, int parent_id ) {
+    if ( name.empty() ) return nullopt;
+    if ( parent_id >= 0 && !getDeck( parent_id ) ) return nullopt;
+    if ( !beginWriteTransaction() ) return nullopt;
+
+    QSqlQuery query;
+    query.prepare( Queries::INSERT_DECK );
+    query.bindValue( ":name", QString::fromStdString( name ) );
+    query.bindValue( ":parent", deckKey( parent_id ) );
+    if ( !query.exec() ) {
+        qCritical() << "Could not add deck:" << query.lastError().text();
+        database_.rollback();
+        return nullopt;
+    }
+    int deck_id = query.lastInsertId().toInt();
+
+    query.prepare( Queries::INSERT_DECK_PATHS );
+    query.bindValue( ":id", deck_id );
+    query.bindValue( ":parent", deckKey( parent_id ) );
+    if ( !query.exec() ) {
+        qCritical() << "Could not add deck paths:" << query.lastError().text();
+        database_.rollback();
+        return nullopt;
+    }
+
+    if ( !database_.commit() ) return nullopt;
+    return deck_id;
+}
+
+// re-links the whole subtree under the new parent: the paths to the old ancestors are replaced by
+// paths to the new ones and the subtree totals move along, nothing below the deck is touched
+bool DatabaseManager::moveDeck( int deck_id, int new_parent_id ) {
+    optional<Deck> deck = getDeck( deck_id );
+    if ( !deck ) return false;
+    if ( deck->parent_id == new_parent_id ) return true;
+    if ( new_parent_id >= 0 && !getDeck( new_parent_id ) ) return false;
+
+    QSqlQuery query;
+    // a deck cannot become a child of itself or of one of its descendants
+    if ( new_parent_id >= 0 ) {
+        query.prepare( Queries::IS_DECK_DESCENDANT );
+        query.bindValue( ":id", deck_id );
+        query.bindValue( ":descendant", new_parent_id );
+        if ( !query.exec() || query.next() ) return false;
+    }
+
+    if ( !beginWriteTransaction() ) return false;
+
+    auto add_to_ancestors = [&]( int parent_id, int sign ) {
+        query.prepare( Queries::ADD_TO_DECK_ANCESTORS );
+        query.bindValue( ":cards", sign * deck->card_count );
+        query.bindValue( ":due", sign * deck->due_count );
+        query.bindValue( ":mastered", sign * deck->mastered_count );
+        query.bindValue( ":id", deckKey( parent_id ) );
+        return query.exec();
+    };
+    auto relink = [&]( const char* sql ) {
+        query.prepare( sql );
+        query.bindValue( ":id", deck_id );
+        query.bindValue( ":parent", deckKey( new_parent_id ) );
+        return query.exec();
+    };
+
+    if ( !add_to_ancestors( deck->parent_id, -1 ) || !relink( Queries::DETACH_DECK_SUBTREE ) ||
+         !relink( Queries::ATTACH_DECK_SUBTREE ) || !add_to_ancestors( new_parent_id, 1 ) ||
+         !relink( Queries::SET_DECK_PARENT ) ) {
+        qCritical() << "Could not move deck:" << deck_id << query.lastError().text();
+        database_.rollback();
+        return false;
+    }
+    return database_.commit();
+}
+
+// delete query for an empty deck, sets and nested decks have to be moved out first
+bool DatabaseManager::deleteDeck( int deck_id ) {
+    QSqlQuery query;
+    query.prepare( Queries::DECK_CONTENT_COUNT );
+    query.bindValue( ":id", deck_id );
+    if ( !query.exec() || !query.next() || query.value( 0 ).toInt() > 0 ) return false;
+
+    if ( !beginWriteTransaction() ) return false;
+    for ( const char* sql : { Queries::DELETE_DECK_PATHS, Queries::DELETE_DECK } ) {
+        query.prepare( sql );
+        query.bindValue( ":id", deck_id );
+        if ( !query.exec() ) {
+            qCritical() << "Could not delete deck:" << deck_id << query.lastError().text();
+            database_.rollback();
+            return false;
         }
     }
+    if ( query.numRowsAffected() == 0 ) {
+        database_.rollback();
+        return false;
+    }
+    return database_.commit();
+}
 
-    return stats;
-}
\ No newline at end of file
+// update query for the deck of a set, triggers move the set's counters between the ancestors
+bool DatabaseManager::assignSetToDeck( int set_id, int deck_id ) {
+    if ( deck_id >= 0 && !getDeck( deck_id ) ) return false;
+
+    QSqlQuery query;
+    query.prepare( Queries::ASSIGN_SET_DECK );
+    query.bindValue( ":deck", deckKey( deck_id ) );
+    query.bindValue( ":id", set_id );
+    if ( !query.exec() ) {
+        qCritical() << "Could not assign set" << set_id << "to deck:" << query.lastError().text();
+        return false;
+    }
+    return query.numRowsAffected() > 0;
+}
+
+// select query for a single deck, its counters already cover the whole subtree
+optional<Deck> DatabaseManager::getDeck( int deck_id ) const {
+    QSqlQuery query;
+    query.prepare( Queries::DECK_BY_ID );
+    query.bindValue( ":id", deck_id );
+
+    if ( query.exec() && query.next() ) return readDeck( query );
+    return nullopt;
+}
+
+// select query for the direct children of a deck, or the top level decks for -1
+vector<Deck> DatabaseManager::getChildDecks( int parent_id ) const {
+    vector<Deck> decks;
+    QSqlQuery query;
+    query.prepare( Queries::CHILD_DECKS );
+    query.bindValue( ":parent", deckKey( parent_id ) );
+    if ( !query.exec() ) {
+        qCritical() << "Error fetching child decks:" << query.lastError().text();
+        return decks;
+    }
+    while ( query.next() ) {
+        decks.push_back( readDeck( query ) );
+    }
+    return decks;
+}
+
+// select query for due cards of every set in the deck and in its nested decks
+vector<Card> DatabaseManager::getDueCardsForDeck( int deck_id, int limit ) const {
+    return getCardsWithQuery( Queries::DUE_CARDS_OF_DECK, deck_id, limit );
+}
+
+int DatabaseManager::subscribe( ChangeListener listener ) {
+    int id = next_subscription_id_++;
+    listeners_.emplace( id, std::move( listener ) );
+    return id;
+}
+
+void DatabaseManager::unsubscribe( int subscription_id ) { listeners_.erase( subscription_id ); }
+
+// listeners may unsubscribe while being notified, so ids are collected first
+void DatabaseManager::notify( const DatabaseChange& change ) const {
+    if ( notifications_muted_ ) return;
+
+    vector<int> ids;
+    ids.reserve( listeners_.size() );
+    for ( const auto& [id, listener] : listeners_ ) ids.push_back( id );
+
+    for ( int id : ids ) {
+        auto it = listeners_.find( id );
+        if ( it != listeners_.end() ) it->second( change );
+    }
+}
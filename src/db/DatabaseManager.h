@@ -8,9 +8,20 @@
 #include <vector>
 #include <optional>
 #include <tuple>
+#include <functional>
+#include <map>
 
 #include "../core/learning/Card.h"
+#include "../core/learning/CardStore.h"
+#include "../core/learning/Deck.h"
+#include "../core/learning/FsrsOptimizer.h"
+#include "../core/learning/ScheduledCard.h"
 #include "../core/learning/StudySet.h"
+#include "../core/learning/SuperMemo.h"
+#include "../core/learning/WorkloadForecaster.h"
+#include "../core/utils/MediaProbe.h"
+
+class QSqlQuery;
 
 struct SetStats {
     int total = 0;
@@ -19,6 +30,41 @@ struct SetStats {
     int mastered = 0;
 };
 
+// list row data of a card, without answers and with a truncated question
+struct CardSummary {
+    int id = 0;
+    MediaType media_type = MediaType::TEXT;
+    std::string question;
+};
+
+// position in a set's due queue after the last card read; the default one is before the first
+struct DueCursor {
+    std::string review_date;  // empty for new cards, which come first
+    int card_id = 0;
+};
+
+// orders of the paginated set list
+enum class SetSort { NEWEST, NAME, RECENT_ACTIVITY, DUE_COUNT };
+
+// EXTERNAL means another process wrote to the database file, so any loaded data may be stale
+enum class ChangeType {
+    CARD_ADDED,
+    CARD_DELETED,
+    PROGRESS_CHANGED,
+    SET_ADDED,
+    SET_DELETED,
+    EXTERNAL
+};
+
+// card_id is -1 when the change concerns a whole set, set_id is -1 when it is not known
+struct DatabaseChange {
+    ChangeType type;
+    int set_id = -1;
+    int card_id = -1;
+};
+
+using ChangeListener = std::function<void( const DatabaseChange& )>;
+
 class DatabaseManager {
 public:
     explicit DatabaseManager( const QString& db_name = "learning_app.db" );
@@ -31,29 +77,97 @@ public:
 
     std::vector<StudySet> getAllSets() const;
     std::optional<StudySet> getSet( int set_id ) const;
+    // keyset pagination, pass the last set of the previous page to get the next one
+    std::vector<StudySet> getSetsPage( SetSort sort, int limit,
+                                       const std::optional<StudySet>& after = std::nullopt ) const;
     std::vector<Card> getCardsForSet( int set_id ) const;
+    // the whole set in compact form, strings shared between cards are stored once
+    CardStore getCardStore( int set_id ) const;
+    std::optional<Card> getCard( int card_id ) const;
+    std::vector<CardSummary> getCardSummaries( int set_id, int offset, int limit ) const;
     std::vector<Card> getRandomCards( int set_id, int limit ) const;
     std::vector<Card> getDueCards( int set_id, int limit ) const;
+    std::vector<ScheduledCard> getRandomScheduledCards( int set_id, int limit ) const;
+    std::vector<ScheduledCard> getDueScheduledCards( int set_id, int limit ) const;
+    std::vector<ScheduledCard> getDueScheduledPage( int set_id, DueCursor& after,
+                                                    int limit ) const;
+    int getDueCount( int set_id ) const;
+    std::vector<int> getCardIds( int set_id ) const;
+    std::vector<ScheduledCard> getScheduledCards( const std::vector<int>& card_ids ) const;
+    int getCardCount( int set_id ) const;
     std::tuple<int, int, float> getCardProgress( int card_id ) const;
     QString getImagesPath() const;
     QString getSoundsPath() const;
+    QString getMediaRoot() const;
+    std::optional<MediaInfo> getMediaInfo( const std::string& rel_path ) const;
 
     bool createSet( const std::string& set_name, const std::vector<DraftCard>& cards );
     bool deleteSet( int set_id );
     bool addCardToSet( int set_id, const DraftCard& card );
     bool deleteCard( int card_id );
+    bool catalogMedia( const std::string& rel_path );
 
     bool updateCardProgress( int card_id, int interval, int repetitions, float easiness,
                              const std::string& next_date );
+    // stores the new SM-2 and FSRS state of a card and logs the review in one transaction,
+    // elapsed_days is -1 for a card that had no progress
+    bool saveReview( int card_id, int grade, int elapsed_days, const SuperMemoState& state,
+                     const FsrsState& memory );
+    // all logged reviews with grades mapped to FSRS ratings, as FsrsOptimizer expects them
+    std::vector<ReviewRecord> getReviewHistory() const;
+    // the same, read on a connection of its own, so it can be called from any thread
+    std::vector<ReviewRecord> getReviewHistoryDetached() const;
+    std::optional<Fsrs::Weights> getFsrsWeights() const;
+    bool saveFsrsWeights( const Fsrs::Weights& weights );
+    // SM-2 state of every card in the sets, new cards start from the initial state due today
+    ProgressColumns getProgressColumns( const std::vector<int>& set_ids ) const;
     bool resetSetProgress( int set_id );
+    int resetSetProgressBatch( int set_id, int& after_card_id, int batch_size );
+    // announces a batched reset once it stops, finished or not, the batches themselves do not
+    void endProgressReset( int set_id );
     static std::string calculateNextDate( int days_from_now );
+    bool refreshDueCounts();
 
     SetStats getSetStatistics( int set_id ) const;
 
+    // decks nest to any depth, a parent_id or deck_id of -1 means the top level / no deck
+    std::optional<int> createDeck( const std::string& name, int parent_id = -1 );
+    bool moveDeck( int deck_id, int new_parent_id );
+    bool deleteDeck( int deck_id );
+    bool assignSetToDeck( int set_id, int deck_id );
+    std::optional<Deck> getDeck( int deck_id ) const;
+    std::vector<Deck> getChildDecks( int parent_id ) const;
+    std::vector<Card> getDueCardsForDeck( int deck_id, int limit ) const;
+
+    int subscribe( ChangeListener listener );
+    void unsubscribe( int subscription_id );
+    // text of new cards longer than COMPRESSION_THRESHOLD bytes is stored zlib compressed
+    void setTextCompression( bool enabled ) { text_compression_ = enabled; }
+
+    // notifies EXTERNAL and returns true when another connection committed since the last call
+    bool pollExternalChanges();
+
+    static constexpr int SCHEMA_VERSION = 9;
+    static constexpr int SUMMARY_QUESTION_LENGTH = 120;
+    static constexpr int COMPRESSION_THRESHOLD = 256;
+    static constexpr int BUSY_TIMEOUT_MS = 2000;
+
 private:
     QSqlDatabase database_;
     QString db_name_;
     QString data_path_;
 
+    std::map<int, ChangeListener> listeners_;
+    int next_subscription_id_ = 1;
+    bool notifications_muted_ = false;
+    qint64 data_version_ = -1;
+    bool text_compression_ = true;
+
+    bool migrateSchema();
+    bool finishMigration( QSqlQuery& query, int to_version, bool step_ok );
+    bool beginWriteTransaction();
+    void notify( const DatabaseChange& change ) const;
     std::vector<Card> getCardsWithQuery( const QString& query_str, int set_id, int limit ) const;
+    std::vector<ScheduledCard> getScheduledCardsWithQuery( const QString& query_str, int set_id,
+                                                           int limit ) const;
 };
\ No newline at end of file
@@ -0,0 +1,45 @@
+/*
+ * @authors: Jakub Jurczak, Mateusz Woźniak
+ * summary: Class ProgressResetJob, resets learning progress of a set in small batches - source
+ * file.
+ */
+#include "ProgressResetJob.h"
+
+ProgressResetJob::ProgressResetJob( DatabaseManager& db, int set_id, int batch_size )
+    : db_( db ), set_id_( set_id ), batch_size_( batch_size ) {
+    total_ = db_.getCardCount( set_id_ );
+}
+
+// every batch is its own short transaction, so the write lock is released between steps
+bool ProgressResetJob::step() {
+    if ( finished_ || cancelled_ || failed_ ) return false;
+
+    int covered = db_.resetSetProgressBatch( set_id_, after_card_id_, batch_size_ );
+    if ( covered < 0 ) {
+        failed_ = true;
+        if ( processed_ > 0 ) db_.endProgressReset( set_id_ );
+        return false;
+    }
+    if ( covered == 0 ) {
+        finished_ = true;
+        processed_ = total_;
+        db_.endProgressReset( set_id_ );
+        return false;
+    }
+
+    processed_ += covered;
+    return true;
+}
+
+// the batches already committed stay reset, so views are told about them right away
+void ProgressResetJob::cancel() {
+    if ( finished_ || cancelled_ || failed_ ) return;
+    cancelled_ = true;
+    if ( processed_ > 0 ) db_.endProgressReset( set_id_ );
+}
+
+float ProgressResetJob::progress() const {
+    if ( finished_ || total_ == 0 ) return 1.0f;
+    float ratio = static_cast<float>( processed_ ) / total_;
+    return ratio > 1.0f ? 1.0f : ratio;
+}
@@ -0,0 +1,36 @@
+/*
+ * @authors: Jakub Jurczak, Mateusz Woźniak
+ * summary: Class ProgressResetJob, resets learning progress of a set in small batches - header
+ * file.
+ */
+#pragma once
+#include "DatabaseManager.h"
+
+class ProgressResetJob {
+public:
+    static constexpr int DEFAULT_BATCH_SIZE = 1000;
+
+    ProgressResetJob( DatabaseManager& db, int set_id, int batch_size = DEFAULT_BATCH_SIZE );
+
+    // resets one batch, returns true while there is work left
+    bool step();
+    void cancel();
+
+    bool isFinished() const { return finished_; }
+    bool isCancelled() const { return cancelled_; }
+    bool hasFailed() const { return failed_; }
+    int processedCards() const { return processed_; }
+    int totalCards() const { return total_; }
+    float progress() const;
+
+private:
+    DatabaseManager& db_;
+    int set_id_;
+    int batch_size_;
+    int after_card_id_ = 0;
+    int processed_ = 0;
+    int total_ = 0;
+    bool finished_ = false;
+    bool cancelled_ = false;
+    bool failed_ = false;
+};
@@ -0,0 +1,378 @@
+/*
+ * @authors: Jakub Jurczak, Mateusz Woźniak
+ * summary: SQL statements issued by DatabaseManager, kept in one place so that their query plans
+ * can be checked by tests.
+ */
+#pragma once
+
+namespace Queries {
+
+// sets
+inline constexpr const char* ALL_SETS =
+    "SELECT id, name, last_activity, due_count, card_count FROM sets ORDER BY id DESC";
+inline constexpr const char* SET_BY_ID = R"(
+    SELECT id, name, last_activity, due_count, card_count FROM sets WHERE id = :id
+)";
+inline constexpr const char* INSERT_SET = "INSERT INTO sets (name) VALUES (:name)";
+inline constexpr const char* DELETE_SET = "DELETE FROM sets WHERE id = :id";
+
+// keyset pages of sets, :key and :id come from the last row of the previous page
+inline constexpr const char* SETS_PAGE_NEWEST =
+    "SELECT id, name, last_activity, due_count, card_count FROM sets "
+    "WHERE id < :id ORDER BY id DESC LIMIT :limit";
+inline constexpr const char* SETS_PAGE_NAME =
+    "SELECT id, name, last_activity, due_count, card_count FROM sets "
+    "WHERE name COLLATE NOCASE > :key OR (name COLLATE NOCASE = :key AND id > :id) "
+    "ORDER BY name COLLATE NOCASE, id LIMIT :limit";
+inline constexpr const char* SETS_PAGE_ACTIVITY =
+    "SELECT id, name, last_activity, due_count, card_count FROM sets "
+    "WHERE last_activity < :key OR (last_activity = :key AND id < :id) "
+    "ORDER BY last_activity DESC, id DESC LIMIT :limit";
+inline constexpr const char* SETS_PAGE_DUE =
+    "SELECT id, name, last_activity, due_count, card_count FROM sets "
+    "WHERE due_count < :key OR (due_count = :key AND id < :id) "
+    "ORDER BY due_count DESC, id DESC LIMIT :limit";
+
+// due counters, kept by triggers and moved forward once a day
+inline constexpr const char* DUE_COUNTED_ON =
+    "SELECT value FROM app_meta WHERE key = 'due_counted_on'";
+inline constexpr const char* SAVE_DUE_COUNTED_ON =
+    "INSERT OR REPLACE INTO app_meta (key, value) VALUES ('due_counted_on', :today)";
+inline constexpr const char* RECOUNT_DUE = R"(
+    UPDATE sets SET due_count = (
+        SELECT COUNT(*) FROM cards c
+        LEFT JOIN learning_progress lp ON c.id = lp.card_id
+        WHERE c.set_id = sets.id
+          AND (lp.next_review_date IS NULL OR lp.next_review_date <= :today))
+)";
+inline constexpr const char* ADD_NEWLY_DUE = R"(
+    UPDATE sets SET due_count = due_count + newly.count
+    FROM (SELECT c.set_id, COUNT(*) AS count
+          FROM learning_progress lp JOIN cards c ON c.id = lp.card_id
+          WHERE lp.next_review_date > :since AND lp.next_review_date <= :today
+          GROUP BY c.set_id) AS newly
+    WHERE sets.id = newly.set_id
+)";
+
+// cards
+inline constexpr const char* CARDS_OF_SET =
+    "SELECT id, set_id, question, correct_answer, wrong_answers, accepted_answers, answer_type, "
+    "media_type "
+    "FROM cards WHERE set_id = :id";
+inline constexpr const char* CARD_BY_ID =
+    "SELECT id, set_id, question, correct_answer, wrong_answers, accepted_answers, answer_type, "
+    "media_type "
+    "FROM cards WHERE id = :id";
+inline constexpr const char* CARD_SUMMARIES = R"(
+    SELECT id, media_type,
+           CASE WHEN media_type <> 0 THEN NULL
+                WHEN typeof(question) = 'blob' THEN question
+                ELSE substr(question, 1, :len) END
+    FROM cards
+    WHERE set_id = :id
+    ORDER BY id
+    LIMIT :limit OFFSET :offset
+)";
+inline constexpr const char* RANDOM_CARDS =
+    "SELECT id, set_id, question, correct_answer, wrong_answers, accepted_answers, answer_type, "
+    "media_type "
+    "FROM cards WHERE set_id = :id ORDER BY RANDOM() LIMIT :limit";
+inline constexpr const char* DUE_CARDS = R"(
+    SELECT c.id, c.set_id, c.question, c.correct_answer, c.wrong_answers, c.accepted_answers,
+           c.answer_type, c.media_type
+    FROM cards c
+    LEFT JOIN learning_progress lp ON c.id = lp.card_id
+    WHERE c.set_id = :id
+      AND (lp.next_review_date IS NULL OR lp.next_review_date <= date('now', 'localtime'))
+    ORDER BY lp.next_review_date ASC
+    LIMIT :limit
+)";
+// the same selections joined with the SM-2 state, so a session can grade without reading it
+inline constexpr const char* RANDOM_CARDS_SCHEDULED = R"(
+    SELECT c.id, c.set_id, c.question, c.correct_answer, c.wrong_answers, c.accepted_answers,
+           c.answer_type, c.media_type,
+           lp.interval, lp.repetitions, lp.easiness_factor, lp.stability, lp.difficulty,
+           lp.interval + CAST(julianday(date('now', 'localtime')) - julianday(lp.next_review_date)
+                              AS INTEGER) AS elapsed_days
+    FROM cards c
+    LEFT JOIN learning_progress lp ON c.id = lp.card_id
+    WHERE c.set_id = :id
+    ORDER BY RANDOM()
+    LIMIT :limit
+)";
+inline constexpr const char* DUE_CARDS_SCHEDULED = R"(
+    SELECT c.id, c.set_id, c.question, c.correct_answer, c.wrong_answers, c.accepted_answers,
+           c.answer_type, c.media_type,
+           lp.interval, lp.repetitions, lp.easiness_factor, lp.stability, lp.difficulty,
+           lp.interval + CAST(julianday(date('now', 'localtime')) - julianday(lp.next_review_date)
+                              AS INTEGER) AS elapsed_days
+    FROM cards c
+    LEFT JOIN learning_progress lp ON c.id = lp.card_id
+    WHERE c.set_id = :id
+      AND (lp.next_review_date IS NULL OR lp.next_review_date <= date('now', 'localtime'))
+    ORDER BY lp.next_review_date ASC
+    LIMIT :limit
+)";
+// keyset pages of the due queue, which holds the new cards by id and then the reviewed ones by
+// date and id; both walk an index in queue order and stop at the limit, and cards graded
+// meanwhile leave the queue without shifting the pages after them
+inline constexpr const char* DUE_NEW_CARDS_PAGE = R"(
+    SELECT c.id, c.set_id, c.question, c.correct_answer, c.wrong_answers, c.accepted_answers,
+           c.answer_type, c.media_type,
+           lp.interval, lp.repetitions, lp.easiness_factor, lp.stability, lp.difficulty,
+           NULL AS elapsed_days
+    FROM cards c
+    LEFT JOIN learning_progress lp ON c.id = lp.card_id
+    WHERE c.set_id = :id AND c.id > :after_id AND lp.next_review_date IS NULL
+    ORDER BY c.id
+    LIMIT :limit
+)";
+// the due dates of the set are walked from the cursor on, so a whole session reads them once
+inline constexpr const char* DUE_REVIEWS_PAGE = R"(
+    SELECT c.id, c.set_id, c.question, c.correct_answer, c.wrong_answers, c.accepted_answers,
+           c.answer_type, c.media_type,
+           lp.interval, lp.repetitions, lp.easiness_factor, lp.stability, lp.difficulty,
+           lp.interval + CAST(julianday(date('now', 'localtime')) - julianday(lp.next_review_date)
+                              AS INTEGER) AS elapsed_days,
+           lp.next_review_date AS review_date
+    FROM learning_progress lp
+    CROSS JOIN cards c ON c.id = lp.card_id
+    WHERE lp.set_id = :id
+      AND lp.next_review_date >= :after_date
+      AND lp.next_review_date <= date('now', 'localtime')
+      AND (lp.next_review_date > :after_date OR lp.card_id > :after_id)
+    ORDER BY lp.next_review_date, lp.card_id
+    LIMIT :limit
+)";
+inline constexpr const char* DUE_COUNT_OF_SET = R"(
+    SELECT COUNT(*)
+    FROM cards c
+    LEFT JOIN learning_progress lp ON c.id = lp.card_id
+    WHERE c.set_id = :id
+      AND (lp.next_review_date IS NULL OR lp.next_review_date <= date('now', 'localtime'))
+)";
+inline constexpr const char* SCHEDULED_CARD_BY_ID = R"(
+    SELECT c.id, c.set_id, c.question, c.correct_answer, c.wrong_answers, c.accepted_answers,
+           c.answer_type, c.media_type,
+           lp.interval, lp.repetitions, lp.easiness_factor, lp.stability, lp.difficulty,
+           lp.interval + CAST(julianday(date('now', 'localtime')) - julianday(lp.next_review_date)
+                              AS INTEGER) AS elapsed_days
+    FROM cards c
+    LEFT JOIN learning_progress lp ON c.id = lp.card_id
+    WHERE c.id = :id
+)";
+inline constexpr const char* CARD_IDS_OF_SET = "SELECT id FROM cards WHERE set_id = :id";
+inline constexpr const char* CARD_COUNT = "SELECT COUNT(*) FROM cards WHERE set_id = :id";
+inline constexpr const char* QUESTIONS_OF_SET = "SELECT question FROM cards WHERE set_id = :id";
+inline constexpr const char* QUESTION_OF_CARD =
+    "SELECT question, set_id FROM cards WHERE id = :id";
+inline constexpr const char* INSERT_CARD =
+    "INSERT INTO cards (set_id, question, correct_answer, wrong_answers, accepted_answers, "
+    "answer_type, media_type) "
+    "VALUES (:set_id, :question, :correct, :wrong, :accepted, :ans_type, :media_type)";
+inline constexpr const char* DELETE_CARD = "DELETE FROM cards WHERE id = :id";
+inline constexpr const char* DELETE_CARDS_OF_SET = "DELETE FROM cards WHERE set_id = :id";
+
+// learning progress
+inline constexpr const char* CARD_PROGRESS =
+    "SELECT interval, repetitions, easiness_factor FROM learning_progress WHERE card_id = :id";
+// SM-2 state of a whole set for the workload forecast, NULLs for cards never reviewed
+inline constexpr const char* PROGRESS_OF_SET = R"(
+    SELECT lp.interval, lp.repetitions, lp.easiness_factor,
+           CAST(julianday(lp.next_review_date) - julianday(date('now', 'localtime')) AS INTEGER)
+    FROM cards c
+    LEFT JOIN learning_progress lp ON c.id = lp.card_id
+    WHERE c.set_id = :id
+)";
+inline constexpr const char* SAVE_PROGRESS = R"(
+    INSERT INTO learning_progress (card_id, set_id, interval, repetitions, easiness_factor,
+                                   next_review_date)
+    VALUES (:id, (SELECT set_id FROM cards WHERE id = :id), :iv, :rep, :ef, :date)
+    ON CONFLICT(card_id) DO UPDATE SET
+        interval = excluded.interval,
+        repetitions = excluded.repetitions,
+        easiness_factor = excluded.easiness_factor,
+        next_review_date = excluded.next_review_date
+)";
+// progress of one review, written by the learning session; setting last_grade makes the
+// progress triggers add the review_log row
+inline constexpr const char* SAVE_REVIEW_PROGRESS = R"(
+    INSERT INTO learning_progress (card_id, set_id, interval, repetitions, easiness_factor,
+                                   stability, difficulty, next_review_date, last_grade,
+                                   last_elapsed_days)
+    VALUES (:id, (SELECT set_id FROM cards WHERE id = :id), :iv, :rep, :ef, :stability,
+            :difficulty, date('now', 'localtime', :offset), :grade, :elapsed)
+    ON CONFLICT(card_id) DO UPDATE SET
+        interval = excluded.interval,
+        repetitions = excluded.repetitions,
+        easiness_factor = excluded.easiness_factor,
+        stability = excluded.stability,
+        difficulty = excluded.difficulty,
+        next_review_date = excluded.next_review_date,
+        last_grade = excluded.last_grade,
+        last_elapsed_days = excluded.last_elapsed_days
+)";
+// every review, grouped by card in the order they happened
+inline constexpr const char* REVIEW_HISTORY =
+    "SELECT card_id, grade, elapsed_days FROM review_log ORDER BY card_id, id";
+inline constexpr const char* FSRS_WEIGHTS =
+    "SELECT value FROM app_meta WHERE key = 'fsrs_weights'";
+inline constexpr const char* SAVE_FSRS_WEIGHTS =
+    "INSERT OR REPLACE INTO app_meta (key, value) VALUES ('fsrs_weights', :weights)";
+inline constexpr const char* DELETE_PROGRESS_OF_SET =
+    "DELETE FROM learning_progress WHERE card_id IN (SELECT id FROM cards WHERE set_id = :id)";
+inline constexpr const char* RESET_BATCH_RANGE =
+    "SELECT COUNT(*), MAX(id) FROM (SELECT id FROM cards WHERE set_id = :id AND id > :after "
+    "ORDER BY id LIMIT :limit)";
+inline constexpr const char* RESET_BATCH_DELETE =
+    "DELETE FROM learning_progress WHERE card_id IN (SELECT id FROM cards WHERE set_id = :id "
+    "AND id > :after AND id <= :upto)";
+inline constexpr const char* SET_STATISTICS = R"(
+    SELECT COUNT(*),
+           SUM(CASE WHEN IFNULL(lp.interval, 0) = 0 THEN 1 ELSE 0 END),
+           SUM(CASE WHEN lp.interval <> 0 AND lp.interval < 21 THEN 1 ELSE 0 END),
+           SUM(CASE WHEN lp.interval >= 21 THEN 1 ELSE 0 END)
+    FROM cards c
+    LEFT JOIN learning_progress lp ON c.id = lp.card_id
+    WHERE c.set_id = :id
+)";
+
+// media catalog
+inline constexpr const char* MEDIA_BY_PATH =
+    "SELECT path, hash, byte_size, width, height, duration_ms, thumbnail FROM media "
+    "WHERE path = :path";
+inline constexpr const char* SAVE_MEDIA = R"(
+    INSERT OR REPLACE INTO media (path, hash, byte_size, width, height, duration_ms, thumbnail)
+    VALUES (:path, :hash, :size, :width, :height, :duration, :thumbnail)
+)";
+inline constexpr const char* DELETE_MEDIA = "DELETE FROM media WHERE path = :path";
+inline constexpr const char* DELETE_MEDIA_OF_SET =
+    "DELETE FROM media WHERE path IN (SELECT question FROM cards WHERE set_id = :id "
+    "AND media_type <> 0)";
+
+// deck hierarchy, deck_closure lists every ancestor of a deck including the deck itself
+inline constexpr const char* DECK_BY_ID =
+    "SELECT id, name, parent_id, card_count, due_count, mastered_count FROM decks WHERE id = :id";
+inline constexpr const char* CHILD_DECKS =
+    "SELECT id, name, parent_id, card_count, due_count, mastered_count FROM decks "
+    "WHERE parent_id IS :parent ORDER BY name COLLATE NOCASE, id";
+inline constexpr const char* INSERT_DECK =
+    "INSERT INTO decks (name, parent_id) VALUES (:name, :parent)";
+inline constexpr const char* INSERT_DECK_PATHS = R"(
+    INSERT INTO deck_closure (ancestor_id, descendant_id, depth)
+    SELECT ancestor_id, :id, depth + 1 FROM deck_closure WHERE descendant_id = :parent
+    UNION ALL SELECT :id, :id, 0
+)";
+inline constexpr const char* IS_DECK_DESCENDANT =
+    "SELECT 1 FROM deck_closure WHERE ancestor_id = :id AND descendant_id = :descendant";
+inline constexpr const char* ADD_TO_DECK_ANCESTORS = R"(
+    UPDATE decks SET card_count = card_count + :cards,
+                     due_count = due_count + :due,
+                     mastered_count = mastered_count + :mastered
+    FROM deck_closure dc
+    WHERE dc.descendant_id = :id AND decks.id = dc.ancestor_id
+)";
+inline constexpr const char* DETACH_DECK_SUBTREE = R"(
+    DELETE FROM deck_closure
+    WHERE descendant_id IN (SELECT descendant_id FROM deck_closure WHERE ancestor_id = :id)
+      AND ancestor_id IN (SELECT ancestor_id FROM deck_closure
+                          WHERE descendant_id = :id AND ancestor_id <> :id)
+)";
+inline constexpr const char* ATTACH_DECK_SUBTREE = R"(
+    INSERT INTO deck_closure (ancestor_id, descendant_id, depth)
+    SELECT p.ancestor_id, s.descendant_id, p.depth + s.depth + 1
+    FROM deck_closure p, deck_closure s
+    WHERE p.descendant_id = :parent AND s.ancestor_id = :id
+)";
+inline constexpr const char* SET_DECK_PARENT =
+    "UPDATE decks SET parent_id = :parent WHERE id = :id";
+inline constexpr const char* DECK_CONTENT_COUNT =
+    "SELECT (SELECT COUNT(*) FROM decks WHERE parent_id = :id) + "
+    "(SELECT COUNT(*) FROM sets WHERE deck_id = :id)";
+inline constexpr const char* DELETE_DECK_PATHS =
+    "DELETE FROM deck_closure WHERE descendant_id = :id";
+inline constexpr const char* DELETE_DECK = "DELETE FROM decks WHERE id = :id";
+inline constexpr const char* ASSIGN_SET_DECK = "UPDATE sets SET deck_id = :deck WHERE id = :id";
+inline constexpr const char* DUE_CARDS_OF_DECK = R"(
+    SELECT c.id, c.set_id, c.question, c.correct_answer, c.wrong_answers, c.accepted_answers,
+           c.answer_type, c.media_type
+    FROM deck_closure dc
+    JOIN sets s ON s.deck_id = dc.descendant_id
+    JOIN cards c ON c.set_id = s.id
+    LEFT JOIN learning_progress lp ON c.id = lp.card_id
+    WHERE dc.ancestor_id = :id
+      AND (lp.next_review_date IS NULL OR lp.next_review_date <= date('now', 'localtime'))
+    ORDER BY lp.next_review_date ASC
+    LIMIT :limit
+)";
+
+struct NamedQuery {
+    const char* name;
+    const char* sql;
+    const char* full_scan;  // the one table the statement reads whole by design, or nullptr
+};
+
+// every statement above must be listed here, QueryPlanTests explains each of them
+inline constexpr NamedQuery ALL[] = {
+    { "ALL_SETS", ALL_SETS, "sets" },
+    { "SET_BY_ID", SET_BY_ID, nullptr },
+    { "INSERT_SET", INSERT_SET, nullptr },
+    { "DELETE_SET", DELETE_SET, nullptr },
+    { "SETS_PAGE_NEWEST", SETS_PAGE_NEWEST, nullptr },
+    { "SETS_PAGE_NAME", SETS_PAGE_NAME, nullptr },
+    { "SETS_PAGE_ACTIVITY", SETS_PAGE_ACTIVITY, nullptr },
+    { "SETS_PAGE_DUE", SETS_PAGE_DUE, nullptr },
+    { "DUE_COUNTED_ON", DUE_COUNTED_ON, nullptr },
+    { "SAVE_DUE_COUNTED_ON", SAVE_DUE_COUNTED_ON, nullptr },
+    { "RECOUNT_DUE", RECOUNT_DUE, "sets" },
+    { "ADD_NEWLY_DUE", ADD_NEWLY_DUE, nullptr },
+    { "CARDS_OF_SET", CARDS_OF_SET, nullptr },
+    { "CARD_BY_ID", CARD_BY_ID, nullptr },
+    { "CARD_SUMMARIES", CARD_SUMMARIES, nullptr },
+    { "RANDOM_CARDS", RANDOM_CARDS, nullptr },
+    { "DUE_CARDS", DUE_CARDS, nullptr },
+    { "RANDOM_CARDS_SCHEDULED", RANDOM_CARDS_SCHEDULED, nullptr },
+    { "DUE_CARDS_SCHEDULED", DUE_CARDS_SCHEDULED, nullptr },
+    { "DUE_NEW_CARDS_PAGE", DUE_NEW_CARDS_PAGE, nullptr },
+    { "DUE_REVIEWS_PAGE", DUE_REVIEWS_PAGE, nullptr },
+    { "DUE_COUNT_OF_SET", DUE_COUNT_OF_SET, nullptr },
+    { "SCHEDULED_CARD_BY_ID", SCHEDULED_CARD_BY_ID, nullptr },
+    { "CARD_IDS_OF_SET", CARD_IDS_OF_SET, nullptr },
+    { "CARD_COUNT", CARD_COUNT, nullptr },
+    { "QUESTIONS_OF_SET", QUESTIONS_OF_SET, nullptr },
+    { "QUESTION_OF_CARD", QUESTION_OF_CARD, nullptr },
+    { "INSERT_CARD", INSERT_CARD, nullptr },
+    { "DELETE_CARD", DELETE_CARD, nullptr },
+    { "DELETE_CARDS_OF_SET", DELETE_CARDS_OF_SET, nullptr },
+    { "CARD_PROGRESS", CARD_PROGRESS, nullptr },
+    { "PROGRESS_OF_SET", PROGRESS_OF_SET, nullptr },
+    { "SAVE_PROGRESS", SAVE_PROGRESS, nullptr },
+    { "SAVE_REVIEW_PROGRESS", SAVE_REVIEW_PROGRESS, nullptr },
+    { "REVIEW_HISTORY", REVIEW_HISTORY, "review_log" },
+    { "FSRS_WEIGHTS", FSRS_WEIGHTS, nullptr },
+    { "SAVE_FSRS_WEIGHTS", SAVE_FSRS_WEIGHTS, nullptr },
+    { "DELETE_PROGRESS_OF_SET", DELETE_PROGRESS_OF_SET, nullptr },
+    { "RESET_BATCH_RANGE", RESET_BATCH_RANGE, nullptr },
+    { "RESET_BATCH_DELETE", RESET_BATCH_DELETE, nullptr },
+    { "SET_STATISTICS", SET_STATISTICS, nullptr },
+    { "MEDIA_BY_PATH", MEDIA_BY_PATH, nullptr },
+    { "SAVE_MEDIA", SAVE_MEDIA, nullptr },
+    { "DELETE_MEDIA", DELETE_MEDIA, nullptr },
+    { "DELETE_MEDIA_OF_SET", DELETE_MEDIA_OF_SET, nullptr },
+    { "DECK_BY_ID", DECK_BY_ID, nullptr },
+    { "CHILD_DECKS", CHILD_DECKS, nullptr },
+    { "INSERT_DECK", INSERT_DECK, nullptr },
+    { "INSERT_DECK_PATHS", INSERT_DECK_PATHS, nullptr },
+    { "IS_DECK_DESCENDANT", IS_DECK_DESCENDANT, nullptr },
+    { "ADD_TO_DECK_ANCESTORS", ADD_TO_DECK_ANCESTORS, nullptr },
+    { "DETACH_DECK_SUBTREE", DETACH_DECK_SUBTREE, nullptr },
+    { "ATTACH_DECK_SUBTREE", ATTACH_DECK_SUBTREE, nullptr },
+    { "SET_DECK_PARENT", SET_DECK_PARENT, nullptr },
+    { "DECK_CONTENT_COUNT", DECK_CONTENT_COUNT, nullptr },
+    { "DELETE_DECK_PATHS", DELETE_DECK_PATHS, nullptr },
+    { "DELETE_DECK", DELETE_DECK, nullptr },
+    { "ASSIGN_SET_DECK", ASSIGN_SET_DECK, nullptr },
+    { "DUE_CARDS_OF_DECK", DUE_CARDS_OF_DECK, nullptr },
+};
+
+}  // namespace Queries
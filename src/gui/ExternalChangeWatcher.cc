@@ -0,0 +1,34 @@
+/*
+ * @authors: Jakub Jurczak, Mateusz Woźniak
+ * summary: Class ExternalChangeWatcher, detects writes to the database made by other processes -
+ * source file.
+ */
+#include <QGuiApplication>
+
+#include "ExternalChangeWatcher.h"
+
+ExternalChangeWatcher::ExternalChangeWatcher( DatabaseManager& db, QObject* parent )
+    : QObject( parent ), db_( db ) {
+    poll_timer_.setInterval( POLL_INTERVAL_MS );
+    connect( &poll_timer_, &QTimer::timeout, this, &ExternalChangeWatcher::poll );
+}
+
+void ExternalChangeWatcher::start() {
+    connect( qGuiApp, &QGuiApplication::applicationStateChanged, this,
+             &ExternalChangeWatcher::onApplicationStateChanged );
+    poll_timer_.start();
+}
+
+// views subscribed to the database reload themselves when it reports an EXTERNAL change
+void ExternalChangeWatcher::poll() { db_.pollExternalChanges(); }
+
+// nothing is shown while the window is in the background, so the timer only runs when active
+// and coming back to the window checks right away
+void ExternalChangeWatcher::onApplicationStateChanged( Qt::ApplicationState state ) {
+    if ( state == Qt::ApplicationActive ) {
+        poll();
+        poll_timer_.start();
+    } else {
+        poll_timer_.stop();
+    }
+}
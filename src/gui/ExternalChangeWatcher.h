@@ -0,0 +1,28 @@
+/*
+ * @authors: Jakub Jurczak, Mateusz Woźniak
+ * summary: Class ExternalChangeWatcher, detects writes to the database made by other processes -
+ * header file.
+ */
+#pragma once
+#include <QObject>
+#include <QTimer>
+
+#include "../db/DatabaseManager.h"
+
+class ExternalChangeWatcher : public QObject {
+    Q_OBJECT
+public:
+    static constexpr int POLL_INTERVAL_MS = 2000;
+
+    explicit ExternalChangeWatcher( DatabaseManager& db, QObject* parent = nullptr );
+
+    void start();
+
+private slots:
+    void poll();
+    void onApplicationStateChanged( Qt::ApplicationState state );
+
+private:
+    DatabaseManager& db_;
+    QTimer poll_timer_;
+};
@@ -82,9 +82,6 @@ void MainWindow::setupConnections() {
 
     connect( btn_sets_, &QPushButton::clicked, this, [this]() {
         if ( confirmSessionExit() ) {
-            if ( auto* sets_ptr = qobject_cast<SetsView*>( sets_view_ ) ) {
-                sets_ptr->refreshSetsList();
-            }
             main_stack_->setCurrentWidget( sets_view_ );
         }
     } );
@@ -113,7 +110,6 @@ void MainWindow::setupConnections() {
                              main_stack_->setCurrentWidget( sets_view_ptr );
                              main_stack_->removeWidget( detail_view );
                              detail_view->deleteLater();
-                             sets_view_ptr->refreshSetsList();
                          } );
 
                 connect(
@@ -128,7 +124,6 @@ void MainWindow::setupConnections() {
 
                             connect( learning_ptr, &LearningView::sessionFinished, this,
                                      [this, learning_widget, sets_view_ptr]() {
-                                         sets_view_ptr->refreshSetsList();
                                          main_stack_->setCurrentWidget( sets_view_ptr );
                                          main_stack_->removeWidget( learning_widget );
                                          learning_widget->deleteLater();
@@ -161,8 +156,7 @@ void MainWindow::setupConnections() {
                          } );
 
                 connect( add_ptr, &AddSetView::setCreated, this, [this, add_view, sets_view_ptr]() {
-                    qDebug() << "MainWindow: Set created - refreshing list.";
-                    sets_view_ptr->refreshSetsList();
+                    qDebug() << "MainWindow: Set created.";
                     main_stack_->setCurrentWidget( sets_view_ptr );
                     main_stack_->removeWidget( add_view );
                     add_view->deleteLater();
@@ -186,9 +180,6 @@ void MainWindow::setupConnections() {
                 } );
 
                 connect( add_ptr, &AddSetView::setCreated, this, [this, add_view]() {
-                    if ( auto* sets_ptr = qobject_cast<SetsView*>( sets_view_ ) ) {
-                        sets_ptr->refreshSetsList();
-                    }
                     main_stack_->setCurrentWidget( sets_view_ );
                     main_stack_->removeWidget( add_view );
                     add_view->deleteLater();
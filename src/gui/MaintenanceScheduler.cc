@@ -0,0 +1,49 @@
+/*
+ * @authors: Jakub Jurczak, Mateusz Woźniak
+ * summary: Class MaintenanceScheduler, runs database maintenance while the user is idle - source
+ * file.
+ */
+#include <QCoreApplication>
+#include <QEvent>
+
+#include "MaintenanceScheduler.h"
+
+MaintenanceScheduler::MaintenanceScheduler( DatabaseManager& db, QObject* parent )
+    : QObject( parent ), maintenance_( db ) {
+    tick_timer_.setInterval( TICK_MS );
+    connect( &tick_timer_, &QTimer::timeout, this, &MaintenanceScheduler::onTick );
+}
+
+void MaintenanceScheduler::start() {
+    idle_timer_.start();
+    QCoreApplication::instance()->installEventFilter( this );
+    tick_timer_.start();
+}
+
+// any keyboard or mouse activity postpones the next maintenance slice
+bool MaintenanceScheduler::eventFilter( QObject* watched, QEvent* event ) {
+    switch ( event->type() ) {
+        case QEvent::KeyPress:
+        case QEvent::MouseButtonPress:
+        case QEvent::MouseMove:
+        case QEvent::Wheel:
+            idle_timer_.restart();
+            break;
+        default:
+            break;
+    }
+    return QObject::eventFilter( watched, event );
+}
+
+void MaintenanceScheduler::onTick() {
+    if ( idle_timer_.elapsed() < IDLE_THRESHOLD_MS ) return;
+
+    if ( maintenance_.isFinished() ) {
+        if ( since_last_run_.isValid() && since_last_run_.elapsed() < RERUN_INTERVAL_MS ) return;
+        maintenance_.restart();
+    }
+
+    if ( !maintenance_.runSlice( SLICE_BUDGET_MS ) ) {
+        since_last_run_.start();
+    }
+}
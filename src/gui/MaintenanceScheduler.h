@@ -0,0 +1,36 @@
+/*
+ * @authors: Jakub Jurczak, Mateusz Woźniak
+ * summary: Class MaintenanceScheduler, runs database maintenance while the user is idle - header
+ * file.
+ */
+#pragma once
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+
+#include "../db/DatabaseMaintenance.h"
+
+class MaintenanceScheduler : public QObject {
+    Q_OBJECT
+public:
+    static constexpr int TICK_MS = 1000;
+    static constexpr int IDLE_THRESHOLD_MS = 30 * 1000;
+    static constexpr int SLICE_BUDGET_MS = 50;
+    static constexpr qint64 RERUN_INTERVAL_MS = 6LL * 60 * 60 * 1000;
+
+    explicit MaintenanceScheduler( DatabaseManager& db, QObject* parent = nullptr );
+
+    void start();
+
+protected:
+    bool eventFilter( QObject* watched, QEvent* event ) override;
+
+private slots:
+    void onTick();
+
+private:
+    DatabaseMaintenance maintenance_;
+    QTimer tick_timer_;
+    QElapsedTimer idle_timer_;
+    QElapsedTimer since_last_run_;
+};
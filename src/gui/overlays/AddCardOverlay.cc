@@ -114,6 +114,11 @@ void AddCardOverlay::setupUi() {
     input_correct_answer_->setPlaceholderText( tr( "E.g. Dog, 1944..." ) );
     dialog_layout->addWidget( input_correct_answer_ );
 
+    input_accepted_answers_ = new QLineEdit( dialog );
+    input_accepted_answers_->setPlaceholderText( tr( "Other accepted answers, separated by ;" ) );
+    dialog_layout->addWidget( input_accepted_answers_ );
+    input_accepted_answers_->hide();
+
     quiz_container_ = new QWidget( dialog );
     QVBoxLayout* quiz_layout = new QVBoxLayout( quiz_container_ );
     quiz_layout->setContentsMargins( 0, 0, 0, 0 );
@@ -202,6 +207,14 @@ void AddCardOverlay::setupConnections() {
             if ( final_name.isEmpty() ) return;
             draft.question = SoundContent{ final_name.toStdString() };
         }
+        if ( draft.answer_type == AnswerType::INPUT ) {
+            for ( const QString& accepted :
+                  input_accepted_answers_->text().split( ';', Qt::SkipEmptyParts ) ) {
+                if ( !accepted.trimmed().isEmpty() ) {
+                    draft.accepted_answers.push_back( accepted.trimmed().toStdString() );
+                }
+            }
+        }
         if ( draft.answer_type == AnswerType::TEXT_CHOICE ) {
             if ( !input_wrong1_->text().isEmpty() )
                 draft.wrong_answers.push_back( input_wrong1_->text().toStdString() );
@@ -232,6 +245,7 @@ void AddCardOverlay::onAnswerTypeChanged( int index ) {
     } else {
         quiz_container_->hide();
     }
+    input_accepted_answers_->setVisible( type == AnswerType::INPUT );
 }
 
 void AddCardOverlay::selectImageFile() {
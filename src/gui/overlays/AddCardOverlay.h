@@ -51,6 +51,7 @@ private:
     QString selected_sound_path_;
 
     QLineEdit* input_correct_answer_;
+    QLineEdit* input_accepted_answers_;
 
     QWidget* quiz_container_;
     QLineEdit* input_wrong1_;
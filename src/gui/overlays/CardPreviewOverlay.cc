@@ -9,6 +9,7 @@
 #include <QPushButton>
 #include <QDir>
 #include <QPixmap>
+#include <QImage>
 #include <QDebug>
 #include <QMediaPlayer>
 #include <QAudioOutput>
@@ -31,12 +32,14 @@ static QString getMediaPath( const string& relative_path ) {
 #endif
 }
 
-CardPreviewOverlay::CardPreviewOverlay( const Card& card, QWidget* parent ) : QWidget( parent ) {
-    setupUi( card );
+CardPreviewOverlay::CardPreviewOverlay( const Card& card, QWidget* parent,
+                                        const optional<MediaInfo>& media )
+    : QWidget( parent ) {
+    setupUi( card, media );
     StyleLoader::attach( this, "overlays/CardPreviewOverlay.qss" );
 }
 
-void CardPreviewOverlay::setupUi( const Card& card ) {
+void CardPreviewOverlay::setupUi( const Card& card, const optional<MediaInfo>& media ) {
     this->setObjectName( "overlayBackground" );
 
     QVBoxLayout* main_layout = new QVBoxLayout( this );
@@ -95,10 +98,16 @@ void CardPreviewOverlay::setupUi( const Card& card ) {
                         QLabel* imgLabel = new QLabel( body );
                         imgLabel->setAlignment( Qt::AlignCenter );
                         QString path = getMediaPath( c.image_path );
-                        QPixmap pix( path );
-                        if ( !pix.isNull() ) {
-                            imgLabel->setPixmap( pix.scaled( 400, 300, Qt::KeepAspectRatio,
-                                                             Qt::SmoothTransformation ) );
+                        QImage img;
+                        if ( media ) {
+                            img = MediaProbe::readFitted( path, *media, { 400, 300 } );
+                        } else {
+                            // drafts are not cataloged yet, they are decoded in full
+                            img = QImage( path ).scaled( 400, 300, Qt::KeepAspectRatio,
+                                                         Qt::SmoothTransformation );
+                        }
+                        if ( !img.isNull() ) {
+                            imgLabel->setPixmap( QPixmap::fromImage( img ) );
                         } else {
                             imgLabel->setText( tr( "[Image load error] " ) + path );
                             imgLabel->setObjectName( "errorLabel" );
@@ -4,17 +4,21 @@
  */
 #pragma once
 #include <QWidget>
+#include <optional>
 
 #include "../../core/learning/Card.h"
+#include "../../core/utils/MediaProbe.h"
 
 class CardPreviewOverlay : public QWidget {
     Q_OBJECT
 public:
-    explicit CardPreviewOverlay( const Card& card, QWidget* parent = nullptr );
+    // media holds the catalog entry of the question's file, drafts without one are read from disk
+    explicit CardPreviewOverlay( const Card& card, QWidget* parent = nullptr,
+                                 const std::optional<MediaInfo>& media = std::nullopt );
 
 signals:
     void closeClicked();
 
 private:
-    void setupUi( const Card& card );
+    void setupUi( const Card& card, const std::optional<MediaInfo>& media );
 };
\ No newline at end of file
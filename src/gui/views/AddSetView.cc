@@ -140,6 +140,7 @@ void AddSetView::onCardSaved( const DraftCard& card ) {
         data.question = card_copy.question;
         data.correct_answer = card_copy.correct_answer;
         data.wrong_answers = card_copy.wrong_answers;
+        data.accepted_answers = card_copy.accepted_answers;
         data.answer_type = card_copy.answer_type;
 
         Card previewCard( data );
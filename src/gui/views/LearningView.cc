@@ -5,6 +5,7 @@
 #include <QMessageBox>
 #include <QDebug>
 #include <QPixmap>
+#include <QImage>
 #include <QSettings>
 #include <QRandomGenerator>
 #include <QTimer>
@@ -13,6 +14,7 @@
 
 #include "LearningView.h"
 #include "../../core/utils/Overloaded.h"
+#include "../../core/learning/schedulers/Schedulers.h"
 #include "../../core/learning/strategies/SelectionStrategies.h"
 #include "../../core/utils/StyleLoader.h"
 
@@ -69,8 +71,24 @@ void LearningView::startSession( int set_id, LearningMode mode ) {
             break;
     }
 
+    // fitted weights when the user optimized FSRS, the published defaults otherwise
+    QSettings settings( "ZPR", "LearningApp" );
+    if ( settings.value( "use_fsrs", false ).toBool() ) {
+        session_.setScheduler( make_unique<FsrsScheduler>(
+            db_.getFsrsWeights().value_or( Fsrs::DEFAULT_WEIGHTS ) ) );
+    } else {
+        session_.setScheduler( make_unique<SuperMemoScheduler>() );
+    }
+
+    session_.setAnswerKeyOptions( { settings.value( "ignore_diacritics", false ).toBool(),
+                                    settings.value( "ignore_spaces", false ).toBool() } );
+
+    // 0 stands for no limit
+    int limit = settings.value( "session_limit", 20 ).toInt();
+    if ( limit <= 0 ) limit = LearningSession::UNLIMITED;
+
     try {
-        session_.start( set_id, std::move( strategy ), 20 );
+        session_.start( set_id, std::move( strategy ), limit );
 
         try {
             session_.getCurrentCard();
@@ -190,12 +208,21 @@ void LearningView::renderQuestion( const Card& card ) {
                            QLabel* imgLabel = new QLabel( card_frame_ );
                            imgLabel->setAlignment( Qt::AlignCenter );
 
+                           // the catalog gives the size up front, so only the fitted image is
+                           // decoded; media of older databases or with a failed probe has no
+                           // row and is decoded in full, as before the catalog
                            QString path = getMediaPath( c.image_path );
-                           QPixmap pix( path );
+                           optional<MediaInfo> media = db_.getMediaInfo( c.image_path );
+                           QImage img;
+                           if ( media ) {
+                               img = MediaProbe::readFitted( path, *media, { 500, 350 } );
+                           } else {
+                               img = QImage( path ).scaled( 500, 350, Qt::KeepAspectRatio,
+                                                            Qt::SmoothTransformation );
+                           }
 
-                           if ( !pix.isNull() ) {
-                               imgLabel->setPixmap( pix.scaled( 500, 350, Qt::KeepAspectRatio,
-                                                                Qt::SmoothTransformation ) );
+                           if ( !img.isNull() ) {
+                               imgLabel->setPixmap( QPixmap::fromImage( img ) );
                            } else {
                                qDebug() << "Image load error:" << path;
                                imgLabel->setText( tr( "[Image load error]\n" ) + path );
@@ -211,8 +238,10 @@ void LearningView::renderQuestion( const Card& card ) {
                            btn->setCursor( Qt::PointingHandCursor );
 
                            QString path = getMediaPath( c.sound_path );
-                           if ( !QFile::exists( path ) )
-                               qCritical() << "File does not exist:" << path;
+                           optional<MediaInfo> media = db_.getMediaInfo( c.sound_path );
+                           if ( !media ) {
+                               qCritical() << "Sound is not in the media catalog:" << path;
+                           }
 
                            connect( btn, &QPushButton::clicked, this, [this, path, btn]() {
                                ensureAudioInitialized();
@@ -232,9 +261,13 @@ void LearningView::renderQuestion( const Card& card ) {
                                }
                            } );
                            question_layout_->addWidget( btn );
-                           QLabel* info = new QLabel(
-                               tr( "(Sound: " ) + QString::fromStdString( c.sound_path ) + ")",
-                               card_frame_ );
+                           QString details = QString::fromStdString( c.sound_path );
+                           if ( media && media->duration_ms > 0 ) {
+                               details += QString( ", %1 s" ).arg( media->duration_ms / 1000.0,
+                                                                   0, 'f', 1 );
+                           }
+                           QLabel* info =
+                               new QLabel( tr( "(Sound: " ) + details + ")", card_frame_ );
                            info->setObjectName( "soundInfoLabel" );
                            question_layout_->addWidget( info );
                        } },
@@ -317,10 +350,11 @@ void LearningView::renderFlashcardView( const CardData& data ) {
 }
 
 void LearningView::renderQuizView( const CardData& data ) {
-    vector<string> choices = session_.getCurrentCard().getChoices();
+    const Card& card = session_.getCurrentCard();
+    ChoiceOrder order = session_.shuffleCurrentChoices();
 
-    for ( const auto& choice_str : choices ) {
-        QString choice = QString::fromStdString( choice_str );
+    for ( size_t i = 0; i < order.size; ++i ) {
+        QString choice = QString::fromStdString( card.getChoice( order.positions[i] ) );
         QPushButton* btn = new QPushButton( choice, interaction_container_ );
         btn->setCursor( Qt::PointingHandCursor );
         btn->setMinimumHeight( 50 );
@@ -435,7 +469,8 @@ void LearningView::onInputChecked() {
 
     QString user_answer = input->text().trimmed();
     const Card& card = session_.getCurrentCard();
-    bool is_correct = card.checkAnswer( user_answer.toStdString() );
+    AnswerMatch match = card.matchAnswer( user_answer.toStdString() );
+    bool is_correct = match != AnswerMatch::WRONG;
     QString correct_text = QString::fromStdString( card.getCorrectAnswer() );
 
     input->setReadOnly( true );
@@ -454,6 +489,14 @@ void LearningView::onInputChecked() {
         input->setProperty( "state", "correct" );
         updateStyle( input );
 
+        // a typo still counts, but the user gets to see the right spelling
+        if ( match == AnswerMatch::TYPO ) {
+            QLabel* correction =
+                new QLabel( tr( "Almost! Correct: " ) + correct_text, interaction_container_ );
+            correction->setObjectName( "correctionLabel" );
+            interaction_layout_->addWidget( correction );
+        }
+
         if ( current_mode_ == LearningMode::SpacedRepetition ) {
             showGradingButtons();
         } else {
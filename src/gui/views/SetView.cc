@@ -11,6 +11,9 @@
 #include <QMenu>
 #include <QAction>
 #include <QFrame>
+#include <QScrollBar>
+#include <QProgressDialog>
+#include <QTimer>
 #include <algorithm>
 
 #include "SetView.h"
@@ -18,6 +21,7 @@
 #include "../overlays/AddCardOverlay.h"
 #include "../overlays/CardPreviewOverlay.h"
 #include "../../core/utils/StyleLoader.h"
+#include "../../db/ProgressResetJob.h"
 
 using namespace std;
 
@@ -28,9 +32,59 @@ SetView::SetView( int set_id, DatabaseManager& db, QWidget* parent )
     setupUi();
     loadData();
 
+    subscription_id_ =
+        db_.subscribe( [this]( const DatabaseChange& change ) { onDatabaseChanged( change ); } );
+
     StyleLoader::attach( this, "views/SetView.qss" );
 }
 
+SetView::~SetView() { db_.unsubscribe( subscription_id_ ); }
+
+// resets the set batch by batch from the event loop, so the window stays responsive
+void SetView::startProgressReset() {
+    if ( reset_job_ ) return;
+    reset_job_ = make_unique<ProgressResetJob>( db_, set_id_ );
+
+    auto* dialog =
+        new QProgressDialog( tr( "Resetting progress..." ), tr( "Cancel" ), 0, 100, this );
+    dialog->setWindowModality( Qt::WindowModal );
+    dialog->setMinimumDuration( 500 );
+    dialog->setValue( 0 );
+
+    auto* timer = new QTimer( this );
+    timer->setInterval( 0 );
+
+    connect( dialog, &QProgressDialog::canceled, this, [this]() {
+        if ( reset_job_ ) reset_job_->cancel();
+    } );
+
+    connect( timer, &QTimer::timeout, this, [this, timer, dialog]() {
+        if ( reset_job_->step() ) {
+            dialog->setValue( static_cast<int>( reset_job_->progress() * 100 ) );
+            return;
+        }
+
+        timer->stop();
+        timer->deleteLater();
+        dialog->reset();
+        dialog->deleteLater();
+
+        if ( reset_job_->isFinished() ) {
+            QMessageBox::information( this, tr( "Success" ), tr( "Progress reset." ) );
+        } else if ( reset_job_->isCancelled() ) {
+            updateStatistics( db_.getSetStatistics( set_id_ ) );
+            QMessageBox::information( this, tr( "Reset progress" ),
+                                      tr( "Reset cancelled, some cards keep their progress." ) );
+        } else {
+            updateStatistics( db_.getSetStatistics( set_id_ ) );
+            QMessageBox::critical( this, tr( "Error" ), tr( "Could not reset progress." ) );
+        }
+        reset_job_.reset();
+    } );
+
+    timer->start();
+}
+
 void SetView::resizeEvent( QResizeEvent* event ) {
     QWidget::resizeEvent( event );
     if ( overlay_container_ ) {
@@ -91,7 +145,6 @@ void SetView::setupUi() {
                  [this]( const DraftCard& c ) {
                      if ( db_.addCardToSet( set_id_, c ) ) {
                          overlay_container_->clearContent();
-                         loadData();
                      } else {
                          QMessageBox::critical( this, tr( "Error" ), tr( "Could not save card." ) );
                      }
@@ -126,12 +179,7 @@ void SetView::setupUi() {
                                    QMessageBox::Yes | QMessageBox::No );
 
         if ( reply == QMessageBox::Yes ) {
-            if ( db_.resetSetProgress( set_id_ ) ) {
-                QMessageBox::information( this, tr( "Success" ), tr( "Progress reset." ) );
-                loadData();
-            } else {
-                QMessageBox::critical( this, tr( "Error" ), tr( "Could not reset progress." ) );
-            }
+            startProgressReset();
         }
     } );
 
@@ -187,6 +235,14 @@ void SetView::setupUi() {
 
     cards_list_ = new QListWidget( this );
     main_layout->addWidget( cards_list_ );
+
+    // further pages are fetched when the user scrolls close to the end of the list
+    QScrollBar* scroll_bar = cards_list_->verticalScrollBar();
+    connect( scroll_bar, &QScrollBar::valueChanged, this, [this, scroll_bar]( int value ) {
+        if ( !all_rows_loaded_ && value >= scroll_bar->maximum() - PREFETCH_MARGIN ) {
+            loadNextPage();
+        }
+    } );
 }
 
 void SetView::loadData() {
@@ -197,10 +253,56 @@ void SetView::loadData() {
         title_label_->setText( tr( "Unknown set" ) );
     }
 
-    current_cards_ = db_.getCardsForSet( set_id_ );
     cards_list_->clear();
+    card_rows_.clear();
+    loaded_rows_ = 0;
+    all_rows_loaded_ = false;
+    loadNextPage();
+
+    updateStatistics( db_.getSetStatistics( set_id_ ) );
+}
 
-    SetStats stats = db_.getSetStatistics( set_id_ );
+void SetView::loadNextPage() {
+    vector<CardSummary> page = db_.getCardSummaries( set_id_, loaded_rows_, PAGE_SIZE );
+    for ( const auto& card : page ) {
+        addCardRow( card );
+    }
+    loaded_rows_ += page.size();
+    all_rows_loaded_ = page.size() < static_cast<size_t>( PAGE_SIZE );
+}
+
+// applies a single change to the list instead of rebuilding it
+void SetView::onDatabaseChanged( const DatabaseChange& change ) {
+    switch ( change.type ) {
+        case ChangeType::CARD_ADDED:
+            if ( change.set_id != set_id_ ) return;
+            // new cards have the highest id, so they show up once the list reaches its end
+            if ( all_rows_loaded_ ) loadNextPage();
+            // a freshly added card has no progress yet
+            stats_.total++;
+            stats_.new_cards++;
+            updateStatistics( stats_ );
+            break;
+        case ChangeType::CARD_DELETED:
+            if ( change.set_id != set_id_ ) return;
+            removeCardRow( change.card_id );
+            updateStatistics( db_.getSetStatistics( set_id_ ) );
+            break;
+        case ChangeType::PROGRESS_CHANGED:
+            if ( change.set_id != set_id_ && card_rows_.count( change.card_id ) == 0 ) return;
+            updateStatistics( db_.getSetStatistics( set_id_ ) );
+            break;
+        case ChangeType::EXTERNAL:
+            loadData();
+            break;
+        case ChangeType::SET_ADDED:
+        case ChangeType::SET_DELETED:
+            break;
+    }
+}
+
+void SetView::updateStatistics( const SetStats& stats ) {
+    stats_ = stats;
 
     int total = stats.total;
     int new_cards = stats.new_cards;
@@ -257,52 +359,73 @@ void SetView::loadData() {
 
         chart->setStyleSheet( style );
     }
+}
 
-    for ( const auto& card : current_cards_ ) {
-        QListWidgetItem* item = new QListWidgetItem( cards_list_ );
-        item->setSizeHint( QSize( 0, 50 ) );
-
-        QWidget* row_widget = new QWidget();
-        QHBoxLayout* row_layout = new QHBoxLayout( row_widget );
-        row_layout->setContentsMargins( 0, 0, 10, 0 );
-        row_layout->setSpacing( 10 );
-
-        QString question = QString::fromStdString( card.getQuestion() );
-        int card_id = card.getId();
-
-        QPushButton* btn_content = new QPushButton( question, row_widget );
-        btn_content->setCursor( Qt::PointingHandCursor );
-        btn_content->setObjectName( "cardContent" );
-        btn_content->setSizePolicy( QSizePolicy::Expanding, QSizePolicy::Preferred );
-
-        connect( btn_content, &QPushButton::clicked, this, [this, card]() {
-            current_preview_ = make_unique<CardPreviewOverlay>( card );
-            auto* ptr = static_cast<CardPreviewOverlay*>( current_preview_.get() );
-            connect( ptr, &CardPreviewOverlay::closeClicked, overlay_container_.get(),
-                     &OverlayContainer::clearContent );
-
-            overlay_container_->setContent( current_preview_.get() );
-        } );
-
-        QPushButton* btn_delete = new QPushButton( row_widget );
-        btn_delete->setIcon( style()->standardIcon( QStyle::SP_TrashIcon ) );
-        btn_delete->setFixedSize( 30, 30 );
-        btn_delete->setCursor( Qt::PointingHandCursor );
-        btn_delete->setObjectName( "deleteCardBtn" );
-
-        connect( btn_delete, &QPushButton::clicked, this, [this, card_id]() {
-            auto reply = QMessageBox::question( this, tr( "Delete" ), tr( "Delete this question?" ),
-                                                QMessageBox::Yes | QMessageBox::No );
-            if ( reply == QMessageBox::Yes ) {
-                if ( db_.deleteCard( card_id ) ) {
-                    loadData();
-                }
-            }
-        } );
+void SetView::addCardRow( const CardSummary& card ) {
+    QListWidgetItem* item = new QListWidgetItem( cards_list_ );
+    item->setSizeHint( QSize( 0, 50 ) );
 
-        row_layout->addWidget( btn_content );
-        row_layout->addWidget( btn_delete );
+    QWidget* row_widget = new QWidget();
+    QHBoxLayout* row_layout = new QHBoxLayout( row_widget );
+    row_layout->setContentsMargins( 0, 0, 10, 0 );
+    row_layout->setSpacing( 10 );
 
-        cards_list_->setItemWidget( item, row_widget );
+    QString question = QString::fromStdString( card.question );
+    int card_id = card.id;
+
+    QPushButton* btn_content = new QPushButton( question, row_widget );
+    btn_content->setCursor( Qt::PointingHandCursor );
+    btn_content->setObjectName( "cardContent" );
+    btn_content->setSizePolicy( QSizePolicy::Expanding, QSizePolicy::Preferred );
+
+    connect( btn_content, &QPushButton::clicked, this,
+             [this, card_id]() { openCardPreview( card_id ); } );
+
+    QPushButton* btn_delete = new QPushButton( row_widget );
+    btn_delete->setIcon( style()->standardIcon( QStyle::SP_TrashIcon ) );
+    btn_delete->setFixedSize( 30, 30 );
+    btn_delete->setCursor( Qt::PointingHandCursor );
+    btn_delete->setObjectName( "deleteCardBtn" );
+
+    connect( btn_delete, &QPushButton::clicked, this, [this, card_id]() {
+        auto reply = QMessageBox::question( this, tr( "Delete" ), tr( "Delete this question?" ),
+                                            QMessageBox::Yes | QMessageBox::No );
+        if ( reply == QMessageBox::Yes ) {
+            db_.deleteCard( card_id );
+        }
+    } );
+
+    row_layout->addWidget( btn_content );
+    row_layout->addWidget( btn_delete );
+
+    cards_list_->setItemWidget( item, row_widget );
+    card_rows_[card_id] = item;
+}
+
+void SetView::removeCardRow( int card_id ) {
+    auto it = card_rows_.find( card_id );
+    if ( it == card_rows_.end() ) return;
+
+    delete cards_list_->takeItem( cards_list_->row( it->second ) );
+    card_rows_.erase( it );
+    loaded_rows_--;
+}
+
+// the full card with all answers is only loaded when it is actually shown
+void SetView::openCardPreview( int card_id ) {
+    optional<Card> card = db_.getCard( card_id );
+    if ( !card.has_value() ) {
+        QMessageBox::critical( this, tr( "Error" ), tr( "Could not load card." ) );
+        return;
     }
+
+    optional<MediaInfo> media;
+    if ( card->getMediaType() != MediaType::TEXT ) media = db_.getMediaInfo( card->getMediaFile() );
+
+    current_preview_ = make_unique<CardPreviewOverlay>( *card, nullptr, media );
+    auto* ptr = static_cast<CardPreviewOverlay*>( current_preview_.get() );
+    connect( ptr, &CardPreviewOverlay::closeClicked, overlay_container_.get(),
+             &OverlayContainer::clearContent );
+
+    overlay_container_->setContent( current_preview_.get() );
 }
\ No newline at end of file
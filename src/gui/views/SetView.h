@@ -8,18 +8,21 @@
 #include <vector>
 #include <QLabel>
 #include <memory>
+#include <unordered_map>
 
 #include "../../db/DatabaseManager.h"
 #include "../../core/learning/Card.h"
 #include "../../core/learning/LearningSession.h"
 
 class OverlayContainer;
+class ProgressResetJob;
 class AddCardOverlay;
 
 class SetView : public QWidget {
     Q_OBJECT
 public:
     explicit SetView( int set_id, DatabaseManager& db, QWidget* parent = nullptr );
+    ~SetView();
 
 signals:
     void backToSetsClicked();
@@ -31,9 +34,17 @@ protected:
 private:
     void setupUi();
     void loadData();
+    void loadNextPage();
+    void updateStatistics( const SetStats& stats );
+    void addCardRow( const CardSummary& card );
+    void openCardPreview( int card_id );
+    void startProgressReset();
+    void removeCardRow( int card_id );
+    void onDatabaseChanged( const DatabaseChange& change );
 
     int set_id_;
     DatabaseManager& db_;
+    int subscription_id_ = -1;
 
     QLabel* title_label_;
     QListWidget* cards_list_;
@@ -41,6 +52,13 @@ private:
     std::unique_ptr<OverlayContainer> overlay_container_;
     std::unique_ptr<AddCardOverlay> add_overlay_;
     std::unique_ptr<QWidget> current_preview_;
+    std::unique_ptr<ProgressResetJob> reset_job_;
 
-    std::vector<Card> current_cards_;
+    static constexpr int PAGE_SIZE = 200;
+    static constexpr int PREFETCH_MARGIN = 20;
+
+    std::unordered_map<int, QListWidgetItem*> card_rows_;
+    SetStats stats_;
+    int loaded_rows_ = 0;
+    bool all_rows_loaded_ = false;
 };
\ No newline at end of file
@@ -15,6 +15,9 @@
 #include <QMenu>
 #include <QDir>
 #include <QApplication>
+#include <QScrollBar>
+#include <algorithm>
+#include <cctype>
 
 #include "SetsView.h"
 #include "../../core/utils/SetImporter.h"
@@ -23,6 +26,31 @@
 
 using namespace std;
 
+// mirrors the ORDER BY of the SETS_PAGE queries, NOCASE only folds ASCII letters
+static bool comesBefore( const StudySet& a, const StudySet& b, SetSort sort ) {
+    switch ( sort ) {
+        case SetSort::NAME: {
+            auto fold = []( string s ) {
+                transform( s.begin(), s.end(), s.begin(), []( unsigned char c ) {
+                    return c < 128 ? static_cast<char>( tolower( c ) ) : static_cast<char>( c );
+                } );
+                return s;
+            };
+            int cmp = fold( a.name ).compare( fold( b.name ) );
+            return cmp < 0 || ( cmp == 0 && a.id < b.id );
+        }
+        case SetSort::RECENT_ACTIVITY:
+            if ( a.last_activity != b.last_activity ) return a.last_activity > b.last_activity;
+            return a.id > b.id;
+        case SetSort::DUE_COUNT:
+            if ( a.due_count != b.due_count ) return a.due_count > b.due_count;
+            return a.id > b.id;
+        case SetSort::NEWEST:
+            break;
+    }
+    return a.id > b.id;
+}
+
 SetsView::SetsView( DatabaseManager& db, QWidget* parent ) : QWidget( parent ), db_manager_( db ) {
     QVBoxLayout* layout = new QVBoxLayout( this );
     layout->setContentsMargins( 40, 40, 40, 40 );
@@ -59,16 +87,9 @@ SetsView::SetsView( DatabaseManager& db, QWidget* parent ) : QWidget( parent ),
                 if ( SetImporter::importFile( files.first(), db_manager_, error ) ) {
                     QMessageBox::information( this, tr( "Success" ),
                                               tr( "Set imported successfully!" ) );
-                    refreshSetsList();
-                    vector<StudySet> sets = db_manager_.getAllSets();
-                    if ( !sets.empty() ) {
-                        int max_id = -1;
-                        for ( const auto& s : sets ) {
-                            if ( s.id > max_id ) max_id = s.id;
-                        }
-                        if ( max_id > 0 ) {
-                            emit setImported( max_id );
-                        }
+                    vector<StudySet> newest = db_manager_.getSetsPage( SetSort::NEWEST, 1 );
+                    if ( !newest.empty() ) {
+                        emit setImported( newest.front().id );
                     }
                 } else {
                     QMessageBox::critical( nullptr, tr( "Import Error" ), error );
@@ -118,6 +139,18 @@ SetsView::SetsView( DatabaseManager& db, QWidget* parent ) : QWidget( parent ),
     btn_layout->addWidget( btn_new );
     btn_layout->addWidget( btn_import );
     btn_layout->addWidget( btn_export );
+    btn_layout->addStretch();
+
+    sort_combo_ = new QComboBox( this );
+    sort_combo_->addItem( tr( "Newest" ), static_cast<int>( SetSort::NEWEST ) );
+    sort_combo_->addItem( tr( "Name" ), static_cast<int>( SetSort::NAME ) );
+    sort_combo_->addItem( tr( "Recent activity" ), static_cast<int>( SetSort::RECENT_ACTIVITY ) );
+    sort_combo_->addItem( tr( "Most due" ), static_cast<int>( SetSort::DUE_COUNT ) );
+    connect( sort_combo_, QOverload<int>::of( &QComboBox::currentIndexChanged ), this, [this]() {
+        sort_ = static_cast<SetSort>( sort_combo_->currentData().toInt() );
+        refreshSetsList();
+    } );
+    btn_layout->addWidget( sort_combo_ );
 
     layout->addLayout( btn_layout );
 
@@ -182,29 +215,98 @@ SetsView::SetsView( DatabaseManager& db, QWidget* parent ) : QWidget( parent ),
                  contextMenu.exec( list_widget_->mapToGlobal( pos ) );
              } );
 
+    // further pages are fetched when the user scrolls close to the end of the list
+    QScrollBar* scroll_bar = list_widget_->verticalScrollBar();
+    connect( scroll_bar, &QScrollBar::valueChanged, this, [this, scroll_bar]( int value ) {
+        if ( !all_rows_loaded_ && value >= scroll_bar->maximum() - PREFETCH_MARGIN ) {
+            loadNextPage();
+        }
+    } );
+
+    subscription_id_ = db_manager_.subscribe(
+        [this]( const DatabaseChange& change ) { onDatabaseChanged( change ); } );
+
     StyleLoader::attach( this, "views/SetsView.qss" );
 }
 
+SetsView::~SetsView() { db_manager_.unsubscribe( subscription_id_ ); }
+
 void SetsView::refreshSetsList() {
     list_widget_->clear();
-    vector<StudySet> sets = db_manager_.getAllSets();
-
-    if ( sets.empty() ) {
-        QListWidgetItem* item = new QListWidgetItem( tr( "No sets. Click '+' to add." ) );
-        item->setFlags( Qt::NoItemFlags );
-        item->setTextAlignment( Qt::AlignCenter );
-        list_widget_->addItem( item );
-        return;
+    set_rows_.clear();
+    loaded_sets_.clear();
+    loaded_ = true;
+    all_rows_loaded_ = false;
+
+    loadNextPage();
+    if ( loaded_sets_.empty() ) showEmptyPlaceholder();
+}
+
+// only the first screen is read up front, so large libraries open instantly
+void SetsView::loadNextPage() {
+    optional<StudySet> after;
+    if ( !loaded_sets_.empty() ) after = loaded_sets_.back();
+
+    vector<StudySet> page = db_manager_.getSetsPage( sort_, PAGE_SIZE, after );
+    for ( const auto& set : page ) {
+        addSetRow( set, static_cast<int>( loaded_sets_.size() ) );
     }
+    all_rows_loaded_ = page.size() < static_cast<size_t>( PAGE_SIZE );
+}
+
+void SetsView::addSetRow( const StudySet& set, int row ) {
+    QListWidgetItem* item = new QListWidgetItem( QString::fromStdString( set.name ) );
+    item->setData( Qt::UserRole, set.id );
+    list_widget_->insertItem( row, item );
+    loaded_sets_.insert( loaded_sets_.begin() + row, set );
+    set_rows_[set.id] = item;
+}
+
+void SetsView::removeSetRow( int set_id ) {
+    auto it = set_rows_.find( set_id );
+    if ( it == set_rows_.end() ) return;
+
+    int row = list_widget_->row( it->second );
+    delete list_widget_->takeItem( row );
+    loaded_sets_.erase( loaded_sets_.begin() + row );
+    set_rows_.erase( it );
+    if ( set_rows_.empty() ) showEmptyPlaceholder();
+}
+
+void SetsView::showEmptyPlaceholder() {
+    list_widget_->clear();
+    QListWidgetItem* item = new QListWidgetItem( tr( "No sets. Click '+' to add." ) );
+    item->setFlags( Qt::NoItemFlags );
+    item->setTextAlignment( Qt::AlignCenter );
+    list_widget_->addItem( item );
+}
 
-    for ( const auto& set : sets ) {
-        QListWidgetItem* item = new QListWidgetItem( QString::fromStdString( set.name ) );
-        item->setData( Qt::UserRole, set.id );
-        list_widget_->addItem( item );
+// keeps the list in sync without reloading it, a new set goes to its place in the current order
+void SetsView::onDatabaseChanged( const DatabaseChange& change ) {
+    if ( !loaded_ ) return;
+
+    if ( change.type == ChangeType::SET_ADDED ) {
+        auto set_opt = db_manager_.getSet( change.set_id );
+        if ( !set_opt.has_value() ) return;
+
+        auto pos = find_if( loaded_sets_.begin(), loaded_sets_.end(), [&]( const StudySet& s ) {
+            return comesBefore( *set_opt, s, sort_ );
+        } );
+        // past the loaded rows the set arrives with a later page
+        if ( pos == loaded_sets_.end() && !all_rows_loaded_ ) return;
+
+        if ( set_rows_.empty() ) list_widget_->clear();
+        addSetRow( *set_opt, static_cast<int>( pos - loaded_sets_.begin() ) );
+    } else if ( change.type == ChangeType::SET_DELETED ) {
+        removeSetRow( change.set_id );
+    } else if ( change.type == ChangeType::EXTERNAL ) {
+        // a hidden list reloads on its next show
+        loaded_ = false;
+        if ( isVisible() ) refreshSetsList();
     }
 }
 
 void SetsView::showEvent( QShowEvent* event ) {
     QWidget::showEvent( event );
-    refreshSetsList();
+    if ( !loaded_ ) refreshSetsList();
 }
\ No newline at end of file
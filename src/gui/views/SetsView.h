@@ -3,8 +3,11 @@
  * summary: Sets view of the application - header file.
  */
 #pragma once
+#include <QComboBox>
 #include <QListWidget>
 #include <QWidget>
+#include <unordered_map>
+#include <vector>
 
 #include "../../db/DatabaseManager.h"
 
@@ -12,6 +15,7 @@ class SetsView : public QWidget {
     Q_OBJECT
 public:
     explicit SetsView( DatabaseManager& db, QWidget* parent = nullptr );
+    ~SetsView();
     void refreshSetsList();
 
 protected:
@@ -24,6 +28,23 @@ signals:
 
 private:
     void setupStyles();
+    void loadNextPage();
+    void addSetRow( const StudySet& set, int row );
+    void removeSetRow( int set_id );
+    void showEmptyPlaceholder();
+    void onDatabaseChanged( const DatabaseChange& change );
+
+    static constexpr int PAGE_SIZE = 100;
+    static constexpr int PREFETCH_MARGIN = 20;
+
     QListWidget* list_widget_;
+    QComboBox* sort_combo_;
     DatabaseManager& db_manager_;
+    int subscription_id_ = -1;
+    bool loaded_ = false;
+    bool all_rows_loaded_ = false;
+    SetSort sort_ = SetSort::NEWEST;
+    // sets in list order, the last one is the cursor of the next page
+    std::vector<StudySet> loaded_sets_;
+    std::unordered_map<int, QListWidgetItem*> set_rows_;
 };
\ No newline at end of file
@@ -9,11 +9,13 @@
 #include <QCheckBox>
 #include <QSettings>
 #include <QDebug>
+#include <QMessageBox>
+#include <QtConcurrent>
 
 #include "SettingsView.h"
 #include "../../core/utils/StyleLoader.h"
 
-SettingsView::SettingsView( QWidget* parent ) : QWidget( parent ) {
+SettingsView::SettingsView( DatabaseManager& db, QWidget* parent ) : QWidget( parent ), db_( db ) {
     setupUi();
     StyleLoader::attach( this, "views/SettingsView.qss" );
 }
@@ -103,6 +105,31 @@ void SettingsView::setupUi() {
     chk_random_input_->setObjectName( "indentedCheckbox" );
     group_layout->addWidget( chk_random_input_ );
 
+    // typed answers only, the keys of a session's cards are built with the options it starts with
+    chk_ignore_diacritics_ = new QCheckBox( tr( "Ignore accents in typed answers" ), group );
+    chk_ignore_diacritics_->setChecked( settings.value( "ignore_diacritics", false ).toBool() );
+    chk_ignore_diacritics_->setCursor( Qt::PointingHandCursor );
+    chk_ignore_diacritics_->setToolTip( tr( "If checked, \"zolw\" is accepted for \"żółw\"." ) );
+    chk_ignore_diacritics_->setObjectName( "indentedCheckbox" );
+    group_layout->addWidget( chk_ignore_diacritics_ );
+
+    chk_ignore_spaces_ = new QCheckBox( tr( "Ignore spaces in typed answers" ), group );
+    chk_ignore_spaces_->setChecked( settings.value( "ignore_spaces", false ).toBool() );
+    chk_ignore_spaces_->setCursor( Qt::PointingHandCursor );
+    chk_ignore_spaces_->setToolTip(
+        tr( "If checked, \"icecream\" is accepted for \"ice cream\"." ) );
+    chk_ignore_spaces_->setObjectName( "indentedCheckbox" );
+    group_layout->addWidget( chk_ignore_spaces_ );
+
+    connect( chk_ignore_diacritics_, &QCheckBox::stateChanged, this, []( int state ) {
+        QSettings s( "ZPR", "LearningApp" );
+        s.setValue( "ignore_diacritics", state == Qt::Checked );
+    } );
+    connect( chk_ignore_spaces_, &QCheckBox::stateChanged, this, []( int state ) {
+        QSettings s( "ZPR", "LearningApp" );
+        s.setValue( "ignore_spaces", state == Qt::Checked );
+    } );
+
     connect( chk_enable_input_, &QCheckBox::stateChanged, this, [this]( int state ) {
         bool is_input_active = ( state == Qt::Checked );
 
@@ -110,6 +137,8 @@ void SettingsView::setupUi() {
         s.setValue( "enable_input", is_input_active );
 
         chk_random_input_->setEnabled( is_input_active );
+        chk_ignore_diacritics_->setEnabled( is_input_active );
+        chk_ignore_spaces_->setEnabled( is_input_active );
 
         if ( !is_input_active ) {
             chk_random_input_->setChecked( false );
@@ -123,10 +152,105 @@ void SettingsView::setupUi() {
     } );
 
     chk_random_input_->setEnabled( input_enabled );
+    chk_ignore_diacritics_->setEnabled( input_enabled );
+    chk_ignore_spaces_->setEnabled( input_enabled );
     if ( !input_enabled ) {
         chk_random_input_->setChecked( false );
     }
 
     main_layout->addWidget( group );
+    setupSchedulingGroup( main_layout );
     main_layout->addStretch();
+}
+
+void SettingsView::setupSchedulingGroup( QVBoxLayout* main_layout ) {
+    QGroupBox* group = new QGroupBox( tr( "Review scheduling" ), this );
+
+    QVBoxLayout* group_layout = new QVBoxLayout( group );
+    group_layout->setSpacing( 15 );
+    group_layout->setContentsMargins( 20, 30, 20, 20 );
+
+    QLabel* info = new QLabel(
+        tr( "FSRS predicts how well you remember each card and plans reviews for 90% recall. "
+            "Optimizing fits it to your own review history." ),
+        group );
+    info->setWordWrap( true );
+    info->setObjectName( "infoLabel" );
+    group_layout->addWidget( info );
+
+    QSettings settings( "ZPR", "LearningApp" );
+    chk_use_fsrs_ = new QCheckBox( tr( "Use FSRS instead of SM-2" ), group );
+    chk_use_fsrs_->setChecked( settings.value( "use_fsrs", false ).toBool() );
+    chk_use_fsrs_->setCursor( Qt::PointingHandCursor );
+    group_layout->addWidget( chk_use_fsrs_ );
+
+    btn_optimize_ = new QPushButton( tr( "Optimize for my reviews" ), group );
+    btn_optimize_->setCursor( Qt::PointingHandCursor );
+    btn_optimize_->setEnabled( chk_use_fsrs_->isChecked() );
+    group_layout->addWidget( btn_optimize_ );
+
+    fit_watcher_ = new QFutureWatcher<FsrsFit>( this );
+    connect( chk_use_fsrs_, &QCheckBox::stateChanged, this, [this]( int state ) {
+        QSettings s( "ZPR", "LearningApp" );
+        s.setValue( "use_fsrs", state == Qt::Checked );
+        btn_optimize_->setEnabled( state == Qt::Checked && !fit_watcher_->isRunning() );
+    } );
+    connect( btn_optimize_, &QPushButton::clicked, this, &SettingsView::optimizeScheduler );
+    connect( fit_watcher_, &QFutureWatcher<FsrsFit>::finished, this,
+             &SettingsView::finishOptimization );
+
+    // cards are loaded as the session reaches them, so even an unlimited session starts at once
+    QLabel* limit_info = new QLabel( tr( "Cards per session:" ), group );
+    limit_info->setObjectName( "infoLabel" );
+    group_layout->addWidget( limit_info );
+
+    spin_session_limit_ = new QSpinBox( group );
+    spin_session_limit_->setRange( 0, 9999 );
+    spin_session_limit_->setSpecialValueText( tr( "No limit" ) );
+    spin_session_limit_->setValue( settings.value( "session_limit", 20 ).toInt() );
+    group_layout->addWidget( spin_session_limit_ );
+
+    connect( spin_session_limit_, QOverload<int>::of( &QSpinBox::valueChanged ), this,
+             []( int value ) {
+                 QSettings s( "ZPR", "LearningApp" );
+                 s.setValue( "session_limit", value );
+             } );
+
+    main_layout->addWidget( group );
+}
+
+// a large history takes seconds to read and fit, both happen on a worker so the window stays
+// responsive; the weights are saved on the GUI thread once the fit is done
+void SettingsView::optimizeScheduler() {
+    if ( fit_watcher_->isRunning() ) return;
+    btn_optimize_->setEnabled( false );
+    btn_optimize_->setText( tr( "Optimizing..." ) );
+
+    const DatabaseManager& db = db_;
+    fit_watcher_->setFuture( QtConcurrent::run(
+        [&db] { return FsrsOptimizer::optimize( db.getReviewHistoryDetached() ); } ) );
+}
+
+void SettingsView::finishOptimization() {
+    FsrsFit fit = fit_watcher_->result();
+    btn_optimize_->setText( tr( "Optimize for my reviews" ) );
+    btn_optimize_->setEnabled( chk_use_fsrs_->isChecked() );
+
+    if ( fit.predictions < FsrsOptimizer::MIN_PREDICTIONS ) {
+        QMessageBox::information(
+            this, tr( "Not enough reviews" ),
+            tr( "FSRS needs at least %1 repeated reviews to learn from, you have %2 so far." )
+                .arg( FsrsOptimizer::MIN_PREDICTIONS )
+                .arg( fit.predictions ) );
+        return;
+    }
+    if ( !db_.saveFsrsWeights( fit.weights ) ) {
+        QMessageBox::warning( this, tr( "Error" ), tr( "Could not save the fitted parameters." ) );
+        return;
+    }
+    QString summary = tr( "Prediction error (log loss) went from %1 to %2 over %3 reviews." )
+                          .arg( fit.initial_loss, 0, 'f', 4 )
+                          .arg( fit.loss, 0, 'f', 4 )
+                          .arg( fit.predictions );
+    QMessageBox::information( this, tr( "FSRS optimized" ), summary );
 }
\ No newline at end of file
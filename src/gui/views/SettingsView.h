@@ -8,21 +8,37 @@
 #include <QVBoxLayout>
 #include <QSettings>
 #include <QComboBox>
+#include <QPushButton>
+#include <QFutureWatcher>
+#include <QSpinBox>
+
+#include "../../db/DatabaseManager.h"
 
 class SettingsView : public QWidget {
     Q_OBJECT
 public:
-    explicit SettingsView( QWidget* parent = nullptr );
+    explicit SettingsView( DatabaseManager& db, QWidget* parent = nullptr );
 
 signals:
     void languageChanged( QString langCode );
 
 private:
     void setupUi();
+    void setupSchedulingGroup( QVBoxLayout* main_layout );
+    void optimizeScheduler();
+    void finishOptimization();
+
+    DatabaseManager& db_;
 
     QCheckBox* chk_enable_flashcards_;
     QCheckBox* chk_enable_quiz_;
     QCheckBox* chk_enable_input_;
     QCheckBox* chk_random_input_;
+    QCheckBox* chk_ignore_diacritics_;
+    QCheckBox* chk_ignore_spaces_;
     QComboBox* combo_language_;
+    QCheckBox* chk_use_fsrs_;
+    QPushButton* btn_optimize_;
+    QFutureWatcher<FsrsFit>* fit_watcher_;
+    QSpinBox* spin_session_limit_;
 };
\ No newline at end of file
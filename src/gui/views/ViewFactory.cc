@@ -21,7 +21,7 @@ QWidget* ViewFactory::create( ViewType type, QVariant data, QWidget* parent ) {
             return new HomeView( db_, parent );
 
         case ViewType::SETTINGS:
-            return new SettingsView( parent );
+            return new SettingsView( db_, parent );
 
         case ViewType::SET_VIEW: {
             bool ok = false;
@@ -71,6 +71,10 @@
         <source>E.g. Dog, 1944...</source>
         <translation>Np. Pies, Dog, 1944...</translation>
     </message>
+    <message>
+        <source>Other accepted answers, separated by ;</source>
+        <translation>Inne akceptowane odpowiedzi, oddzielone ;</translation>
+    </message>
     <message>
         <source>Wrong answers (Distractors):</source>
         <translation>Błędne odpowiedzi (Dystraktory):</translation>
@@ -342,6 +346,10 @@ Destination: </source>
         <source>Next (Wrong)</source>
         <translation>Dalej (Błąd)</translation>
     </message>
+    <message>
+        <source>Almost! Correct: </source>
+        <translation>Prawie! Poprawna: </translation>
+    </message>
     <message>
         <source>Correct: </source>
         <translation>Poprawna: </translation>
@@ -705,6 +713,22 @@ Progress is saved automatically.</source>
         <source>If checked, simple cards will sometimes appear as an input field instead of a &apos;Show&apos; button.</source>
         <translation>Jeśli zaznaczone, zwykłe karty będą czasami pojawiać się jako pole do wpisywania zamiast przycisku &apos;Pokaż&apos;.</translation>
     </message>
+    <message>
+        <source>Ignore accents in typed answers</source>
+        <translation>Ignoruj znaki diakrytyczne we wpisywanych odpowiedziach</translation>
+    </message>
+    <message>
+        <source>If checked, &quot;zolw&quot; is accepted for &quot;żółw&quot;.</source>
+        <translation>Jeśli zaznaczone, &quot;zolw&quot; zostanie uznane za &quot;żółw&quot;.</translation>
+    </message>
+    <message>
+        <source>Ignore spaces in typed answers</source>
+        <translation>Ignoruj spacje we wpisywanych odpowiedziach</translation>
+    </message>
+    <message>
+        <source>If checked, &quot;icecream&quot; is accepted for &quot;ice cream&quot;.</source>
+        <translation>Jeśli zaznaczone, &quot;icecream&quot; zostanie uznane za &quot;ice cream&quot;.</translation>
+    </message>
     <message>
         <source>Language</source>
         <translation>Język</translation>
@@ -713,5 +737,57 @@ Progress is saved automatically.</source>
         <source>Application language (requires restart):</source>
         <translation>Język aplikacji (wymaga restartu):</translation>
     </message>
+    <message>
+        <source>Review scheduling</source>
+        <translation>Planowanie powtórek</translation>
+    </message>
+    <message>
+        <source>FSRS predicts how well you remember each card and plans reviews for 90% recall. Optimizing fits it to your own review history.</source>
+        <translation>FSRS przewiduje, jak dobrze pamiętasz każdą kartę, i planuje powtórki tak, by utrzymać 90% przypomnień. Optymalizacja dopasowuje go do Twojej historii powtórek.</translation>
+    </message>
+    <message>
+        <source>Use FSRS instead of SM-2</source>
+        <translation>Używaj FSRS zamiast SM-2</translation>
+    </message>
+    <message>
+        <source>Optimize for my reviews</source>
+        <translation>Optymalizuj na podstawie moich powtórek</translation>
+    </message>
+    <message>
+        <source>Optimizing...</source>
+        <translation>Optymalizacja...</translation>
+    </message>
+    <message>
+        <source>Cards per session:</source>
+        <translation>Kart na sesję:</translation>
+    </message>
+    <message>
+        <source>No limit</source>
+        <translation>Bez limitu</translation>
+    </message>
+    <message>
+        <source>Not enough reviews</source>
+        <translation>Za mało powtórek</translation>
+    </message>
+    <message>
+        <source>FSRS needs at least %1 repeated reviews to learn from, you have %2 so far.</source>
+        <translation>FSRS potrzebuje co najmniej %1 ponownych powtórek, na razie masz ich %2.</translation>
+    </message>
+    <message>
+        <source>Error</source>
+        <translation>Błąd</translation>
+    </message>
+    <message>
+        <source>Could not save the fitted parameters.</source>
+        <translation>Nie udało się zapisać dopasowanych parametrów.</translation>
+    </message>
+    <message>
+        <source>Prediction error (log loss) went from %1 to %2 over %3 reviews.</source>
+        <translation>Błąd predykcji (log loss) zmienił się z %1 na %2 na podstawie %3 powtórek.</translation>
+    </message>
+    <message>
+        <source>FSRS optimized</source>
+        <translation>FSRS zoptymalizowany</translation>
+    </message>
 </context>
 </TS>
@@ -0,0 +1,124 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "core/learning/AnswerMatcher.h"
+#include "core/learning/Card.h"
+
+using namespace std;
+
+// textbook Levenshtein distance over UTF-8 code points, the reference for the fast paths
+static int referenceDistance( const string& a, const string& b ) {
+    auto code_points = []( const string& s ) {
+        vector<string> out;
+        for ( size_t i = 0; i < s.size(); ) {
+            size_t len = 1;
+            auto continues = [&]( size_t k ) {
+                return k < s.size() && ( static_cast<unsigned char>( s[k] ) & 0xC0 ) == 0x80;
+            };
+            while ( continues( i + len ) ) ++len;
+            out.push_back( s.substr( i, len ) );
+            i += len;
+        }
+        return out;
+    };
+    vector<string> x = code_points( a );
+    vector<string> y = code_points( b );
+    vector<vector<int>> d( x.size() + 1, vector<int>( y.size() + 1 ) );
+    for ( size_t i = 0; i <= x.size(); ++i ) d[i][0] = static_cast<int>( i );
+    for ( size_t j = 0; j <= y.size(); ++j ) d[0][j] = static_cast<int>( j );
+    for ( size_t i = 1; i <= x.size(); ++i ) {
+        for ( size_t j = 1; j <= y.size(); ++j ) {
+            d[i][j] = min( { d[i - 1][j] + 1, d[i][j - 1] + 1,
+                             d[i - 1][j - 1] + ( x[i - 1] != y[j - 1] ) } );
+        }
+    }
+    return d[x.size()][y.size()];
+}
+
+TEST_CASE( "Edit distance", "[AnswerMatcher]" ) {
+    SECTION( "Known distances" ) {
+        REQUIRE( AnswerMatcher::editDistance( "kitten", "sitting", 10 ) == 3 );
+        REQUIRE( AnswerMatcher::editDistance( "", "abc", 10 ) == 3 );
+        REQUIRE( AnswerMatcher::editDistance( "abc", "", 10 ) == 3 );
+        REQUIRE( AnswerMatcher::editDistance( "same", "same", 0 ) == 0 );
+        // "ż" and "z" are one substitution, not two byte edits
+        REQUIRE( AnswerMatcher::editDistance( "żółw", "zolw", 10 ) == 3 );
+        REQUIRE( AnswerMatcher::length( "żółw" ) == 4 );
+    }
+
+    SECTION( "Early exit caps the result" ) {
+        REQUIRE( AnswerMatcher::editDistance( "kitten", "sitting", 1 ) == 2 );
+        REQUIRE( AnswerMatcher::editDistance( "short", "a much longer answer", 2 ) == 3 );
+    }
+
+    SECTION( "Matches the reference on random input" ) {
+        mt19937 rng( 42 );
+        vector<string> alphabet = { "a", "b", "c", "ż", "ó", "ł" };
+        auto random_word = [&]( int max_length ) {
+            string word;
+            int length = static_cast<int>( rng() % ( max_length + 1 ) );
+            for ( int i = 0; i < length; ++i ) word += alphabet[rng() % alphabet.size()];
+            return word;
+        };
+        // lengths on both sides of MAX_FAST_LENGTH cover the bit-parallel and the fallback path
+        for ( int i = 0; i < 2000; ++i ) {
+            string a = random_word( 80 );
+            string b = random_word( 80 );
+            int max_distance = static_cast<int>( rng() % 90 );
+            INFO( a << " / " << b << " max " << max_distance );
+            REQUIRE( AnswerMatcher::editDistance( a, b, max_distance ) ==
+                     min( referenceDistance( a, b ), max_distance + 1 ) );
+        }
+    }
+}
+
+TEST_CASE( "Typo tolerant answers", "[AnswerMatcher]" ) {
+    CardData data;
+    data.id = 1;
+    data.set_id = 1;
+    data.question = TextContent{ "Capital of Poland" };
+    data.correct_answer = "Warszawa";
+    data.accepted_answers = { "Warsaw" };
+    data.answer_type = AnswerType::INPUT;
+    Card card( data );
+
+    REQUIRE( card.matchAnswer( "warszawa" ) == AnswerMatch::EXACT );
+    REQUIRE( card.matchAnswer( "WARSAW" ) == AnswerMatch::EXACT );
+    REQUIRE( card.checkAnswer( "Warsaw" ) );
+    REQUIRE( card.matchAnswer( "Warszwa" ) == AnswerMatch::TYPO );
+    REQUIRE( card.matchAnswer( "Warsw" ) == AnswerMatch::TYPO );
+    REQUIRE_FALSE( card.checkAnswer( "Warszwa" ) );
+    REQUIRE( card.matchAnswer( "Kraków" ) == AnswerMatch::WRONG );
+
+    // short answers get no tolerance, a typo there is usually a different word
+    data.correct_answer = "cat";
+    data.accepted_answers.clear();
+    REQUIRE( Card( data ).matchAnswer( "car" ) == AnswerMatch::WRONG );
+    REQUIRE( Card( data ).matchAnswer( "car", { 3, 1 } ) == AnswerMatch::TYPO );
+    REQUIRE( Card( data ).matchAnswer( "Warszawa", { 0, 2 } ) == AnswerMatch::WRONG );
+}
+
+TEST_CASE( "Edit distance throughput", "[.][benchmark]" ) {
+    vector<pair<string, string>> answers = { { "rzeczpospolita", "rzeczpospolta" },
+                                             { "photosynthesis", "fotosynthesis" },
+                                             { "źdźbło", "zdzblo" },
+                                             { "mitochondrium", "mitochondrion" } };
+    BENCHMARK( "bit-parallel distance, max 2" ) {
+        int total = 0;
+        for ( const auto& [expected, typed] : answers ) {
+            total += AnswerMatcher::editDistance( expected, typed, 2 );
+        }
+        return total;
+    };
+    BENCHMARK( "reference distance" ) {
+        int total = 0;
+        for ( const auto& [expected, typed] : answers ) {
+            total += referenceDistance( expected, typed );
+        }
+        return total;
+    };
+}
@@ -0,0 +1,214 @@
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <vector>
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+#include "core/learning/CardStore.h"
+
+using namespace std;
+
+static const vector<string> MONTHS = { "January", "February", "March",     "April",
+                                       "May",     "June",     "July",      "August",
+                                       "September", "October", "November", "December" };
+
+// a quiz card of a synthetic deck, answers and distractors repeat, the question does not
+static CardData syntheticCard( int i ) {
+    CardData data;
+    data.id = i;
+    data.set_id = 1;
+    data.question =
+        TextContent{ "In which month does event number " + to_string( i ) + " happen?" };
+    data.correct_answer = MONTHS[i % 12];
+    data.wrong_answers = { MONTHS[( i + 1 ) % 12], MONTHS[( i + 5 ) % 12], MONTHS[( i + 7 ) % 12] };
+    data.answer_type = AnswerType::TEXT_CHOICE;
+    return data;
+}
+
+// resident set size of the test process, 0 where /proc is not available
+static long residentBytes() {
+#ifdef __linux__
+    ifstream statm( "/proc/self/statm" );
+    long size = 0;
+    long resident = 0;
+    if ( statm >> size >> resident ) return resident * sysconf( _SC_PAGESIZE );
+#endif
+    return 0;
+}
+
+TEST_CASE( "Card Store", "[CardStore]" ) {
+    CardStore store;
+    for ( int i = 0; i < 100; ++i ) store.add( syntheticCard( i ) );
+
+    CardData image;
+    image.id = 1000;
+    image.set_id = 2;
+    image.question = ImageContent{ "images/cat.png" };
+    image.correct_answer = "Cat";
+    image.accepted_answers = { "Kitty" };
+    image.answer_type = AnswerType::INPUT;
+    store.add( image );
+
+    SECTION( "Rows read back" ) {
+        REQUIRE( store.size() == 101 );
+        CardView quiz = store.view( 13 );
+        REQUIRE( quiz.getId() == 13 );
+        REQUIRE( quiz.getQuestion() == "In which month does event number 13 happen?" );
+        REQUIRE( quiz.getCorrectAnswer() == "February" );
+        REQUIRE( quiz.getWrongAnswerCount() == 3 );
+        REQUIRE( quiz.getWrongAnswer( 0 ) == "March" );
+        REQUIRE( quiz.getAcceptedAnswerCount() == 0 );
+        REQUIRE( quiz.isChoiceCard() );
+
+        CardView image_view = store.view( 100 );
+        REQUIRE( image_view.getMediaType() == MediaType::IMAGE );
+        REQUIRE( image_view.getAnswerType() == AnswerType::INPUT );
+        REQUIRE( image_view.getQuestion() == "images/cat.png" );
+        REQUIRE( image_view.getAcceptedAnswer( 0 ) == "Kitty" );
+        REQUIRE_FALSE( image_view.isChoiceCard() );
+    }
+
+    SECTION( "Rows filled column by column" ) {
+        CardStore rows;
+        rows.add( image );
+        rows.beginRow( 2000, 3, MediaType::SOUND, AnswerType::SOUND_CHOICE, "sounds/dog.mp3",
+                       "Dog" );
+        rows.addWrongAnswer( "Cat" );
+        rows.addWrongAnswer( "Cow" );
+        rows.addAcceptedAnswer( "Puppy" );
+        REQUIRE( rows.size() == 2 );
+        CardView sound = rows.view( 1 );
+        REQUIRE( sound.getId() == 2000 );
+        REQUIRE( sound.getMediaType() == MediaType::SOUND );
+        REQUIRE( sound.getQuestion() == "sounds/dog.mp3" );
+        REQUIRE( sound.getWrongAnswerCount() == 2 );
+        REQUIRE( sound.getWrongAnswer( 1 ) == "Cow" );
+        REQUIRE( sound.getAcceptedAnswerCount() == 1 );
+        REQUIRE( sound.getAcceptedAnswer( 0 ) == "Puppy" );
+        REQUIRE( rows.view( 0 ).getAcceptedAnswer( 0 ) == "Kitty" );
+
+        // counts are not limited to 16 bits
+        rows.beginRow( 2001, 3, MediaType::TEXT, AnswerType::INPUT, "Q", "A" );
+        for ( int i = 0; i < 70000; ++i ) rows.addAcceptedAnswer( "a" );
+        REQUIRE( rows.view( 2 ).getAcceptedAnswerCount() == 70000 );
+    }
+
+    SECTION( "Columns line up with rows" ) {
+        REQUIRE( store.ids().size() == store.size() );
+        REQUIRE( store.ids()[100] == 1000 );
+        REQUIRE( store.setIds()[100] == 2 );
+        REQUIRE( store.mediaTypes()[100] == MediaType::IMAGE );
+        REQUIRE( store.answerTypes()[13] == AnswerType::TEXT_CHOICE );
+        REQUIRE( store.wrongAnswerCounts()[13] == 3 );
+    }
+
+    SECTION( "Repeated answers are stored once" ) {
+        // "", 100 questions, 12 months and the three strings of the image card
+        REQUIRE( store.strings().size() == 1 + 100 + 12 + 3 );
+    }
+
+    SECTION( "Cards are rebuilt with their own strings" ) {
+        Card card = store.view( 100 ).toCard();
+        REQUIRE( card.getId() == 1000 );
+        REQUIRE( card.getMediaFile() == "images/cat.png" );
+        REQUIRE( card.checkAnswer( "kitty" ) );
+
+        Card quiz = store.view( 13 ).toCard();
+        store.clear();
+        REQUIRE( quiz.getChoiceCount() == 4 );
+        REQUIRE( quiz.getChoice( 0 ) == "March" );
+        REQUIRE( quiz.getCorrectAnswer() == "February" );
+    }
+}
+
+TEST_CASE( "Card store memory on a large deck", "[.][benchmark]" ) {
+    static constexpr int CARDS = 1000000;
+
+    // both containers stay alive, so each delta only covers its own allocations
+    long before = residentBytes();
+    CardStore store;
+    store.reserve( CARDS );
+    for ( int i = 0; i < CARDS; ++i ) store.add( syntheticCard( i ) );
+    long store_bytes = residentBytes() - before;
+
+    before = residentBytes();
+    vector<CardData> plain;
+    plain.reserve( CARDS );
+    for ( int i = 0; i < CARDS; ++i ) plain.push_back( syntheticCard( i ) );
+    long plain_bytes = residentBytes() - before;
+
+    WARN( "Resident memory for " << CARDS << " cards: vector<CardData> " << plain_bytes / 1024
+                                 << " KiB, CardStore " << store_bytes / 1024 << " KiB ("
+                                 << store.strings().size() << " distinct strings, "
+                                 << store.strings().storedBytes() / 1024 << " KiB of text)" );
+    REQUIRE( store.size() == plain.size() );
+    if ( store_bytes > 0 && plain_bytes > 0 ) REQUIRE( store_bytes < plain_bytes );
+}
+
+TEST_CASE( "Card store scans against vector<Card>", "[.][benchmark]" ) {
+    static constexpr int CARDS = 1000000;
+    static constexpr int ROUNDS = 20;
+
+    CardStore store;
+    store.reserve( CARDS );
+    vector<Card> cards;
+    cards.reserve( CARDS );
+    for ( int i = 0; i < CARDS; ++i ) {
+        CardData data = syntheticCard( i );
+        // every third card is an input card of another set, so the scans have work to do
+        if ( i % 3 == 0 ) {
+            data.set_id = 2;
+            data.wrong_answers.clear();
+            data.answer_type = AnswerType::INPUT;
+        }
+        store.add( data );
+        cards.emplace_back( data );
+    }
+
+    // returns the match count and how long ROUNDS scans took
+    auto timed = []( auto&& scan ) {
+        auto start = chrono::steady_clock::now();
+        size_t found = 0;
+        for ( int round = 0; round < ROUNDS; ++round ) found += scan();
+        auto elapsed = chrono::steady_clock::now() - start;
+        return make_pair( found / ROUNDS,
+                          chrono::duration_cast<chrono::microseconds>( elapsed ).count() / ROUNDS );
+    };
+
+    auto [card_found, card_us] = timed( [&] {
+        size_t found = 0;
+        for ( const Card& card : cards ) {
+            found += card.getData().set_id == 1 && card.isChoiceCard();
+        }
+        return found;
+    } );
+    auto [view_found, view_us] = timed( [&] {
+        size_t found = 0;
+        for ( size_t row = 0; row < store.size(); ++row ) {
+            CardView view = store.view( row );
+            found += view.getSetId() == 1 && view.isChoiceCard();
+        }
+        return found;
+    } );
+    auto [column_found, column_us] = timed( [&] {
+        const auto& set_ids = store.setIds();
+        const auto& wrong_counts = store.wrongAnswerCounts();
+        const auto& answer_types = store.answerTypes();
+        size_t found = 0;
+        for ( size_t row = 0; row < set_ids.size(); ++row ) {
+            found += set_ids[row] == 1 && ( wrong_counts[row] > 0 ||
+                                            answer_types[row] == AnswerType::TEXT_CHOICE ||
+                                            answer_types[row] == AnswerType::IMAGE_CHOICE );
+        }
+        return found;
+    } );
+
+    WARN( "Scan for choice cards of one set over " << CARDS << " cards: vector<Card> " << card_us
+                                                   << " us, CardView " << view_us
+                                                   << " us, columns " << column_us << " us" );
+    REQUIRE( view_found == card_found );
+    REQUIRE( column_found == card_found );
+}
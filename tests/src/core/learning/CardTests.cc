@@ -1,4 +1,7 @@
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <array>
+#include <random>
 #include <vector>
 #include <algorithm>
 #include <iostream>
@@ -73,6 +76,38 @@ TEST_CASE( "Card Class Functionality", "[Card]" ) {
         CHECK_FALSE( input_card.checkAnswer( "Dog" ) );
     }
 
+    SECTION( "Unicode Answer Keys" ) {
+        CardData data = input_data;
+        data.correct_answer = "Żółw";
+        Card polish( data );
+        CHECK( polish.checkAnswer( "żÓŁW" ) );
+        // "o" followed by a combining acute accent is the same letter as "ó" in NFC
+        CHECK( polish.checkAnswer( "\u017Co\u0301\u0142w" ) );
+        CHECK( polish.checkAnswer( "  ŻÓŁW " ) );
+        CHECK_FALSE( polish.checkAnswer( "zolw" ) );
+        CHECK( Card( data, { true, false } ).checkAnswer( "ZOLW" ) );
+
+        data.correct_answer = "Straße";
+        CHECK( Card( data ).checkAnswer( "STRASSE" ) );
+
+        data.correct_answer = "ice cream";
+        CHECK_FALSE( Card( data ).checkAnswer( "icecream" ) );
+        CHECK( Card( data, { false, true } ).checkAnswer( "Ice Cream " ) );
+        CHECK( Card( data, { false, true } ).checkAnswer( "IceCream" ) );
+
+        CHECK( Card( data ).getAnswerKeys().front() == Card::normalizeAnswer( "ICE CREAM" ) );
+
+        Card session_card( data );
+        session_card.setAnswerKeyOptions( { false, true } );
+        CHECK( session_card.checkAnswer( "icecream" ) );
+        session_card.setAnswerKeyOptions( {} );
+        CHECK_FALSE( session_card.checkAnswer( "icecream" ) );
+
+        // plain ASCII skips the Unicode steps and must end up with the same key
+        CHECK( Card::normalizeAnswer( "\t Ice  Cream \n" ) == "ice  cream" );
+        CHECK( Card::normalizeAnswer( " Ice Cream ", { false, true } ) == "icecream" );
+    }
+
     SECTION( "Is Choice Card Logic" ) {
         REQUIRE( image_quiz_card.isChoiceCard() );
 
@@ -81,16 +116,97 @@ TEST_CASE( "Card Class Functionality", "[Card]" ) {
     }
 
     SECTION( "Multiple Choice Handling" ) {
-        REQUIRE( standard_card.getChoices().size() == 1 );
-        REQUIRE( standard_card.getChoices()[0] == "Jupiter" );
-
-        vector<string> choices = image_quiz_card.getChoices();
-
-        REQUIRE( choices.size() == 4 );
+        REQUIRE( standard_card.getChoiceCount() == 1 );
+        REQUIRE( standard_card.getChoice( 0 ) == "Jupiter" );
+
+        REQUIRE( image_quiz_card.getChoiceCount() == 4 );
+        REQUIRE( image_quiz_card.getChoice( 3 ) == "Red" );
+        vector<string> choices;
+        for ( size_t i = 0; i < image_quiz_card.getChoiceCount(); ++i ) {
+            choices.push_back( image_quiz_card.getChoice( i ) );
+        }
 
         REQUIRE_FALSE( find( choices.begin(), choices.end(), "Red" ) == choices.end() );
         REQUIRE_FALSE( find( choices.begin(), choices.end(), "Blue" ) == choices.end() );
         REQUIRE_FALSE( find( choices.begin(), choices.end(), "Green" ) == choices.end() );
         REQUIRE_FALSE( find( choices.begin(), choices.end(), "Yellow" ) == choices.end() );
     }
-}
\ No newline at end of file
+
+    SECTION( "Shuffled Choices" ) {
+        mt19937 rng( 7 );
+        ChoiceOrder order = image_quiz_card.shuffleChoices( rng );
+        REQUIRE( order.size == 4 );
+        vector<int> positions( order.positions.begin(), order.positions.begin() + order.size );
+        sort( positions.begin(), positions.end() );
+        REQUIRE( positions == vector<int>{ 0, 1, 2, 3 } );
+
+        // the same seed gives the same order
+        mt19937 first( 11 );
+        mt19937 second( 11 );
+        REQUIRE( image_quiz_card.shuffleChoices( first ).positions ==
+                 image_quiz_card.shuffleChoices( second ).positions );
+
+        // chi-squared test on the correct answer's position, 3 degrees of freedom, p = 0.001
+        static constexpr int ROUNDS = 40000;
+        array<int, 4> counts{};
+        for ( int i = 0; i < ROUNDS; ++i ) {
+            ChoiceOrder shuffled = image_quiz_card.shuffleChoices( rng );
+            for ( size_t p = 0; p < shuffled.size; ++p ) {
+                if ( shuffled.positions[p] == 3 ) ++counts[p];
+            }
+        }
+        double expected = ROUNDS / 4.0;
+        double chi_squared = 0;
+        for ( int count : counts ) {
+            chi_squared += ( count - expected ) * ( count - expected ) / expected;
+        }
+        INFO( "Counts: " << counts[0] << " " << counts[1] << " " << counts[2] << " " << counts[3] );
+        REQUIRE( chi_squared < 16.27 );
+    }
+
+    SECTION( "Choices Are Capped" ) {
+        CardData many = quiz_data;
+        many.wrong_answers.assign( 40, "Wrong" );
+        Card card( many );
+        REQUIRE( card.getChoiceCount() == ChoiceOrder::MAX_CHOICES );
+        REQUIRE( card.getChoice( ChoiceOrder::MAX_CHOICES - 1 ) == "Red" );
+    }
+}
+
+TEST_CASE( "Answer checking throughput", "[.][benchmark]" ) {
+    vector<pair<string, string>> answers = { { "Jupiter", "JUPITER" },
+                                             { "Żółw", "żółw" },
+                                             { "Straße", "STRASSE" },
+                                             { "Ελληνικά", "ΕΛΛΗΝΙΚΆ" },
+                                             { "Привет", "привет" },
+                                             { "こんにちは", "こんにちは" } };
+    vector<Card> cards;
+    for ( const auto& [correct, typed] : answers ) {
+        CardData data;
+        data.id = static_cast<int>( cards.size() );
+        data.set_id = 1;
+        data.question = TextContent{ "Q" };
+        data.correct_answer = correct;
+        cards.emplace_back( data );
+    }
+
+    BENCHMARK( "normalize the typed answer and compare keys" ) {
+        int correct = 0;
+        for ( size_t i = 0; i < cards.size(); ++i ) {
+            correct += cards[i].checkAnswer( answers[i].second );
+        }
+        return correct;
+    };
+
+    vector<string> typed_keys;
+    for ( const auto& [correct, typed] : answers ) {
+        typed_keys.push_back( Card::normalizeAnswer( typed ) );
+    }
+    BENCHMARK( "compare precomputed keys" ) {
+        int correct = 0;
+        for ( size_t i = 0; i < cards.size(); ++i ) {
+            correct += cards[i].getAnswerKeys().front() == typed_keys[i];
+        }
+        return correct;
+    };
+}
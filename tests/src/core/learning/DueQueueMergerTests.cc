@@ -0,0 +1,122 @@
+#include <catch2/catch_test_macros.hpp>
+#include <QDir>
+#include <string>
+#include <vector>
+
+#include "core/learning/DueQueueMerger.h"
+#include "core/learning/LearningSession.h"
+#include "core/learning/strategies/SelectionStrategies.h"
+#include "db/DatabaseManager.h"
+
+using namespace std;
+
+// questions of the merged cards, which name the set and the card
+static vector<string> questions( const vector<ScheduledCard>& cards ) {
+    vector<string> result;
+    for ( const ScheduledCard& scheduled : cards ) {
+        result.push_back( scheduled.card.getQuestion() );
+    }
+    return result;
+}
+
+TEST_CASE( "Due queue merge across sets", "[DueQueueMerger]" ) {
+    QString test_db_name = "merge_test_db.sqlite";
+    DatabaseManager db( test_db_name );
+    REQUIRE( db.connect() );
+    REQUIRE( db.createTables() );
+    db.flushData();
+
+    // days overdue of each card, -1 for a new card and a negative number below that for a card
+    // that is not due yet
+    vector<pair<string, vector<int>>> sets = {
+        { "A", { 5, 1, -7 } }, { "B", { 3, 2, -1 } }, { "C", { 10, -1 } } };
+    vector<int> set_ids;
+    for ( const auto& [name, overdue] : sets ) {
+        vector<DraftCard> drafts;
+        for ( size_t i = 0; i < overdue.size(); ++i ) {
+            drafts.push_back( { TextContent{ name + to_string( i ) }, "A" } );
+        }
+        REQUIRE( db.createSet( name, drafts ) );
+        int set_id = db.getAllSets()[0].id;
+        set_ids.push_back( set_id );
+
+        vector<Card> cards = db.getCardsForSet( set_id );
+        for ( size_t i = 0; i < overdue.size(); ++i ) {
+            if ( overdue[i] == -1 ) continue;
+            REQUIRE( db.updateCardProgress( cards[i].getId(), 6, 2, 2.5f,
+                                            DatabaseManager::calculateNextDate( -overdue[i] ) ) );
+        }
+    }
+
+    SECTION( "Overdue keys follow the due queue order" ) {
+        vector<ScheduledCard> due = db.getDueScheduledCards( set_ids[2], 10 );
+        REQUIRE( due.size() == 2 );
+        REQUIRE( DueQueueMerger::overdueDays( due[0] ) > DueQueueMerger::overdueDays( due[1] ) );
+        REQUIRE( DueQueueMerger::overdueDays( due[1] ) == 10 );
+    }
+
+    SECTION( "New cards first, then the most overdue of any set" ) {
+        DueQueueMerger merger( db, set_ids, 10 );
+        REQUIRE( merger.loadedCount() == 0 );
+        vector<ScheduledCard> first = merger.take( 3 );
+        vector<ScheduledCard> rest = merger.take( 100 );
+        REQUIRE( questions( first ) == vector<string>{ "B2", "C1", "C0" } );
+        REQUIRE( questions( rest ) == vector<string>{ "A0", "B0", "B1", "A1" } );
+        REQUIRE( merger.take( 1 ).empty() );
+    }
+
+    SECTION( "Each set gives at most its cap" ) {
+        DueQueueMerger merger( db, set_ids, 1 );
+        REQUIRE( questions( merger.take( 10 ) ) == vector<string>{ "B2", "C1", "A0" } );
+    }
+
+    SECTION( "Sets are read only as far as the merge goes" ) {
+        DueQueueMerger merger( db, set_ids, 10 );
+        merger.take( 3 );
+        // a card of every set to start, then a page of B and of C as their first cards are taken
+        REQUIRE( merger.loadedCount() == 6 );
+        REQUIRE( DueQueueMerger( db, {}, 10 ).take( 5 ).empty() );
+    }
+
+    SECTION( "The merge read as a strategy" ) {
+        MergedDueStrategy strategy( set_ids, 10 );
+        strategy.open( db, -1 );
+        REQUIRE( strategy.remaining() == 0 );
+        REQUIRE( questions( strategy.fetch( 3 ) ) == vector<string>{ "B2", "C1", "C0" } );
+        // six rows read and three of them taken, nothing else is known yet
+        REQUIRE( strategy.remaining() == 3 );
+        REQUIRE( strategy.fetch( 100 ).size() == 4 );
+        REQUIRE( strategy.remaining() == 0 );
+    }
+
+    SECTION( "A session over several sets" ) {
+        LearningSession session( db );
+        session.start( set_ids, 5, 2 );
+        vector<int> seen_sets;
+        do {
+            seen_sets.push_back( session.getCurrentCard().getSetId() );
+            session.submitGrade( 5 );
+        } while ( session.nextCard() );
+        REQUIRE( seen_sets == vector<int>{ set_ids[1], set_ids[2], set_ids[2], set_ids[0],
+                                           set_ids[1] } );
+        REQUIRE( session.getProgress() == LearningSession::FULL_PROGRESS );
+    }
+
+    SECTION( "An unlimited session over several sets" ) {
+        LearningSession session( db );
+        session.start( set_ids, LearningSession::UNLIMITED, 1 );
+        int shown = 1;
+        while ( session.nextCard() ) ++shown;
+        REQUIRE( shown == 3 );
+
+        session.start( set_ids, LearningSession::UNLIMITED, LearningSession::UNLIMITED );
+        shown = 0;
+        do {
+            ++shown;
+            session.submitGrade( 5 );
+        } while ( session.nextCard() );
+        REQUIRE( shown == 7 );
+    }
+
+    QFile::remove( QDir::current().filePath( "data/" + test_db_name ) );
+}
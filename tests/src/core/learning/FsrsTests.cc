@@ -0,0 +1,181 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "core/learning/Fsrs.h"
+#include "core/learning/FsrsOptimizer.h"
+#include "core/learning/schedulers/Schedulers.h"
+
+using namespace std;
+using Catch::Matchers::WithinAbs;
+
+// reviews of cards_count cards by a learner whose memory follows truth, taken near the intervals
+// FSRS proposes; some reviews come early, some late
+static vector<ReviewRecord> simulateHistory( const Fsrs::Weights& truth, int cards_count,
+                                             int reviews_per_card, unsigned seed ) {
+    mt19937 rng( seed );
+    uniform_real_distribution<double> uniform( 0.0, 1.0 );
+    vector<ReviewRecord> history;
+    history.reserve( static_cast<size_t>( cards_count ) * reviews_per_card );
+
+    for ( int card = 0; card < cards_count; ++card ) {
+        FsrsState memory;
+        int elapsed = -1;
+        for ( int r = 0; r < reviews_per_card; ++r ) {
+            double roll = uniform( rng );
+            int rating = roll < 0.3 ? Fsrs::AGAIN : roll < 0.4 ? Fsrs::HARD
+                                                 : roll < 0.9 ? Fsrs::GOOD
+                                                              : Fsrs::EASY;
+            if ( elapsed >= 0 ) {
+                double recall = Fsrs::retrievability( elapsed, static_cast<double>(
+                                                                   memory.stability ) );
+                roll = uniform( rng );
+                rating = uniform( rng ) > recall ? Fsrs::AGAIN
+                         : roll < 0.15           ? Fsrs::HARD
+                         : roll < 0.9            ? Fsrs::GOOD
+                                                 : Fsrs::EASY;
+            }
+            history.push_back( { card, rating, elapsed } );
+            memory = Fsrs::review( truth, memory, elapsed, rating );
+            int interval = Fsrs::nextInterval( memory.stability );
+            elapsed = max( 1, static_cast<int>( lround( interval * ( 0.5 + uniform( rng ) ) ) ) );
+        }
+    }
+    return history;
+}
+
+// a learner who forgets faster than the default model expects
+static Fsrs::Weights slowerLearner() {
+    Fsrs::Weights truth = Fsrs::DEFAULT_WEIGHTS;
+    truth[0] = 0.3;
+    truth[2] = 2.0;
+    truth[3] = 7.0;
+    truth[8] = 1.2;
+    truth[11] = 1.5;
+    return truth;
+}
+
+TEST_CASE( "FSRS memory model", "[Fsrs]" ) {
+    const Fsrs::Weights& w = Fsrs::DEFAULT_WEIGHTS;
+
+    SECTION( "Grades map to ratings" ) {
+        REQUIRE( Fsrs::ratingOfGrade( 0 ) == Fsrs::AGAIN );
+        REQUIRE( Fsrs::ratingOfGrade( 2 ) == Fsrs::AGAIN );
+        REQUIRE( Fsrs::ratingOfGrade( 3 ) == Fsrs::HARD );
+        REQUIRE( Fsrs::ratingOfGrade( 4 ) == Fsrs::GOOD );
+        REQUIRE( Fsrs::ratingOfGrade( 5 ) == Fsrs::EASY );
+    }
+
+    SECTION( "First review starts from the rating's weights" ) {
+        FsrsState good = Fsrs::review( w, {}, -1, Fsrs::GOOD );
+        REQUIRE_THAT( good.stability, WithinAbs( w[2], 1e-5 ) );
+        REQUIRE_THAT( good.difficulty, WithinAbs( w[4], 1e-5 ) );
+        FsrsState again = Fsrs::review( w, {}, -1, Fsrs::AGAIN );
+        REQUIRE( again.difficulty > good.difficulty );
+    }
+
+    SECTION( "Recall is 90% after one stability" ) {
+        REQUIRE_THAT( Fsrs::retrievability( 10.0, 10.0 ), WithinAbs( 0.9, 1e-9 ) );
+        REQUIRE( Fsrs::nextInterval( 10.0f ) == 10 );
+        REQUIRE( Fsrs::nextInterval( 10.0f, 0.8 ) > 10 );
+        REQUIRE( Fsrs::nextInterval( 0.2f ) == 1 );
+        REQUIRE( Fsrs::nextInterval( 1e9f ) == Fsrs::MAX_INTERVAL );
+    }
+
+    SECTION( "Recall grows stability, a lapse shrinks it" ) {
+        FsrsState state{ 10.0f, 5.0f };
+        FsrsState hard = Fsrs::review( w, state, 10, Fsrs::HARD );
+        FsrsState good = Fsrs::review( w, state, 10, Fsrs::GOOD );
+        FsrsState easy = Fsrs::review( w, state, 10, Fsrs::EASY );
+        FsrsState again = Fsrs::review( w, state, 10, Fsrs::AGAIN );
+        REQUIRE( hard.stability > state.stability );
+        REQUIRE( good.stability > hard.stability );
+        REQUIRE( easy.stability > good.stability );
+        REQUIRE( again.stability < state.stability );
+        REQUIRE( again.difficulty > good.difficulty );
+
+        // a later successful review says more about memory than an early one
+        REQUIRE( Fsrs::review( w, state, 20, Fsrs::GOOD ).stability > good.stability );
+    }
+
+    SECTION( "Difficulty stays in range" ) {
+        FsrsState state = Fsrs::review( w, {}, -1, Fsrs::AGAIN );
+        for ( int i = 0; i < 50; ++i ) state = Fsrs::review( w, state, 1, Fsrs::AGAIN );
+        REQUIRE( state.difficulty <= Fsrs::MAX_DIFFICULTY );
+        for ( int i = 0; i < 50; ++i ) state = Fsrs::review( w, state, 1, Fsrs::EASY );
+        REQUIRE( state.difficulty >= Fsrs::MIN_DIFFICULTY );
+    }
+
+    SECTION( "Scheduler picks up cards reviewed by SM-2" ) {
+        FsrsScheduler scheduler;
+        ScheduledCard fresh{ Card( CardData() ), SuperMemo::getInitialState() };
+        ReviewOutcome first = scheduler.review( fresh, 4 );
+        REQUIRE_THAT( first.memory.stability, WithinAbs( w[2], 1e-5 ) );
+        REQUIRE( first.state.interval == Fsrs::nextInterval( first.memory.stability ) );
+        REQUIRE( first.state.repetitions == 1 );
+
+        ScheduledCard mature{ Card( CardData() ), { 30, 5, 2.5f } };
+        mature.elapsed_days = 30;
+        ReviewOutcome next = scheduler.review( mature, 5 );
+        REQUIRE( next.state.interval > 30 );
+        REQUIRE( next.state.easiness == 2.5f );
+        REQUIRE( scheduler.review( mature, 1 ).state.repetitions == 0 );
+    }
+}
+
+TEST_CASE( "FSRS optimizer", "[Fsrs]" ) {
+    Fsrs::Weights truth = slowerLearner();
+    vector<ReviewRecord> history = simulateHistory( truth, 2000, 8, 7 );
+
+    SECTION( "Fitted weights explain the history better than the defaults" ) {
+        FsrsFit fit = FsrsOptimizer::optimize( history );
+        REQUIRE_THAT( fit.initial_loss,
+                      WithinAbs( FsrsOptimizer::loss( history, Fsrs::DEFAULT_WEIGHTS ), 1e-9 ) );
+        REQUIRE_THAT( fit.loss, WithinAbs( FsrsOptimizer::loss( history, fit.weights ), 1e-9 ) );
+        REQUIRE( fit.loss < fit.initial_loss );
+        // within a small margin of the weights that generated the history
+        REQUIRE( fit.loss < FsrsOptimizer::loss( history, truth ) + 0.005 );
+        REQUIRE( fit.weights[2] < Fsrs::DEFAULT_WEIGHTS[2] );
+        for ( size_t i = 0; i < Fsrs::WEIGHT_COUNT; ++i ) {
+            REQUIRE( fit.weights[i] >= Fsrs::MIN_WEIGHTS[i] );
+            REQUIRE( fit.weights[i] <= Fsrs::MAX_WEIGHTS[i] );
+        }
+    }
+
+    SECTION( "Thread count does not change the result" ) {
+        FsrsFitOptions single;
+        single.threads = 1;
+        FsrsFitOptions parallel;
+        parallel.threads = 4;
+        FsrsFit a = FsrsOptimizer::optimize( history, Fsrs::DEFAULT_WEIGHTS, single );
+        FsrsFit b = FsrsOptimizer::optimize( history, Fsrs::DEFAULT_WEIGHTS, parallel );
+        REQUIRE_THAT( a.loss, WithinAbs( b.loss, 1e-6 ) );
+        for ( size_t i = 0; i < Fsrs::WEIGHT_COUNT; ++i ) {
+            REQUIRE_THAT( a.weights[i], WithinAbs( b.weights[i], 1e-4 ) );
+        }
+    }
+
+    SECTION( "A short history keeps the starting weights" ) {
+        vector<ReviewRecord> few( history.begin(), history.begin() + 40 );
+        FsrsFit fit = FsrsOptimizer::optimize( few );
+        REQUIRE( fit.weights == Fsrs::DEFAULT_WEIGHTS );
+        REQUIRE( FsrsOptimizer::optimize( {} ).predictions == 0 );
+    }
+}
+
+TEST_CASE( "FSRS optimizer on a million reviews", "[.][benchmark]" ) {
+    vector<ReviewRecord> history = simulateHistory( slowerLearner(), 100000, 10, 11 );
+
+    auto start = chrono::steady_clock::now();
+    FsrsFit fit = FsrsOptimizer::optimize( history );
+    auto elapsed = chrono::steady_clock::now() - start;
+    auto ms = chrono::duration_cast<chrono::milliseconds>( elapsed ).count();
+
+    WARN( "Fitted " << history.size() << " reviews in " << ms << " ms, log loss "
+                    << fit.initial_loss << " -> " << fit.loss );
+    REQUIRE( fit.loss < fit.initial_loss );
+}
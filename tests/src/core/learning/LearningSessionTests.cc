@@ -1,12 +1,16 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <QFile>
 #include <QDir>
 #include <memory>
 #include <iostream>
 #include <variant>
+#include <algorithm>
+#include <chrono>
 
 #include "core/learning/LearningSession.h"
+#include "core/learning/schedulers/Schedulers.h"
 #include "core/learning/strategies/SelectionStrategies.h"
 #include "db/DatabaseManager.h"
 #include "core/learning/Card.h"
@@ -24,12 +28,36 @@ Card create_test_card( int id, const string& question ) {
     return Card( data );
 }
 
+// a clock the test moves by hand
+class FakeClock : public ISessionClock {
+public:
+    explicit FakeClock( TimePoint& now ) : now_( now ) {}
+    TimePoint now() const override { return now_; }
+
+private:
+    TimePoint& now_;
+};
+
+// hands out the cards in order, counting the fetches when given a counter
 class MockSelectionStrategy : public ICardSelectionStrategy {
     vector<Card> cards_to_return;
+    size_t next = 0;
+    int* fetches;
 
 public:
-    MockSelectionStrategy( vector<Card> cards ) : cards_to_return( cards ) {}
-    vector<Card> selectCards( DatabaseManager&, int, int ) override { return cards_to_return; }
+    MockSelectionStrategy( vector<Card> cards, int* fetches = nullptr )
+        : cards_to_return( cards ), fetches( fetches ) {}
+    void open( DatabaseManager&, int ) override { next = 0; }
+    vector<ScheduledCard> fetch( int count ) override {
+        if ( fetches ) ++*fetches;
+        vector<ScheduledCard> scheduled;
+        for ( ; next < cards_to_return.size() && static_cast<int>( scheduled.size() ) < count;
+              ++next ) {
+            scheduled.push_back( { cards_to_return[next], SuperMemo::getInitialState() } );
+        }
+        return scheduled;
+    }
+    size_t remaining() const override { return cards_to_return.size() - next; }
 };
 
 TEST_CASE( "LearningSession Integration Tests", "[LearningSession]" ) {
@@ -99,16 +127,262 @@ TEST_CASE( "LearningSession Integration Tests", "[LearningSession]" ) {
 
         session.start( 1, make_unique<MockSelectionStrategy>( single_card ) );
 
+        const Card* first_pass = &session.getCurrentCard();
         session.submitGrade( 1 );
 
         REQUIRE( session.nextCard() == true );
         REQUIRE( session.getCurrentCard().getId() == 1 );
+        // a failed card is queued again by index, the same object comes back
+        REQUIRE( &session.getCurrentCard() == first_pass );
 
         auto [iv, rep, ef] = db.getCardProgress( 1 );
         REQUIRE( iv == 1 );
         REQUIRE( rep == 0 );
 
+        // the retry is graded from the state kept in the session, which matches the stored one
         session.submitGrade( 4 );
         REQUIRE_FALSE( session.nextCard() );
+        SuperMemoState expected =
+            SuperMemo::calculate( 4, SuperMemo::calculate( 1, SuperMemo::getInitialState() ) );
+        auto [iv2, rep2, ef2] = db.getCardProgress( 1 );
+        REQUIRE( iv2 == expected.interval );
+        REQUIRE( rep2 == expected.repetitions );
+        REQUIRE_THAT( ef2, Catch::Matchers::WithinAbs( expected.easiness, 1e-5 ) );
+    }
+
+    SECTION( "Failed Cards Come Back Early When Nothing Else Is Left" ) {
+        ISessionClock::TimePoint now;
+        LearningSession session( db );
+        session.setClock( make_unique<FakeClock>( now ) );
+        session.start( 1, make_unique<MockSelectionStrategy>( memory_cards ) );
+
+        vector<int> order;
+        vector<int> grades = { 1, 5, 2, 5, 5 };
+        for ( int grade : grades ) {
+            order.push_back( session.getCurrentCard().getId() );
+            session.submitGrade( grade );
+            if ( !session.nextCard() ) break;
+        }
+        REQUIRE( order == vector<int>{ 1, 2, 3, 1, 3 } );
+        REQUIRE_FALSE( session.nextCard() );
+        REQUIRE_THROWS( session.getCurrentCard() );
+    }
+
+    SECTION( "Failed Cards Return After Their Learning Step" ) {
+        vector<Card> many = memory_cards;
+        for ( int id = 4; id <= 8; ++id ) {
+            add_db_card( "Q" + to_string( id ), "A" );
+            many.push_back( create_test_card( id, "Q" + to_string( id ) ) );
+        }
+        ISessionClock::TimePoint now;
+        LearningSession session( db );
+        REQUIRE_THROWS( session.setClock( nullptr ) );
+        session.setClock( make_unique<FakeClock>( now ) );
+        session.setRelearningOptions( { { chrono::minutes( 1 ), chrono::minutes( 10 ) }, 1 } );
+        session.start( 1, make_unique<MockSelectionStrategy>( many ) );
+        REQUIRE( session.getProgress() == LearningSession::NO_PROGRESS );
+
+        // one card every 20 seconds; card 1 fails twice, the second time for ten minutes
+        vector<int> order;
+        do {
+            int id = session.getCurrentCard().getId();
+            bool first_lapse = id == 1 && order.empty();
+            bool second_lapse = id == 1 && count( order.begin(), order.end(), 1 ) == 1;
+            order.push_back( id );
+            session.submitGrade( first_lapse || second_lapse ? 1 : 5 );
+            now += chrono::seconds( 20 );
+        } while ( session.nextCard() );
+
+        // due a minute after failing, ahead of the cards not seen yet; then back once the rest
+        // is done, as nothing else is left to show
+        REQUIRE( order == vector<int>{ 1, 2, 3, 1, 4, 5, 6, 7, 8, 1 } );
+        REQUIRE( session.getProgress() == LearningSession::FULL_PROGRESS );
     }
-}
\ No newline at end of file
+
+    SECTION( "Cards Are Fetched A Page Ahead Of Use" ) {
+        vector<Card> many = memory_cards;
+        for ( int id = 4; id <= 25; ++id ) {
+            add_db_card( "Q" + to_string( id ), "A" );
+            many.push_back( create_test_card( id, "Q" + to_string( id ) ) );
+        }
+        int fetches = 0;
+        LearningSession session( db );
+        session.start( 1, make_unique<MockSelectionStrategy>( many, &fetches ),
+                       LearningSession::UNLIMITED );
+        REQUIRE( fetches == 1 );
+
+        int shown = 0;
+        do {
+            REQUIRE( session.getCurrentCard().getId() == ++shown );
+            session.submitGrade( 5 );
+            // the next page is fetched only when every card fetched so far was shown
+            REQUIRE( fetches == ( shown + LearningSession::PAGE_SIZE - 1 ) /
+                                    LearningSession::PAGE_SIZE );
+            if ( shown == 1 ) {
+                // cards not fetched yet count towards the progress
+                REQUIRE_THAT( session.getProgress(),
+                              Catch::Matchers::WithinAbs( 1.0f / 25, 1e-5 ) );
+            }
+        } while ( session.nextCard() );
+        REQUIRE( shown == 25 );
+        REQUIRE( fetches == 3 );
+        REQUIRE( session.getProgress() == LearningSession::FULL_PROGRESS );
+    }
+
+    SECTION( "The Limit Caps The Cards Fetched" ) {
+        vector<Card> many = memory_cards;
+        for ( int id = 4; id <= 25; ++id ) {
+            add_db_card( "Q" + to_string( id ), "A" );
+            many.push_back( create_test_card( id, "Q" + to_string( id ) ) );
+        }
+        int fetches = 0;
+        LearningSession session( db );
+        session.start( 1, make_unique<MockSelectionStrategy>( many, &fetches ), 12 );
+        session.submitGrade( 5 );
+        REQUIRE_THAT( session.getProgress(), Catch::Matchers::WithinAbs( 1.0f / 12, 1e-5 ) );
+
+        int shown = 1;
+        while ( session.nextCard() ) {
+            ++shown;
+            session.submitGrade( 5 );
+        }
+        REQUIRE( shown == 12 );
+        REQUIRE( fetches == 2 );
+        REQUIRE( session.getProgress() == LearningSession::FULL_PROGRESS );
+    }
+
+    SECTION( "FSRS Scheduler Logs Every Review" ) {
+        LearningSession session( db );
+        REQUIRE_THROWS( session.setScheduler( nullptr ) );
+        session.setScheduler( make_unique<FsrsScheduler>() );
+        session.start( 1, make_unique<MockSelectionStrategy>( memory_cards ) );
+        size_t logged = db.getReviewHistory().size();
+
+        session.submitGrade( 4 );
+        auto [iv, rep, ef] = db.getCardProgress( 1 );
+        REQUIRE( iv == Fsrs::nextInterval( Fsrs::DEFAULT_WEIGHTS[Fsrs::GOOD - 1] ) );
+        REQUIRE( rep == 1 );
+
+        // the failed card comes back the same day and is logged with 0 elapsed days
+        REQUIRE( session.nextCard() );
+        session.submitGrade( 1 );
+        REQUIRE( session.nextCard() );
+        REQUIRE( session.nextCard() );
+        REQUIRE( session.getCurrentCard().getId() == 2 );
+        session.submitGrade( 4 );
+
+        vector<ReviewRecord> history = db.getReviewHistory();
+        REQUIRE( history.size() == logged + 3 );
+        auto second = find_if( history.begin(), history.end(), []( const ReviewRecord& r ) {
+            return r.card_id == 2 && r.elapsed_days == 0;
+        } );
+        REQUIRE( second != history.end() );
+        REQUIRE( second->rating == Fsrs::GOOD );
+    }
+}
+
+TEST_CASE( "Saved reviews keep the SM-2 state and the log", "[LearningSession]" ) {
+    DatabaseManager db( "test_grading.db" );
+    REQUIRE( db.connect() );
+    REQUIRE( db.createTables() );
+    db.flushData();
+
+    vector<DraftCard> drafts = { { TextContent{ "G1" }, "A1" } };
+    REQUIRE( db.createSet( "Grading Set", drafts ) );
+    int card_id = db.getCardsForSet( db.getAllSets()[0].id )[0].getId();
+    size_t logged = db.getReviewHistory().size();
+
+    // SM-2 runs only in SuperMemo::calculate, the database stores what it returns
+    SuperMemoState expected = SuperMemo::getInitialState();
+    vector<int> grades = { 5, 4, 3, 5, 1, 4, 5, 5 };
+    int elapsed = -1;
+    for ( int grade : grades ) {
+        expected = SuperMemo::calculate( grade, expected );
+        REQUIRE( db.saveReview( card_id, grade, elapsed, expected, FsrsState{} ) );
+        elapsed = expected.interval;
+    }
+
+    auto [iv, rep, ef] = db.getCardProgress( card_id );
+    REQUIRE( iv == expected.interval );
+    REQUIRE( rep == expected.repetitions );
+    REQUIRE_THAT( ef, Catch::Matchers::WithinAbs( expected.easiness, 1e-5 ) );
+    REQUIRE( db.getReviewHistory().size() == logged + grades.size() );
+
+    QFile::remove( QDir::current().filePath( "data/test_grading.db" ) );
+}
+
+TEST_CASE( "Grading throughput", "[.][benchmark]" ) {
+    DatabaseManager db( "bench_grading.db" );
+    REQUIRE( db.connect() );
+    REQUIRE( db.createTables() );
+    db.flushData();
+
+    vector<DraftCard> drafts;
+    for ( int i = 0; i < 100; ++i ) {
+        drafts.push_back( { TextContent{ "B" + to_string( i ) }, "A" } );
+    }
+    REQUIRE( db.createSet( "Benchmark Set", drafts ) );
+    vector<Card> cards = db.getCardsForSet( db.getAllSets()[0].id );
+    size_t next = 0;
+
+    BENCHMARK( "read, calculate, write" ) {
+        int card_id = cards[next++ % cards.size()].getId();
+        auto [iv, rep, ef] = db.getCardProgress( card_id );
+        SuperMemoState state = SuperMemo::calculate( 4, { iv, rep, ef } );
+        return db.updateCardProgress( card_id, state.interval, state.repetitions, state.easiness,
+                                      DatabaseManager::calculateNextDate( state.interval ) );
+    };
+
+    // the session keeps every card's state, so grading is a calculation and a single UPSERT
+    // whose trigger also logs the review
+    vector<SuperMemoState> states( cards.size(), SuperMemo::getInitialState() );
+    BENCHMARK( "calculate from the session state, one-statement saveReview" ) {
+        size_t i = next++ % cards.size();
+        states[i] = SuperMemo::calculate( 4, states[i] );
+        return db.saveReview( cards[i].getId(), 4, 1, states[i], FsrsState{} );
+    };
+
+    QFile::remove( QDir::current().filePath( "data/bench_grading.db" ) );
+}
+
+TEST_CASE( "Session grading with prefetched progress", "[.][benchmark]" ) {
+    static constexpr int SESSION_CARDS = 20;
+
+    DatabaseManager db( "bench_session.db" );
+    REQUIRE( db.connect() );
+    REQUIRE( db.createTables() );
+    db.flushData();
+
+    vector<DraftCard> drafts;
+    for ( int i = 0; i < SESSION_CARDS; ++i ) {
+        drafts.push_back( { TextContent{ "S" + to_string( i ) }, "A" } );
+    }
+    REQUIRE( db.createSet( "Session Set", drafts ) );
+    int set_id = db.getAllSets()[0].id;
+
+    // one selection, then a progress read and a write per grade against a write only; the random
+    // strategy reads its cards by id as it goes, so its selection is a lookup per card
+    WARN( "Statements per " << SESSION_CARDS << " card session: "
+                            << 1 + 2 * SESSION_CARDS << " reading progress per grade, "
+                            << 1 + SESSION_CARDS << " with prefetched progress and "
+                            << SESSION_CARDS << " primary key lookups" );
+
+    BENCHMARK( "session reading progress per grade" ) {
+        for ( const Card& card : db.getRandomCards( set_id, SESSION_CARDS ) ) {
+            auto [iv, rep, ef] = db.getCardProgress( card.getId() );
+            SuperMemoState state = SuperMemo::calculate( 4, { iv, rep, ef } );
+            db.updateCardProgress( card.getId(), state.interval, state.repetitions, state.easiness,
+                                   DatabaseManager::calculateNextDate( state.interval ) );
+        }
+    };
+
+    BENCHMARK( "session with prefetched progress" ) {
+        LearningSession session( db );
+        session.start( set_id, make_unique<RandomSelectionStrategy>(), SESSION_CARDS );
+        do {
+            session.submitGrade( 4 );
+        } while ( session.nextCard() );
+    };
+
+    QFile::remove( QDir::current().filePath( "data/bench_session.db" ) );
+}
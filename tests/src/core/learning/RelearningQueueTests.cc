@@ -0,0 +1,139 @@
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <vector>
+
+#include "core/learning/RelearningQueue.h"
+
+using namespace std;
+using namespace std::chrono;
+
+using TimePoint = RelearningQueue::TimePoint;
+
+// the cards shown while a learner answers one card every `pace`, failing the listed picks
+static vector<size_t> drive( RelearningQueue& queue, TimePoint& now, seconds pace,
+                             const vector<size_t>& failed_picks ) {
+    vector<size_t> shown;
+    for ( size_t card = queue.pop( now ); card != RelearningQueue::NO_CARD;
+          card = queue.pop( now ) ) {
+        bool failed = false;
+        for ( size_t pick : failed_picks ) failed = failed || pick == shown.size();
+        shown.push_back( card );
+        if ( failed ) queue.relearn( card, now );
+        now += pace;
+    }
+    return shown;
+}
+
+TEST_CASE( "Relearning queue", "[RelearningQueue]" ) {
+    TimePoint now;
+    RelearningOptions options;
+    options.steps = { minutes( 1 ), minutes( 10 ) };
+    options.min_gap = 2;
+    RelearningQueue queue( options );
+
+    SECTION( "Cards not failed are shown once in order" ) {
+        queue.reset( 4 );
+        REQUIRE( queue.size() == 4 );
+        REQUIRE( drive( queue, now, seconds( 10 ), {} ) == vector<size_t>{ 0, 1, 2, 3 } );
+        REQUIRE( queue.empty() );
+        REQUIRE( queue.pop( now ) == RelearningQueue::NO_CARD );
+    }
+
+    SECTION( "Appended cards follow the ones queued before" ) {
+        queue.reset( 2 );
+        REQUIRE( queue.pop( now ) == 0 );
+        queue.relearn( 0, now );
+        REQUIRE( queue.pop( now ) == 1 );
+        REQUIRE( queue.unseenCount() == 0 );
+
+        queue.append( 3 );
+        REQUIRE( queue.unseenCount() == 3 );
+        REQUIRE( queue.size() == 4 );
+        // card 0 is not due yet, the new cards come first and can fail like any other
+        REQUIRE( queue.pop( now ) == 2 );
+        queue.relearn( 2, now );
+        REQUIRE( drive( queue, now, seconds( 10 ), {} ) == vector<size_t>{ 3, 4, 0, 2 } );
+    }
+
+    SECTION( "A failed card comes back when its step is over, not after the whole session" ) {
+        queue.reset( 500 );
+        vector<size_t> shown = drive( queue, now, seconds( 10 ), { 0 } );
+        REQUIRE( shown.size() == 501 );
+        // failed at 0 s, due at 60 s, which is the seventh pick
+        REQUIRE( shown[6] == 0 );
+        REQUIRE( shown[5] == 5 );
+        REQUIRE( shown[7] == 6 );
+    }
+
+    SECTION( "Further failures wait for the later steps" ) {
+        queue.reset( 200 );
+        // card 0 fails at its first and second showing, the second step is ten minutes
+        vector<size_t> shown = drive( queue, now, seconds( 10 ), { 0, 6 } );
+        REQUIRE( shown[6] == 0 );
+        REQUIRE( shown[66] == 0 );
+        REQUIRE( shown.size() == 202 );
+
+        // a third failure reuses the last step
+        queue.reset( 200 );
+        now = TimePoint();
+        shown = drive( queue, now, seconds( 10 ), { 0, 6, 66 } );
+        REQUIRE( shown[126] == 0 );
+    }
+
+    SECTION( "Cards due at the same time come back in the order they failed" ) {
+        queue.reset( 6 );
+        vector<size_t> shown;
+        for ( int i = 0; i < 3; ++i ) {
+            shown.push_back( queue.pop( now ) );
+            queue.relearn( shown.back(), now );
+        }
+        now += minutes( 5 );
+        for ( size_t card = queue.pop( now ); card != RelearningQueue::NO_CARD;
+              card = queue.pop( now ) ) {
+            shown.push_back( card );
+        }
+        REQUIRE( shown == vector<size_t>{ 0, 1, 2, 0, 1, 2, 3, 4, 5 } );
+    }
+
+    SECTION( "The gap keeps a due card away while other cards are left" ) {
+        options.steps = { minutes( 0 ) };
+        options.min_gap = 3;
+        queue.setOptions( options );
+        queue.reset( 5 );
+        // due again at once, yet three other cards come first
+        REQUIRE( drive( queue, now, seconds( 10 ), { 0 } ) == vector<size_t>{ 0, 1, 2, 3, 0, 4 } );
+
+        queue.reset( 2 );
+        // with nothing else left the gap gives way
+        REQUIRE( drive( queue, now, seconds( 10 ), { 0, 2 } ) == vector<size_t>{ 0, 1, 0, 0 } );
+    }
+
+    SECTION( "Failed cards are shown ahead of time once nothing else is left" ) {
+        queue.reset( 3 );
+        REQUIRE( drive( queue, now, seconds( 1 ), { 0, 2 } ) == vector<size_t>{ 0, 1, 2, 0, 2 } );
+    }
+}
+
+TEST_CASE( "Relearning queue picks", "[.][benchmark]" ) {
+    const size_t cards = 1000000;
+    TimePoint now;
+    RelearningQueue queue;
+    queue.reset( cards );
+
+    // every third card fails once and waits in the heap for its minute
+    vector<bool> failed( cards, false );
+    auto start = steady_clock::now();
+    size_t picks = 0;
+    for ( size_t card = queue.pop( now ); card != RelearningQueue::NO_CARD;
+          card = queue.pop( now ) ) {
+        if ( card % 3 == 0 && !failed[card] ) {
+            failed[card] = true;
+            queue.relearn( card, now );
+        }
+        ++picks;
+        now += seconds( 1 );
+    }
+    auto ms = duration_cast<milliseconds>( steady_clock::now() - start ).count();
+    WARN( picks << " picks in " << ms << " ms" );
+    REQUIRE( picks == cards + ( cards + 2 ) / 3 );
+}
@@ -1,5 +1,6 @@
 #include <catch2/catch_test_macros.hpp>
 #include <QDir>
+#include <algorithm>
 #include <iostream>
 
 #include "core/learning/strategies/SelectionStrategies.h"
@@ -29,7 +30,7 @@ TEST_CASE( "Selection Strategies", "[Strategies]" ) {
     SECTION( "Random Selection" ) {
         RandomSelectionStrategy strategy;
 
-        vector<Card> selected = strategy.selectCards( db, set_id, 3 );
+        vector<ScheduledCard> selected = strategy.selectCards( db, set_id, 3 );
         REQUIRE( selected.size() == 3 );
 
         selected = strategy.selectCards( db, set_id, 10 );
@@ -39,7 +40,7 @@ TEST_CASE( "Selection Strategies", "[Strategies]" ) {
     SECTION( "Spaced Repetition (Due Cards)" ) {
         SpacedRepetitionStrategy strategy;
 
-        vector<Card> due = strategy.selectCards( db, set_id, 5 );
+        vector<ScheduledCard> due = strategy.selectCards( db, set_id, 5 );
 
         int c_id = db_cards[0].getId();
         db.updateCardProgress( c_id, 10, 1, 2.5, DatabaseManager::calculateNextDate( 10 ) );
@@ -48,5 +49,104 @@ TEST_CASE( "Selection Strategies", "[Strategies]" ) {
         REQUIRE( due.size() == 4 );
     }
 
+    SECTION( "Random Selection In Pages" ) {
+        RandomSelectionStrategy strategy( 7 );
+        strategy.open( db, set_id );
+        REQUIRE( strategy.remaining() == 5 );
+
+        vector<int> ids;
+        for ( size_t expected : { 2, 2, 1, 0 } ) {
+            vector<ScheduledCard> page = strategy.fetch( 2 );
+            REQUIRE( page.size() == expected );
+            for ( const auto& scheduled : page ) ids.push_back( scheduled.card.getId() );
+        }
+        REQUIRE( strategy.remaining() == 0 );
+
+        // every card once, and the same order again for the same seed
+        vector<int> sorted = ids;
+        sort( sorted.begin(), sorted.end() );
+        REQUIRE( unique( sorted.begin(), sorted.end() ) == sorted.end() );
+        REQUIRE( sorted.size() == 5 );
+        RandomSelectionStrategy same( 7 );
+        vector<ScheduledCard> again = same.selectCards( db, set_id, 5 );
+        for ( size_t i = 0; i < again.size(); ++i ) REQUIRE( again[i].card.getId() == ids[i] );
+
+        // a card deleted after open is skipped, the page is filled from the following ones
+        RandomSelectionStrategy reopened( 7 );
+        reopened.open( db, set_id );
+        REQUIRE( db.deleteCard( ids[1] ) );
+        vector<ScheduledCard> page = reopened.fetch( 3 );
+        REQUIRE( page.size() == 3 );
+        REQUIRE( page[0].card.getId() == ids[0] );
+        REQUIRE( page[1].card.getId() == ids[2] );
+        REQUIRE( page[2].card.getId() == ids[3] );
+    }
+
+    SECTION( "Spaced Repetition In Pages" ) {
+        SpacedRepetitionStrategy strategy;
+        strategy.open( db, set_id );
+        REQUIRE( strategy.remaining() == 5 );
+
+        vector<ScheduledCard> first = strategy.fetch( 2 );
+        REQUIRE( first.size() == 2 );
+        REQUIRE( strategy.remaining() == 3 );
+
+        // cards graded in the meantime leave the due queue without shifting the next page
+        for ( const auto& scheduled : first ) {
+            db.updateCardProgress( scheduled.card.getId(), 6, 2, 2.5f,
+                                   DatabaseManager::calculateNextDate( 6 ) );
+        }
+        vector<ScheduledCard> rest = strategy.fetch( 10 );
+        REQUIRE( rest.size() == 3 );
+        REQUIRE( strategy.remaining() == 0 );
+        for ( const auto& scheduled : rest ) {
+            REQUIRE( scheduled.card.getId() != first[0].card.getId() );
+            REQUIRE( scheduled.card.getId() != first[1].card.getId() );
+        }
+        REQUIRE( strategy.fetch( 10 ).empty() );
+    }
+
+    SECTION( "Due Pages Follow The Due Queue" ) {
+        // two overdue cards, one due today, one not due and a new one
+        vector<int> offsets = { -4, 0, 3, -9 };
+        for ( size_t i = 0; i < offsets.size(); ++i ) {
+            db.updateCardProgress( db_cards[i].getId(), 6, 2, 2.5f,
+                                   DatabaseManager::calculateNextDate( offsets[i] ) );
+        }
+        vector<ScheduledCard> expected = db.getDueScheduledCards( set_id, 10 );
+        REQUIRE( expected.size() == 4 );
+
+        // one card per page crosses from the new cards to the reviewed ones mid-queue
+        DueCursor after;
+        vector<int> paged;
+        for ( vector<ScheduledCard> page = db.getDueScheduledPage( set_id, after, 1 );
+              !page.empty(); page = db.getDueScheduledPage( set_id, after, 1 ) ) {
+            paged.push_back( page[0].card.getId() );
+        }
+        REQUIRE( paged.size() == expected.size() );
+        for ( size_t i = 0; i < paged.size(); ++i ) {
+            REQUIRE( paged[i] == expected[i].card.getId() );
+        }
+        REQUIRE( paged[0] == db_cards[4].getId() );
+        REQUIRE( paged[1] == db_cards[3].getId() );
+    }
+
+    SECTION( "Selected Cards Carry Their Progress" ) {
+        int c_id = db_cards[0].getId();
+        db.updateCardProgress( c_id, 10, 3, 2.1f, DatabaseManager::calculateNextDate( 10 ) );
+
+        RandomSelectionStrategy strategy;
+        for ( const auto& scheduled : strategy.selectCards( db, set_id, 10 ) ) {
+            if ( scheduled.card.getId() == c_id ) {
+                REQUIRE( scheduled.state.interval == 10 );
+                REQUIRE( scheduled.state.repetitions == 3 );
+                REQUIRE( scheduled.state.easiness == 2.1f );
+            } else {
+                REQUIRE( scheduled.state.repetitions == SuperMemo::INITIAL_REPETITIONS );
+                REQUIRE( scheduled.state.easiness == SuperMemo::INITIAL_EASINESS );
+            }
+        }
+    }
+
     QFile::remove( QDir::current().filePath( "data/" + test_db_name ) );
 }
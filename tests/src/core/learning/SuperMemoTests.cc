@@ -0,0 +1,176 @@
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "core/learning/SuperMemo.h"
+#include "core/learning/SuperMemoPolicy.h"
+
+using namespace std;
+
+// a variant with a third learning step and a higher easiness floor
+struct ThreeStepConfig : Sm2Config {
+    static constexpr array<int, 3> STEPS = { 1, 3, 8 };
+    static constexpr float MIN_EASINESS = 1.5f;
+    static constexpr int LAPSE_INTERVAL = 2;
+};
+using ThreeStep = SuperMemoPolicy<ThreeStepConfig>;
+
+// states of count cards column by column, together with the grades they get
+struct Batch {
+    vector<uint8_t> grades;
+    vector<int32_t> intervals;
+    vector<int32_t> repetitions;
+    vector<float> easiness;
+
+    void add( int grade, const SuperMemoState& state ) {
+        grades.push_back( static_cast<uint8_t>( grade ) );
+        intervals.push_back( state.interval );
+        repetitions.push_back( state.repetitions );
+        easiness.push_back( state.easiness );
+    }
+    SuperMemoState state( size_t i ) const { return { intervals[i], repetitions[i], easiness[i] }; }
+    void calculate() {
+        SuperMemo::calculateBatch( grades.size(), grades.data(), intervals.data(),
+                                   repetitions.data(), easiness.data() );
+    }
+};
+
+static Batch randomBatch( size_t count, unsigned seed ) {
+    mt19937 rng( seed );
+    Batch batch;
+    for ( size_t i = 0; i < count; ++i ) {
+        SuperMemoState state{ static_cast<int>( rng() % 1000 ), static_cast<int>( rng() % 10 ),
+                              1.3f + static_cast<float>( rng() % 20000 ) / 10000.0f };
+        batch.add( static_cast<int>( rng() % 6 ), state );
+    }
+    return batch;
+}
+
+// cards whose batch result differs from calculate in any bit
+static size_t mismatches( const Batch& before, const Batch& after ) {
+    size_t count = 0;
+    for ( size_t i = 0; i < before.grades.size(); ++i ) {
+        SuperMemoState expected = SuperMemo::calculate( before.grades[i], before.state( i ) );
+        SuperMemoState actual = after.state( i );
+        count += expected.interval != actual.interval ||
+                 expected.repetitions != actual.repetitions ||
+                 memcmp( &expected.easiness, &actual.easiness, sizeof( float ) ) != 0;
+    }
+    return count;
+}
+
+TEST_CASE( "SuperMemo-2", "[SuperMemo]" ) {
+    SECTION( "Intervals grow with repetitions, a failure starts over" ) {
+        SuperMemoState state = SuperMemo::calculate( 5, SuperMemo::getInitialState() );
+        REQUIRE( state.interval == 1 );
+        state = SuperMemo::calculate( 5, state );
+        REQUIRE( state.interval == 6 );
+        REQUIRE( state.repetitions == 2 );
+        REQUIRE( state.easiness > SuperMemo::INITIAL_EASINESS );
+        state = SuperMemo::calculate( 4, state );
+        REQUIRE( state.interval == 17 );
+
+        SuperMemoState failed = SuperMemo::calculate( 2, state );
+        REQUIRE( failed.interval == 1 );
+        REQUIRE( failed.repetitions == 0 );
+        REQUIRE( failed.easiness == state.easiness );
+        REQUIRE( SuperMemo::calculate( 3, { 10, 3, 1.3f } ).easiness == SuperMemo::MIN_EASINESS );
+    }
+
+    SECTION( "Tables are built at compile time" ) {
+        STATIC_REQUIRE( Sm2::DELTAS[0] == Sm2Config::easinessDelta( 0 ) );
+        STATIC_REQUIRE( Sm2::DELTAS[3] == Sm2Config::easinessDelta( 3 ) );
+        STATIC_REQUIRE( Sm2::DELTAS[5] == 0.1f );
+        STATIC_REQUIRE( Sm2::DELTAS[3] < Sm2::DELTAS[4] && Sm2::DELTAS[4] < Sm2::DELTAS[5] );
+        STATIC_REQUIRE( Sm2::easinessDelta( 9 ) == Sm2::DELTAS[5] );
+        STATIC_REQUIRE( Sm2::calculate( 4, Sm2::initialState() ).interval == 1 );
+        STATIC_REQUIRE( Sm2::calculate( 4, { 1, 1, 2.5f } ).interval == 6 );
+        STATIC_REQUIRE( Sm2::calculate( 4, { 6, 2, 2.5f } ).interval == 15 );
+        STATIC_REQUIRE( Sm2::calculate( 4, { 6, 2, 2.6f } ).interval == 16 );
+        STATIC_REQUIRE( Sm2::calculate( 3, { 6, 2, 1.3f } ).easiness == Sm2::MIN_EASINESS );
+        STATIC_REQUIRE( Sm2::calculate( 2, { 6, 2, 2.5f } ).interval == Sm2::LAPSE_INTERVAL );
+
+        STATIC_REQUIRE( ThreeStep::DELTAS[4] == Sm2::DELTAS[4] );
+        STATIC_REQUIRE( ThreeStep::calculate( 4, { 1, 1, 2.5f } ).interval == 3 );
+        STATIC_REQUIRE( ThreeStep::calculate( 4, { 3, 2, 2.5f } ).interval == 8 );
+        STATIC_REQUIRE( ThreeStep::calculate( 4, { 8, 3, 2.5f } ).interval == 20 );
+        STATIC_REQUIRE( ThreeStep::calculate( 3, { 8, 3, 1.5f } ).easiness == 1.5f );
+        STATIC_REQUIRE( ThreeStep::calculate( 0, { 8, 3, 2.5f } ).interval == 2 );
+    }
+
+    SECTION( "Tables match the formula evaluated at run time" ) {
+        for ( volatile int grade = 0; grade < Sm2::GRADES; ++grade ) {
+            REQUIRE( SuperMemo::easinessDelta( grade ) == Sm2Config::easinessDelta( grade ) );
+        }
+    }
+
+    SECTION( "Batch matches calculate bit for bit" ) {
+        Batch before = randomBatch( 100003, 4 );
+        Batch after = before;
+        after.calculate();
+        REQUIRE( mismatches( before, after ) == 0 );
+    }
+
+    SECTION( "Every grade and repetition edge in every lane" ) {
+        Batch before;
+        for ( int grade = 0; grade <= 5; ++grade ) {
+            for ( int repetitions = 0; repetitions <= 3; ++repetitions ) {
+                for ( float easiness : { 1.3f, 1.31f, 1.4f, 2.5f, 2.9999f } ) {
+                    for ( int interval : { 0, 1, 6, 7, 10, 100, 36500 } ) {
+                        before.add( grade, { interval, repetitions, easiness } );
+                    }
+                }
+            }
+        }
+        // every count covers a different mix of wide, narrow and scalar steps
+        for ( size_t count = 0; count <= 17; ++count ) {
+            for ( size_t offset = 0; offset + count <= before.grades.size(); offset += 29 ) {
+                Batch slice;
+                for ( size_t i = offset; i < offset + count; ++i ) {
+                    slice.add( before.grades[i], before.state( i ) );
+                }
+                Batch after = slice;
+                after.calculate();
+                REQUIRE( mismatches( slice, after ) == 0 );
+            }
+        }
+    }
+}
+
+TEST_CASE( "SuperMemo-2 batch throughput", "[.][benchmark]" ) {
+    const size_t count = 1000000;
+    const int rounds = 20;
+    Batch start = randomBatch( count, 8 );
+
+    // every round starts over from the same states, so intervals cannot overflow
+    Batch scalar;
+    Batch batch;
+    double scalar_ms = 0.0;
+    double batch_ms = 0.0;
+    for ( int round = 0; round < rounds; ++round ) {
+        scalar = start;
+        auto begin = chrono::steady_clock::now();
+        for ( size_t i = 0; i < count; ++i ) {
+            SuperMemoState next = SuperMemo::calculate( scalar.grades[i], scalar.state( i ) );
+            scalar.intervals[i] = next.interval;
+            scalar.repetitions[i] = next.repetitions;
+            scalar.easiness[i] = next.easiness;
+        }
+        scalar_ms += chrono::duration<double, milli>( chrono::steady_clock::now() - begin ).count();
+
+        batch = start;
+        begin = chrono::steady_clock::now();
+        batch.calculate();
+        batch_ms += chrono::duration<double, milli>( chrono::steady_clock::now() - begin ).count();
+    }
+
+    double reviews = static_cast<double>( count ) * rounds;
+    WARN( "calculate: " << reviews / scalar_ms / 1000.0 << " M reviews/s, calculateBatch: "
+                        << reviews / batch_ms / 1000.0 << " M reviews/s" );
+    REQUIRE( batch.intervals == scalar.intervals );
+    REQUIRE( batch.repetitions == scalar.repetitions );
+    REQUIRE( memcmp( batch.easiness.data(), scalar.easiness.data(),
+                     count * sizeof( float ) ) == 0 );
+}
@@ -0,0 +1,99 @@
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "core/learning/WorkloadForecaster.h"
+
+using namespace std;
+
+// cards with a spread of SM-2 states, due anywhere from ten days ago to fifty days ahead
+static ProgressColumns randomProgress( size_t cards, unsigned seed ) {
+    mt19937 rng( seed );
+    ProgressColumns progress;
+    progress.reserve( cards );
+    for ( size_t c = 0; c < cards; ++c ) {
+        int repetitions = static_cast<int>( rng() % 6 );
+        int interval = repetitions == 0 ? 0 : static_cast<int>( rng() % 100 + 1 );
+        float easiness = 1.3f + static_cast<float>( rng() % 1700 ) / 1000.0f;
+        progress.add( { interval, repetitions, easiness }, static_cast<int>( rng() % 60 ) - 10 );
+    }
+    return progress;
+}
+
+TEST_CASE( "Workload forecast", "[WorkloadForecaster]" ) {
+    SECTION( "A card always recalled follows the SM-2 intervals" ) {
+        ProgressColumns progress;
+        progress.add( SuperMemo::getInitialState(), 0 );
+        ForecastOptions options;
+        options.days = 100;
+        options.grade_weights = { 0, 0, 0, 0, 1, 0 };
+
+        WorkloadForecast forecast = WorkloadForecaster::forecast( progress, options );
+        REQUIRE( forecast.reviews.size() == 100 );
+        vector<int> review_days;
+        for ( int day = 0; day < options.days; ++day ) {
+            if ( forecast.reviews[day] > 0 ) review_days.push_back( day );
+        }
+        // intervals 1, 6, 15 and 38 with easiness staying at 2.5
+        REQUIRE( review_days == vector<int>{ 0, 1, 7, 22, 60 } );
+        REQUIRE( accumulate( forecast.failed.begin(), forecast.failed.end(), 0 ) == 0 );
+    }
+
+    SECTION( "A card always forgotten comes back every day" ) {
+        ProgressColumns progress;
+        progress.add( { 40, 4, 2.1f }, -5 );
+        progress.add( { 40, 4, 2.1f }, 30 );
+        ForecastOptions options;
+        options.days = 20;
+        options.grade_weights = { 1, 1, 1, 0, 0, 0 };
+
+        WorkloadForecast forecast = WorkloadForecaster::forecast( progress, options );
+        // the overdue card is due today, the other one lies beyond the forecast
+        REQUIRE( forecast.reviews == vector<int>( 20, 1 ) );
+        REQUIRE( forecast.failed == forecast.reviews );
+    }
+
+    SECTION( "Failures follow the grade distribution" ) {
+        ProgressColumns progress = randomProgress( 20000, 3 );
+        ForecastOptions options;
+        options.days = 60;
+        WorkloadForecast forecast = WorkloadForecaster::forecast( progress, options );
+
+        double reviews = accumulate( forecast.reviews.begin(), forecast.reviews.end(), 0.0 );
+        double failed = accumulate( forecast.failed.begin(), forecast.failed.end(), 0.0 );
+        REQUIRE( reviews > 20000 );
+        REQUIRE( failed / reviews > 0.09 );
+        REQUIRE( failed / reviews < 0.11 );
+
+        // same seed, same forecast; another seed moves only the noise
+        REQUIRE( WorkloadForecaster::forecast( progress, options ).reviews == forecast.reviews );
+        options.seed = 2;
+        REQUIRE( WorkloadForecaster::forecast( progress, options ).reviews != forecast.reviews );
+    }
+
+    SECTION( "Nothing to forecast" ) {
+        ProgressColumns progress = randomProgress( 10, 1 );
+        ForecastOptions options;
+        options.days = 0;
+        REQUIRE( WorkloadForecaster::forecast( progress, options ).reviews.empty() );
+        REQUIRE( WorkloadForecaster::forecast( ProgressColumns() ).reviews == vector<int>( 30 ) );
+    }
+}
+
+TEST_CASE( "Workload forecast of a million cards over a year", "[.][benchmark]" ) {
+    ProgressColumns progress = randomProgress( 1000000, 5 );
+    ForecastOptions options;
+    options.days = 365;
+
+    auto start = chrono::steady_clock::now();
+    WorkloadForecast forecast = WorkloadForecaster::forecast( progress, options );
+    auto elapsed = chrono::steady_clock::now() - start;
+    auto ms = chrono::duration_cast<chrono::milliseconds>( elapsed ).count();
+
+    long long reviews = accumulate( forecast.reviews.begin(), forecast.reviews.end(), 0ll );
+    WARN( "Forecast " << progress.size() << " cards over " << options.days << " days ("
+                      << reviews << " reviews) in " << ms << " ms" );
+    REQUIRE( forecast.reviews.size() == static_cast<size_t>( options.days ) );
+}
@@ -80,6 +80,31 @@ TEST_CASE( "Import Export Functionality", "[ImpExp]" ) {
         REQUIRE_FALSE( SetImporter::importFile( file.fileName(), db, error ) );
     }
 
+    SECTION( "JSON Choice Limit" ) {
+        QJsonObject root;
+        root["name"] = "Crowded Set";
+        QJsonArray wrongs;
+        for ( size_t i = 0; i < ChoiceOrder::MAX_CHOICES; ++i ) {
+            wrongs.append( QString( "W%1" ).arg( i ) );
+        }
+        QJsonObject c1;
+        c1["question"] = "Q";
+        c1["correct_answer"] = "A";
+        c1["wrong_answers"] = wrongs;
+        QJsonArray cards;
+        cards.append( c1 );
+        root["cards"] = cards;
+
+        QFile file( temp_dir.path() + "/crowded.json" );
+        REQUIRE( file.open( QIODevice::WriteOnly ) );
+        file.write( QJsonDocument( root ).toJson() );
+        file.close();
+
+        QString error;
+        REQUIRE_FALSE( SetImporter::importFile( file.fileName(), db, error ) );
+        REQUIRE( db.getAllSets().empty() );
+    }
+
     SECTION( "Zip Export" ) {
         vector<DraftCard> cards;
         DraftCard c1;
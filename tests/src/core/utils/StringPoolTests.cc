@@ -0,0 +1,59 @@
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <vector>
+
+#include "core/utils/StringPool.h"
+
+using namespace std;
+
+TEST_CASE( "String Pool", "[StringPool]" ) {
+    StringPool pool;
+
+    SECTION( "Equal strings share a handle" ) {
+        auto yes = pool.intern( "True" );
+        auto no = pool.intern( "False" );
+        REQUIRE( yes != no );
+        REQUIRE( pool.intern( string( "True" ) ) == yes );
+        REQUIRE( pool.view( yes ) == "True" );
+        REQUIRE( pool.size() == 3 );
+        REQUIRE( pool.storedBytes() == 9 );
+        REQUIRE( pool.intern( "" ) == StringPool::EMPTY );
+        REQUIRE( pool.view( StringPool::EMPTY ).empty() );
+    }
+
+    SECTION( "Views stay valid while the pool grows and moves" ) {
+        string_view first = pool.view( pool.intern( "first" ) );
+        vector<StringPool::Handle> handles;
+        for ( int i = 0; i < 20000; ++i ) {
+            handles.push_back( pool.intern( "string number " + to_string( i ) ) );
+        }
+        string large( StringPool::CHUNK_SIZE * 2, 'x' );
+        auto large_handle = pool.intern( large );
+
+        StringPool moved = std::move( pool );
+        REQUIRE( first == "first" );
+        REQUIRE( moved.view( handles[12345] ) == "string number 12345" );
+        REQUIRE( moved.view( large_handle ) == large );
+        REQUIRE( moved.intern( "string number 7" ) == handles[7] );
+
+        // the moved-from pool is empty and usable
+        REQUIRE( pool.size() == 1 );
+        REQUIRE( pool.view( StringPool::EMPTY ).empty() );
+        REQUIRE( pool.view( pool.intern( "again" ) ) == "again" );
+
+        StringPool assigned;
+        assigned = std::move( moved );
+        REQUIRE( assigned.view( handles[12345] ) == "string number 12345" );
+        REQUIRE( moved.size() == 1 );
+        REQUIRE( moved.storedBytes() == 0 );
+        REQUIRE( moved.intern( "first" ) == 1 );
+    }
+
+    SECTION( "Clear starts over" ) {
+        pool.intern( "a" );
+        pool.clear();
+        REQUIRE( pool.size() == 1 );
+        REQUIRE( pool.storedBytes() == 0 );
+        REQUIRE( pool.view( pool.intern( "b" ) ) == "b" );
+    }
+}
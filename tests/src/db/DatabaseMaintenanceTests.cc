@@ -0,0 +1,76 @@
+#include <catch2/catch_test_macros.hpp>
+#include <QDir>
+#include <QFile>
+#include <QSqlQuery>
+#include <QVariant>
+
+#include "db/DatabaseManager.h"
+#include "db/DatabaseMaintenance.h"
+
+using namespace std;
+
+TEST_CASE( "Database Maintenance", "[Maintenance]" ) {
+    QString test_db_name = "maintenance_test.sqlite";
+    DatabaseManager db( test_db_name );
+
+    REQUIRE( db.connect() );
+    REQUIRE( db.createTables() );
+    db.flushData();
+
+    SECTION( "Migration enables incremental auto-vacuum" ) {
+        QSqlQuery query;
+        REQUIRE( query.exec( "PRAGMA auto_vacuum" ) );
+        REQUIRE( query.next() );
+        REQUIRE( query.value( 0 ).toInt() == 2 );
+
+        REQUIRE( query.exec( "PRAGMA user_version" ) );
+        REQUIRE( query.next() );
+        REQUIRE( query.value( 0 ).toInt() == DatabaseManager::SCHEMA_VERSION );
+    }
+
+    SECTION( "Older files switch to incremental auto-vacuum during maintenance" ) {
+        QSqlQuery query;
+        REQUIRE( query.exec( "PRAGMA auto_vacuum = NONE" ) );
+        REQUIRE( query.exec( "VACUUM" ) );
+        REQUIRE( query.exec( "PRAGMA auto_vacuum" ) );
+        REQUIRE( query.next() );
+        REQUIRE( query.value( 0 ).toInt() == 0 );
+
+        DatabaseMaintenance maintenance( db );
+        while ( maintenance.runSlice( 5 ) ) {
+        }
+        REQUIRE( query.exec( "PRAGMA auto_vacuum" ) );
+        REQUIRE( query.next() );
+        REQUIRE( query.value( 0 ).toInt() == 2 );
+    }
+
+    SECTION( "Slices run all steps and reclaim free pages" ) {
+        vector<DraftCard> cards;
+        for ( int i = 0; i < 500; ++i ) {
+            DraftCard c;
+            c.question = TextContent{ "Question " + to_string( i ) + string( 200, 'x' ) };
+            c.correct_answer = "Answer " + to_string( i );
+            cards.push_back( c );
+        }
+        REQUIRE( db.createSet( "Big Set", cards ) );
+        REQUIRE( db.deleteSet( db.getAllSets()[0].id ) );
+        REQUIRE( DatabaseMaintenance::freePages() > 0 );
+
+        DatabaseMaintenance maintenance( db );
+        int slices = 0;
+        while ( maintenance.runSlice( 5 ) ) {
+            ++slices;
+            REQUIRE( slices < 10000 );
+        }
+
+        REQUIRE( maintenance.isFinished() );
+        REQUIRE( maintenance.integrityOk() );
+        REQUIRE( DatabaseMaintenance::freePages() == 0 );
+        REQUIRE_FALSE( maintenance.runSlice( 5 ) );
+
+        maintenance.restart();
+        REQUIRE( maintenance.currentStep() == DatabaseMaintenance::Step::OPTIMIZE );
+    }
+
+    QFile::remove( QDir::current().filePath( "data/" + test_db_name ) );
+}
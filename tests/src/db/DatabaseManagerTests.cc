@@ -1,8 +1,16 @@
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <algorithm>
 #include <QDir>
 #include <QFile>
 #include <QDate>
+#include <QFileInfo>
+#include <QImage>
+#include <QSqlDatabase>
+#include <QSqlQuery>
 #include "db/DatabaseManager.h"
+#include "db/ProgressResetJob.h"
+#include "db/DatabaseMaintenance.h"
 #include "core/learning/Card.h"
 
 using namespace std;
@@ -28,6 +36,8 @@ TEST_CASE( "Database Manager Operations", "[Database]" ) {
         vector<StudySet> sets = db.getAllSets();
         REQUIRE( sets.size() == 1 );
         REQUIRE( sets[0].name == "Test Set 1" );
+        REQUIRE( sets[0].card_count == 1 );
+        REQUIRE( sets[0].due_count == 1 );
 
         int set_id = sets[0].id;
         auto set_opt = db.getSet( set_id );
@@ -57,6 +67,37 @@ TEST_CASE( "Database Manager Operations", "[Database]" ) {
         REQUIRE( cards.size() == 1 );
         REQUIRE( cards[0].getQuestion() == "Q_Add" );
 
+        DraftCard input;
+        input.question = TextContent{ "Q_Input" };
+        input.correct_answer = "colour";
+        input.accepted_answers = { "color" };
+        input.answer_type = AnswerType::INPUT;
+        REQUIRE( db.addCardToSet( set_id, input ) );
+        auto stored = db.getCardsForSet( set_id ).back();
+        REQUIRE( stored.getData().accepted_answers == vector<string>{ "color" } );
+        REQUIRE( stored.checkAnswer( "Color" ) );
+        DraftCard quiz;
+        quiz.question = TextContent{ "Q_Quiz" };
+        quiz.correct_answer = "Right";
+        quiz.wrong_answers = { "Wrong", "Żółw" };
+        quiz.answer_type = AnswerType::TEXT_CHOICE;
+        REQUIRE( db.addCardToSet( set_id, quiz ) );
+        CardStore store = db.getCardStore( set_id );
+        REQUIRE( store.size() == 3 );
+        REQUIRE( store.view( 1 ).getAcceptedAnswer( 0 ) == "color" );
+        REQUIRE( store.view( 0 ).getCorrectAnswer() == "A_Add" );
+        REQUIRE( store.view( 2 ).getWrongAnswerCount() == 2 );
+        REQUIRE( store.view( 2 ).getWrongAnswer( 1 ) == "Żółw" );
+        REQUIRE( store.view( 2 ).getAcceptedAnswerCount() == 0 );
+
+        DraftCard crowded = quiz;
+        crowded.wrong_answers.assign( ChoiceOrder::MAX_CHOICES, "Wrong" );
+        REQUIRE_FALSE( db.addCardToSet( set_id, crowded ) );
+        REQUIRE( db.getCardCount( set_id ) == 3 );
+
+        REQUIRE( db.deleteCard( db.getCardsForSet( set_id ).back().getId() ) );
+        REQUIRE( db.deleteCard( stored.getId() ) );
+
         REQUIRE( db.deleteCard( cards[0].getId() ) );
         REQUIRE( db.getCardsForSet( set_id ).empty() );
         REQUIRE_FALSE( db.deleteCard( 99999 ) );
@@ -87,6 +128,70 @@ TEST_CASE( "Database Manager Operations", "[Database]" ) {
         REQUIRE( re == 2.5f );
     }
 
+    SECTION( "Review Log" ) {
+        vector<DraftCard> cards = { { TextContent{ "R1" }, "A1" } };
+        REQUIRE( db.createSet( "Review Set", cards ) );
+        int set_id = db.getAllSets()[0].id;
+        int card_id = db.getCardsForSet( set_id )[0].getId();
+
+        auto fresh = db.getDueScheduledCards( set_id, 10 );
+        REQUIRE( fresh.size() == 1 );
+        REQUIRE( fresh[0].elapsed_days == -1 );
+        REQUIRE( fresh[0].memory.stability == 0.0f );
+
+        REQUIRE( db.saveReview( card_id, 4, -1, { 6, 1, 2.5f }, { 3.5f, 5.0f } ) );
+        auto reviewed = db.getRandomScheduledCards( set_id, 10 );
+        REQUIRE( reviewed[0].state.interval == 6 );
+        REQUIRE( reviewed[0].memory.stability == 3.5f );
+        REQUIRE( reviewed[0].memory.difficulty == 5.0f );
+        REQUIRE( reviewed[0].elapsed_days == 0 );
+
+        // elapsed days follow from the interval and the review date, FSRS memory is kept
+        REQUIRE( db.updateCardProgress( card_id, 6, 1, 2.5f,
+                                        DatabaseManager::calculateNextDate( 4 ) ) );
+        reviewed = db.getRandomScheduledCards( set_id, 10 );
+        REQUIRE( reviewed[0].elapsed_days == 2 );
+        REQUIRE( reviewed[0].memory.stability == 3.5f );
+
+        REQUIRE( db.saveReview( card_id, 1, 2, { 1, 0, 2.5f }, { 1.0f, 7.0f } ) );
+        vector<ReviewRecord> history = db.getReviewHistory();
+        REQUIRE( history.size() == 2 );
+        REQUIRE( history[0].rating == Fsrs::GOOD );
+        REQUIRE( history[0].elapsed_days == -1 );
+        REQUIRE( history[1].rating == Fsrs::AGAIN );
+        REQUIRE( history[1].elapsed_days == 2 );
+
+        REQUIRE_FALSE( db.getFsrsWeights().has_value() );
+        Fsrs::Weights weights = Fsrs::DEFAULT_WEIGHTS;
+        weights[3] = 20.25;
+        REQUIRE( db.saveFsrsWeights( weights ) );
+        REQUIRE( db.getFsrsWeights() == weights );
+
+        REQUIRE( db.deleteCard( card_id ) );
+        REQUIRE( db.getReviewHistory().empty() );
+    }
+
+    SECTION( "Progress Columns" ) {
+        vector<DraftCard> cards = { { TextContent{ "P1" }, "A1" }, { TextContent{ "P2" }, "A2" } };
+        REQUIRE( db.createSet( "Progress Set", cards ) );
+        int set_id = db.getAllSets()[0].id;
+        int card_id = db.getCardsForSet( set_id )[0].getId();
+        REQUIRE( db.updateCardProgress( card_id, 6, 2, 2.36f,
+                                        DatabaseManager::calculateNextDate( 3 ) ) );
+
+        ProgressColumns progress = db.getProgressColumns( { set_id } );
+        REQUIRE( progress.size() == 2 );
+        size_t seen = progress.intervals[0] == 6 ? 0 : 1;
+        REQUIRE( progress.repetitions[seen] == 2 );
+        REQUIRE( progress.easiness[seen] == 2.36f );
+        REQUIRE( progress.due_in_days[seen] == 3 );
+        REQUIRE( progress.intervals[1 - seen] == SuperMemo::getInitialState().interval );
+        REQUIRE( progress.due_in_days[1 - seen] == 0 );
+
+        REQUIRE( db.getProgressColumns( { set_id, set_id + 1 } ).size() == 2 );
+        REQUIRE( db.getProgressColumns( {} ).size() == 0 );
+    }
+
     SECTION( "Due Cards Logic" ) {
         vector<DraftCard> cards;
         DraftCard c;
@@ -184,5 +289,427 @@ TEST_CASE( "Database Manager Operations", "[Database]" ) {
         REQUIRE(stats.mastered == 1);
     }
 
+    SECTION( "Card Summaries" ) {
+        vector<DraftCard> cards;
+        for ( int i = 0; i < 5; ++i ) {
+            cards.push_back( { TextContent{ "SQ" + to_string( i ) }, "SA" } );
+        }
+        cards.push_back( { TextContent{ string( 500, 'q' ) }, "Long" } );
+        cards.push_back( { ImageContent{ "images/pic.png" }, "Pic" } );
+        db.createSet( "Summary Set", cards );
+        int set_id = db.getAllSets()[0].id;
+
+        vector<CardSummary> first = db.getCardSummaries( set_id, 0, 4 );
+        REQUIRE( first.size() == 4 );
+        REQUIRE( first[0].question == "SQ0" );
+        REQUIRE( first[0].media_type == MediaType::TEXT );
+
+        vector<CardSummary> rest = db.getCardSummaries( set_id, 4, 4 );
+        REQUIRE( rest.size() == 3 );
+        REQUIRE( rest[0].question == "SQ4" );
+        REQUIRE( rest[1].question.size() == DatabaseManager::SUMMARY_QUESTION_LENGTH );
+        REQUIRE( rest[2].media_type == MediaType::IMAGE );
+        REQUIRE( rest[2].question == "[Media Content]" );
+        REQUIRE( first.back().id < rest.front().id );
+    }
+
+    SECTION( "Chunked Progress Reset" ) {
+        vector<DraftCard> cards;
+        for ( int i = 0; i < 25; ++i ) {
+            cards.push_back( { TextContent{ "R" + to_string( i ) }, "A" } );
+        }
+        db.createSet( "Reset Set", cards );
+        int set_id = db.getAllSets()[0].id;
+        for ( const auto& card : db.getCardsForSet( set_id ) ) {
+            db.updateCardProgress( card.getId(), 22, 3, 2.5f, DatabaseManager::calculateNextDate( 5 ) );
+        }
+        REQUIRE( db.getSetStatistics( set_id ).mastered == 25 );
+
+        vector<DatabaseChange> changes;
+        int sub = db.subscribe( [&]( const DatabaseChange& c ) { changes.push_back( c ); } );
+        ProgressResetJob cancelled_job( db, set_id, 10 );
+        REQUIRE( cancelled_job.totalCards() == 25 );
+        REQUIRE( cancelled_job.step() );
+        REQUIRE( changes.empty() );
+        cancelled_job.cancel();
+        REQUIRE_FALSE( cancelled_job.step() );
+        REQUIRE( cancelled_job.isCancelled() );
+        REQUIRE( db.getSetStatistics( set_id ).mastered == 15 );
+        REQUIRE( changes.size() == 1 );
+        REQUIRE( changes[0].type == ChangeType::PROGRESS_CHANGED );
+        REQUIRE( changes[0].set_id == set_id );
+
+        ProgressResetJob job( db, set_id, 10 );
+        int steps = 0;
+        while ( job.step() ) {
+            ++steps;
+            REQUIRE( job.progress() <= 1.0f );
+        }
+        REQUIRE( steps == 3 );
+        REQUIRE( job.isFinished() );
+        REQUIRE_FALSE( job.hasFailed() );
+        REQUIRE( db.getSetStatistics( set_id ).new_cards == 25 );
+        REQUIRE( changes.size() == 2 );
+        db.unsubscribe( sub );
+    }
+
+    SECTION( "Change Notifications" ) {
+        vector<DatabaseChange> changes;
+        int sub = db.subscribe( [&]( const DatabaseChange& c ) { changes.push_back( c ); } );
+
+        vector<DraftCard> cards;
+        cards.push_back( { TextContent{ "N1" }, "A1" } );
+        cards.push_back( { TextContent{ "N2" }, "A2" } );
+        REQUIRE( db.createSet( "Notify Set", cards ) );
+        REQUIRE( changes.size() == 1 );
+        REQUIRE( changes[0].type == ChangeType::SET_ADDED );
+        int set_id = changes[0].set_id;
+
+        DraftCard extra{ TextContent{ "N3" }, "A3" };
+        REQUIRE( db.addCardToSet( set_id, extra ) );
+        REQUIRE( changes.size() == 2 );
+        REQUIRE( changes[1].type == ChangeType::CARD_ADDED );
+        REQUIRE( changes[1].set_id == set_id );
+        auto added = db.getCard( changes[1].card_id );
+        REQUIRE( added.has_value() );
+        REQUIRE( added->getQuestion() == "N3" );
+
+        REQUIRE( db.updateCardProgress( added->getId(), 1, 1, 2.5f,
+                                        DatabaseManager::calculateNextDate( 1 ) ) );
+        REQUIRE( changes.back().type == ChangeType::PROGRESS_CHANGED );
+        REQUIRE( changes.back().card_id == added->getId() );
+
+        REQUIRE( db.deleteCard( added->getId() ) );
+        REQUIRE( changes.back().type == ChangeType::CARD_DELETED );
+        REQUIRE( changes.back().set_id == set_id );
+
+        db.unsubscribe( sub );
+        REQUIRE( db.deleteSet( set_id ) );
+        REQUIRE( changes.back().type == ChangeType::CARD_DELETED );
+    }
+
+    SECTION( "Compressed Text" ) {
+        string sentence = "The quick brown fox jumps over the lazy dog near the river bank. ";
+        string long_question;
+        for ( int i = 0; i < 20; ++i ) long_question += sentence;
+        string long_answer = "Answer: " + long_question;
+
+        REQUIRE( db.createSet( "Long Set", { DraftCard{ TextContent{ long_question }, long_answer },
+                                             DraftCard{ TextContent{ "Short" }, "Plain" } } ) );
+        int set_id = db.getAllSets()[0].id;
+
+        QSqlQuery raw;
+        REQUIRE( raw.exec( "SELECT typeof(question), typeof(correct_answer) FROM cards "
+                           "ORDER BY id" ) );
+        REQUIRE( raw.next() );
+        REQUIRE( raw.value( 0 ).toString() == "blob" );
+        REQUIRE( raw.value( 1 ).toString() == "blob" );
+        REQUIRE( raw.next() );
+        REQUIRE( raw.value( 0 ).toString() == "text" );
+
+        auto cards = db.getCardsForSet( set_id );
+        REQUIRE( cards.size() == 2 );
+        REQUIRE( cards[0].getQuestion() == long_question );
+        REQUIRE( cards[0].getCorrectAnswer() == long_answer );
+        REQUIRE( cards[1].getQuestion() == "Short" );
+
+        auto summaries = db.getCardSummaries( set_id, 0, 10 );
+        REQUIRE( summaries[0].question ==
+                 long_question.substr( 0, DatabaseManager::SUMMARY_QUESTION_LENGTH ) );
+
+        db.setTextCompression( false );
+        REQUIRE( db.addCardToSet( set_id, DraftCard{ TextContent{ long_question }, "A" } ) );
+        REQUIRE( raw.exec( "SELECT typeof(question) FROM cards ORDER BY id DESC LIMIT 1" ) );
+        REQUIRE( raw.next() );
+        REQUIRE( raw.value( 0 ).toString() == "text" );
+    }
+
+    SECTION( "External Changes" ) {
+        vector<DatabaseChange> changes;
+        int sub = db.subscribe( [&changes]( const DatabaseChange& c ) { changes.push_back( c ); } );
+        REQUIRE_FALSE( db.pollExternalChanges() );
+
+        // own writes do not count as external
+        REQUIRE( db.createSet( "Local Set", { DraftCard{ TextContent{ "Q" }, "A" } } ) );
+        REQUIRE_FALSE( db.pollExternalChanges() );
+
+        {
+            QSqlDatabase other = QSqlDatabase::addDatabase( "QSQLITE", "other_process" );
+            other.setDatabaseName( QSqlDatabase::database().databaseName() );
+            REQUIRE( other.open() );
+            QSqlQuery insert( other );
+            REQUIRE( insert.exec( "INSERT INTO sets (name) VALUES ('Outside Set')" ) );
+            other.close();
+        }
+        QSqlDatabase::removeDatabase( "other_process" );
+
+        REQUIRE( db.pollExternalChanges() );
+        REQUIRE( changes.back().type == ChangeType::EXTERNAL );
+        REQUIRE_FALSE( db.pollExternalChanges() );
+        REQUIRE( db.getAllSets().size() == 2 );
+
+        db.unsubscribe( sub );
+    }
+
+    SECTION( "Set Pages" ) {
+        for ( string name : { "beta", "Alpha", "gamma", "alpha", "Delta" } ) {
+            REQUIRE( db.createSet( name, { DraftCard{ TextContent{ "Q" }, "A" } } ) );
+        }
+
+        auto first = db.getSetsPage( SetSort::NEWEST, 2 );
+        REQUIRE( first.size() == 2 );
+        REQUIRE( first[0].name == "Delta" );
+        REQUIRE( first[1].name == "alpha" );
+        REQUIRE( first[0].card_count == 1 );
+        auto second = db.getSetsPage( SetSort::NEWEST, 2, first.back() );
+        REQUIRE( second.size() == 2 );
+        REQUIRE( second[0].name == "gamma" );
+        auto last = db.getSetsPage( SetSort::NEWEST, 2, second.back() );
+        REQUIRE( last.size() == 1 );
+        REQUIRE( last[0].name == "beta" );
+
+        vector<string> names;
+        optional<StudySet> cursor;
+        while ( true ) {
+            auto page = db.getSetsPage( SetSort::NAME, 2, cursor );
+            for ( const auto& set : page ) names.push_back( set.name );
+            if ( page.size() < 2 ) break;
+            cursor = page.back();
+        }
+        REQUIRE( names == vector<string>{ "Alpha", "alpha", "beta", "Delta", "gamma" } );
+
+        // every new set starts with all its cards due, grading one card pushes it back
+        int gamma_id = second[0].id;
+        REQUIRE( db.addCardToSet( gamma_id, DraftCard{ TextContent{ "Q2" }, "A2" } ) );
+        auto by_due = db.getSetsPage( SetSort::DUE_COUNT, 10 );
+        REQUIRE( by_due[0].id == gamma_id );
+        REQUIRE( by_due[0].due_count == 2 );
+
+        for ( const auto& card : db.getCardsForSet( gamma_id ) ) {
+            REQUIRE( db.updateCardProgress( card.getId(), 6, 2, 2.5f,
+                                            DatabaseManager::calculateNextDate( 6 ) ) );
+        }
+        REQUIRE( db.getSet( gamma_id )->due_count == 0 );
+        REQUIRE( db.getSetsPage( SetSort::DUE_COUNT, 10 ).back().id == gamma_id );
+
+        auto card = db.getCardsForSet( gamma_id ).front();
+        REQUIRE( db.updateCardProgress( card.getId(), 0, 0, 2.5f,
+                                        DatabaseManager::calculateNextDate( 0 ) ) );
+        REQUIRE( db.getSet( gamma_id )->due_count == 1 );
+        REQUIRE( db.resetSetProgress( gamma_id ) );
+        REQUIRE( db.getSet( gamma_id )->due_count == 2 );
+
+        auto by_activity = db.getSetsPage( SetSort::RECENT_ACTIVITY, 10 );
+        REQUIRE( by_activity.size() == 5 );
+        REQUIRE_FALSE( by_activity[0].last_activity.empty() );
+        for ( size_t i = 1; i < by_activity.size(); ++i ) {
+            REQUIRE( by_activity[i - 1].last_activity >= by_activity[i].last_activity );
+        }
+    }
+
+    SECTION( "Deck Hierarchy" ) {
+        auto languages = db.createDeck( "Languages" );
+        REQUIRE( languages );
+        auto spanish = db.createDeck( "Spanish", *languages );
+        auto verbs = db.createDeck( "Verbs", *spanish );
+        auto science = db.createDeck( "Science" );
+        REQUIRE( spanish );
+        REQUIRE( verbs );
+        REQUIRE( science );
+        REQUIRE_FALSE( db.createDeck( "Orphan", 999999 ) );
+
+        REQUIRE( db.createSet( "Irregular", { DraftCard{ TextContent{ "ser" }, "to be" },
+                                              DraftCard{ TextContent{ "ir" }, "to go" },
+                                              DraftCard{ TextContent{ "tener" }, "to have" } } ) );
+        REQUIRE( db.createSet( "Basics", { DraftCard{ TextContent{ "hola" }, "hello" },
+                                           DraftCard{ TextContent{ "adios" }, "bye" } } ) );
+        auto sets = db.getSetsPage( SetSort::NEWEST, 2 );
+        int basics_id = sets[0].id;
+        int irregular_id = sets[1].id;
+        REQUIRE( db.assignSetToDeck( irregular_id, *verbs ) );
+        REQUIRE( db.assignSetToDeck( basics_id, *spanish ) );
+
+        // totals of nested sets reach every ancestor
+        REQUIRE( db.getDeck( *languages )->card_count == 5 );
+        REQUIRE( db.getDeck( *languages )->due_count == 5 );
+        REQUIRE( db.getDeck( *spanish )->card_count == 5 );
+        REQUIRE( db.getDeck( *verbs )->card_count == 3 );
+        REQUIRE( db.getDueCardsForDeck( *languages, 10 ).size() == 5 );
+        REQUIRE( db.getDueCardsForDeck( *verbs, 10 ).size() == 3 );
+
+        int card_id = db.getCardsForSet( irregular_id ).front().getId();
+        REQUIRE( db.updateCardProgress( card_id, 30, 4, 2.5f,
+                                        DatabaseManager::calculateNextDate( 30 ) ) );
+        REQUIRE( db.getDeck( *languages )->due_count == 4 );
+        REQUIRE( db.getDeck( *languages )->mastered_count == 1 );
+        REQUIRE( db.getDueCardsForDeck( *languages, 10 ).size() == 4 );
+
+        // a deck cannot move below itself, moving it carries the whole subtree
+        REQUIRE_FALSE( db.moveDeck( *languages, *verbs ) );
+        REQUIRE( db.moveDeck( *verbs, *science ) );
+        REQUIRE( db.getDeck( *languages )->card_count == 2 );
+        REQUIRE( db.getDeck( *science )->card_count == 3 );
+        REQUIRE( db.getDeck( *science )->mastered_count == 1 );
+        REQUIRE( db.getDueCardsForDeck( *science, 10 ).size() == 2 );
+        REQUIRE( db.getChildDecks( *science ).front().id == *verbs );
+        REQUIRE( db.getChildDecks( -1 ).size() == 2 );
+
+        REQUIRE_FALSE( db.deleteDeck( *science ) );
+        REQUIRE( db.assignSetToDeck( irregular_id, -1 ) );
+        REQUIRE( db.getDeck( *science )->card_count == 0 );
+        REQUIRE( db.deleteDeck( *verbs ) );
+        REQUIRE_FALSE( db.getDeck( *verbs ) );
+
+        REQUIRE( db.deleteSet( basics_id ) );
+        REQUIRE( db.getDeck( *languages )->card_count == 0 );
+        REQUIRE( db.getDeck( *languages )->due_count == 0 );
+    }
+
+    SECTION( "Media Catalog" ) {
+        QImage image( 640, 480, QImage::Format_RGB32 );
+        image.fill( Qt::blue );
+        REQUIRE( image.save( db.getImagesPath() + "catalog_test.png" ) );
+
+        // one second of 8 kHz mono 8-bit silence
+        QByteArray wav( "RIFF" );
+        auto append32 = [&wav]( quint32 v ) { wav.append( (const char*)&v, 4 ); };
+        auto append16 = [&wav]( quint16 v ) { wav.append( (const char*)&v, 2 ); };
+        append32( 36 + 8000 );
+        wav.append( "WAVEfmt " );
+        append32( 16 );
+        append16( 1 );
+        append16( 1 );
+        append32( 8000 );
+        append32( 8000 );
+        append16( 1 );
+        append16( 8 );
+        wav.append( "data" );
+        append32( 8000 );
+        wav.append( QByteArray( 8000, char( 0x80 ) ) );
+        QFile wav_file( db.getSoundsPath() + "catalog_test.wav" );
+        REQUIRE( wav_file.open( QIODevice::WriteOnly ) );
+        wav_file.write( wav );
+        wav_file.close();
+
+        DraftCard image_card{ ImageContent{ "images/catalog_test.png" }, "Blue" };
+        DraftCard sound_card{ SoundContent{ "sounds/catalog_test.wav" }, "Silence" };
+        REQUIRE( db.createSet( "Media Set", { image_card, sound_card } ) );
+
+        auto image_info = db.getMediaInfo( "images/catalog_test.png" );
+        REQUIRE( image_info.has_value() );
+        REQUIRE( image_info->width == 640 );
+        REQUIRE( image_info->height == 480 );
+        REQUIRE( image_info->hash.size() == 40 );
+        QFileInfo image_file( db.getImagesPath() + "catalog_test.png" );
+        REQUIRE( image_info->byte_size == image_file.size() );
+        QString thumbnail = db.getMediaRoot() + QString::fromStdString( image_info->thumbnail );
+        REQUIRE( QFile::exists( thumbnail ) );
+
+        auto sound_info = db.getMediaInfo( "sounds/catalog_test.wav" );
+        REQUIRE( sound_info.has_value() );
+        REQUIRE( sound_info->duration_ms == 1000 );
+        REQUIRE( sound_info->byte_size == wav.size() );
+
+        REQUIRE_FALSE( db.getMediaInfo( "images/never_added.png" ).has_value() );
+
+        // the sound shares the image's base name, removing it leaves the thumbnail alone
+        REQUIRE( MediaProbe::thumbnailPath( "images/cat.png" ) !=
+                 MediaProbe::thumbnailPath( "images/cat.jpg" ) );
+        REQUIRE( MediaProbe::thumbnailPath( "images/cat.png" ) !=
+                 MediaProbe::thumbnailPath( "sounds/cat.png" ) );
+        vector<Card> media_cards = db.getCardsForSet( db.getAllSets()[0].id );
+        auto sound = find_if( media_cards.begin(), media_cards.end(), []( const Card& card ) {
+            return card.getMediaType() == MediaType::SOUND;
+        } );
+        REQUIRE( sound != media_cards.end() );
+        REQUIRE( db.deleteCard( sound->getId() ) );
+        REQUIRE( QFile::exists( thumbnail ) );
+
+        REQUIRE( db.deleteSet( db.getAllSets()[0].id ) );
+        REQUIRE_FALSE( db.getMediaInfo( "images/catalog_test.png" ).has_value() );
+        REQUIRE_FALSE( db.getMediaInfo( "sounds/catalog_test.wav" ).has_value() );
+        REQUIRE_FALSE( QFile::exists( thumbnail ) );
+    }
+
+    SECTION( "Failed Migration Rolls Back" ) {
+        // a database left half way into schema 8: last_grade is gone, last_elapsed_days is still
+        // there, so the step fails at its second statement; schema 9 is undone first
+        QSqlQuery query;
+        REQUIRE( query.exec( "DROP INDEX idx_progress_set_due" ) );
+        REQUIRE( query.exec( "ALTER TABLE learning_progress DROP COLUMN set_id" ) );
+        REQUIRE( query.exec( "DROP TRIGGER trg_progress_review_added" ) );
+        REQUIRE( query.exec( "DROP TRIGGER trg_progress_reviewed" ) );
+        REQUIRE( query.exec( "ALTER TABLE learning_progress DROP COLUMN last_grade" ) );
+        REQUIRE( query.exec( "PRAGMA user_version = 7" ) );
+        REQUIRE_FALSE( db.createTables() );
+
+        REQUIRE( query.exec( "PRAGMA user_version" ) );
+        REQUIRE( query.next() );
+        REQUIRE( query.value( 0 ).toInt() == 7 );
+        bool has_grade = false;
+        REQUIRE( query.exec( "PRAGMA table_info(learning_progress)" ) );
+        while ( query.next() ) has_grade |= query.value( "name" ).toString() == "last_grade";
+        REQUIRE_FALSE( has_grade );
+
+        // the whole step runs again once the leftover column is gone
+        REQUIRE( query.exec( "ALTER TABLE learning_progress DROP COLUMN last_elapsed_days" ) );
+        REQUIRE( db.createTables() );
+        REQUIRE( query.exec( "PRAGMA user_version" ) );
+        REQUIRE( query.next() );
+        REQUIRE( query.value( 0 ).toInt() == DatabaseManager::SCHEMA_VERSION );
+    }
+
     QFile::remove( QDir::current().filePath( "data/" + test_db_name ) );
 }
+
+TEST_CASE( "Compressed text storage", "[.][benchmark]" ) {
+    static constexpr int SETS = 20;
+    static constexpr int CARDS_PER_SET = 250;
+
+    string example = "Ich habe gestern einen langen Spaziergang am Fluss gemacht, weil das Wetter "
+                     "so schön war und ich nach der Arbeit etwas frische Luft brauchte. ";
+
+    for ( bool compress : { false, true } ) {
+        QString test_db_name = QString( "compression_bench_%1.sqlite" ).arg( compress ? "on" : "off" );
+        DatabaseManager db( test_db_name );
+        REQUIRE( db.connect() );
+        REQUIRE( db.createTables() );
+        db.flushData();
+        db.setTextCompression( compress );
+
+        for ( int s = 0; s < SETS; ++s ) {
+            vector<DraftCard> cards;
+            for ( int i = 0; i < CARDS_PER_SET; ++i ) {
+                string text = to_string( i ) + " " + example + example + example;
+                cards.push_back( DraftCard{ TextContent{ text }, "Beispiel " + text } );
+            }
+            REQUIRE( db.createSet( "Deck " + to_string( s ), cards ) );
+        }
+
+        // page-cache hit rate is not exposed through Qt, the share of pages that fit into the
+        // cache stands in for it
+        QSqlQuery pragma;
+        REQUIRE( pragma.exec( "PRAGMA page_count" ) );
+        REQUIRE( pragma.next() );
+        qint64 pages = pragma.value( 0 ).toLongLong();
+        REQUIRE( pragma.exec( "PRAGMA page_size" ) );
+        REQUIRE( pragma.next() );
+        qint64 page_size = pragma.value( 0 ).toLongLong();
+        REQUIRE( pragma.exec( "PRAGMA cache_size" ) );
+        REQUIRE( pragma.next() );
+        // a negative cache_size is a limit in KiB instead of pages
+        qint64 cache_size = pragma.value( 0 ).toLongLong();
+        qint64 cache_pages = cache_size < 0 ? -cache_size * 1024 / page_size : cache_size;
+
+        WARN( ( compress ? "compressed" : "plain" )
+              << ": " << DatabaseMaintenance::databaseSizeBytes() << " bytes, " << pages
+              << " pages, " << min( 100.0, 100.0 * cache_pages / pages ) << "% fit in cache" );
+
+        int set_id = db.getAllSets()[0].id;
+        BENCHMARK( compress ? "load set, compressed" : "load set, plain" ) {
+            return db.getCardsForSet( set_id ).size();
+        };
+
+        QFile::remove( QDir::current().filePath( "data/" + test_db_name ) );
+    }
+}
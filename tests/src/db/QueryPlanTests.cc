@@ -0,0 +1,192 @@
+#include <catch2/catch_test_macros.hpp>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QRegularExpression>
+#include <QSqlQuery>
+#include <QStringList>
+#include <QVariant>
+
+#include "db/DatabaseManager.h"
+#include "db/Queries.h"
+
+using namespace std;
+
+// binds the same value to every named placeholder found in the statement
+static void bindPlaceholders( QSqlQuery& query, const QString& sql, const QVariant& value ) {
+    static const QRegularExpression placeholder( ":(\\w+)" );
+    auto it = placeholder.globalMatch( sql );
+    while ( it.hasNext() ) {
+        query.bindValue( it.next().captured( 0 ), value );
+    }
+}
+
+static QStringList queryPlan( const QString& sql ) {
+    QSqlQuery query;
+    QStringList plan;
+    if ( !query.prepare( "EXPLAIN QUERY PLAN " + sql ) ) return plan;
+    bindPlaceholders( query, sql, 1 );
+    if ( !query.exec() ) return plan;
+    while ( query.next() ) {
+        plan << query.value( 3 ).toString();
+    }
+    return plan;
+}
+
+// fills the database with count_sets sets of cards_per_set cards spread over a two level deck
+// tree, every tenth card shows an image, every other card has progress and three logged reviews
+static void populate( int count_sets, int cards_per_set ) {
+    QSqlQuery query;
+    REQUIRE( query.exec( "BEGIN TRANSACTION" ) );
+    REQUIRE( query.exec( R"(
+        WITH RECURSIVE n(i) AS (SELECT 1 UNION ALL SELECT i + 1 FROM n WHERE i < 40)
+        INSERT INTO decks (name) SELECT 'Deck ' || i FROM n
+    )" ) );
+    REQUIRE( query.exec( R"(
+        WITH RECURSIVE n(i) AS (SELECT 1 UNION ALL SELECT i + 1 FROM n WHERE i < 160)
+        INSERT INTO decks (name, parent_id) SELECT 'Subdeck ' || i, (i - 1) % 40 + 1 FROM n
+    )" ) );
+    REQUIRE( query.exec( R"(
+        INSERT INTO deck_closure (ancestor_id, descendant_id, depth)
+        SELECT id, id, 0 FROM decks
+        UNION ALL SELECT parent_id, id, 1 FROM decks WHERE parent_id IS NOT NULL
+    )" ) );
+    REQUIRE( query.exec( QString( R"(
+        WITH RECURSIVE n(i) AS (SELECT 1 UNION ALL SELECT i + 1 FROM n WHERE i < %1)
+        INSERT INTO sets (name, deck_id) SELECT 'Set ' || i, i % 200 + 1 FROM n
+    )" ).arg( count_sets ) ) );
+    REQUIRE( query.exec( QString( R"(
+        WITH RECURSIVE n(i) AS (SELECT 0 UNION ALL SELECT i + 1 FROM n WHERE i < %1 - 1)
+        INSERT INTO cards (set_id, question, correct_answer, wrong_answers, answer_type, media_type)
+        SELECT s.id,
+               CASE WHEN n.i % 10 = 0 THEN 'images/' || s.id || '_' || n.i || '.png'
+                    ELSE 'Question ' || n.i END,
+               'Answer ' || n.i, '', 0, n.i % 10 = 0
+        FROM sets s, n
+    )" ).arg( cards_per_set ) ) );
+    REQUIRE( query.exec( R"(
+        INSERT INTO media (path, hash, byte_size, width, height)
+        SELECT question, 'hash ' || id, 1000, 64, 64 FROM cards WHERE media_type <> 0
+    )" ) );
+    REQUIRE( query.exec( R"(
+        INSERT INTO learning_progress (card_id, set_id, interval, repetitions, easiness_factor,
+                                       next_review_date)
+        SELECT id, set_id, id % 40, id % 5, 2.5, date('now', '+' || (id % 30) || ' days')
+        FROM cards WHERE id % 2 = 0
+    )" ) );
+    REQUIRE( query.exec( R"(
+        WITH RECURSIVE n(i) AS (SELECT 1 UNION ALL SELECT i + 1 FROM n WHERE i < 3)
+        INSERT INTO review_log (card_id, reviewed_on, grade, elapsed_days)
+        SELECT lp.card_id, date('now', '-' || n.i || ' days'), 4, n.i
+        FROM learning_progress lp, n
+    )" ) );
+    REQUIRE( query.exec( "COMMIT" ) );
+    REQUIRE( query.exec( "ANALYZE" ) );
+}
+
+static QStringList tableNames() {
+    QSqlQuery query;
+    QStringList tables;
+    REQUIRE( query.exec( "SELECT name FROM sqlite_master WHERE type = 'table'" ) );
+    while ( query.next() ) {
+        tables << query.value( 0 ).toString();
+    }
+    return tables;
+}
+
+// maps every alias the statement gives a table, and every table name, to the table itself
+static QHash<QString, QString> tableAliases( const QString& sql ) {
+    static const QRegularExpression source(
+        "\\b(?:FROM|JOIN|UPDATE|INTO)\\s+(\\w+)(?:\\s+(?:AS\\s+)?(\\w+))?",
+        QRegularExpression::CaseInsensitiveOption );
+    static const QStringList keywords = { "WHERE", "JOIN", "LEFT", "INNER", "CROSS", "ON",
+                                          "ORDER", "GROUP", "LIMIT", "USING", "SET", "UNION",
+                                          "AND", "OR", "VALUES", "AS", "INDEXED" };
+    QHash<QString, QString> aliases;
+    auto it = source.globalMatch( sql );
+    while ( it.hasNext() ) {
+        auto match = it.next();
+        QString table = match.captured( 1 );
+        aliases.insert( table, table );
+        QString alias = match.captured( 2 );
+        if ( !alias.isEmpty() && !keywords.contains( alias.toUpper() ) ) {
+            aliases.insert( alias, table );
+        }
+    }
+    return aliases;
+}
+
+TEST_CASE( "Query plans use indexes", "[QueryPlan]" ) {
+    QString test_db_name = "query_plan_test.sqlite";
+    DatabaseManager db( test_db_name );
+
+    REQUIRE( db.connect() );
+    REQUIRE( db.createTables() );
+    db.flushData();
+    populate( 200, 100 );
+    const QStringList tables = tableNames();
+
+    for ( const auto& named : Queries::ALL ) {
+        INFO( "Query: " << named.name );
+        QStringList plan = queryPlan( named.sql );
+        INFO( "Plan: " << plan.join( " | " ).toStdString() );
+
+        // an empty plan means the statement failed to prepare, which is a bug of its own
+        bool is_insert = QString( named.sql ).trimmed().startsWith( "INSERT" );
+        if ( !is_insert ) REQUIRE_FALSE( plan.isEmpty() );
+
+        // a SCAN names the table or its alias, subqueries and CTEs are not tables and may be read
+        static const QRegularExpression scan( "^SCAN (?:TABLE )?(\\w+)" );
+        QHash<QString, QString> aliases = tableAliases( named.sql );
+        for ( const QString& step : plan ) {
+            auto match = scan.match( step );
+            if ( !match.hasMatch() ) continue;
+            QString table = aliases.value( match.captured( 1 ), match.captured( 1 ) );
+            if ( !tables.contains( table ) ) continue;
+            INFO( "Scanned: " << table.toStdString() );
+            REQUIRE( ( named.full_scan && table == named.full_scan ) );
+        }
+    }
+
+    QFile::remove( QDir::current().filePath( "data/" + test_db_name ) );
+}
+
+TEST_CASE( "Query time budgets on a large database", "[.][perf]" ) {
+    static constexpr int SETS = 1000;
+    static constexpr int CARDS_PER_SET = 1000;
+    static constexpr int BUDGET_MS = 50;
+
+    QString test_db_name = "query_perf_test.sqlite";
+    DatabaseManager db( test_db_name );
+
+    REQUIRE( db.connect() );
+    REQUIRE( db.createTables() );
+    db.flushData();
+    populate( SETS, CARDS_PER_SET );
+
+    // a set in the middle of the table, its id is also a valid card id
+    const int probe_id = SETS / 2;
+
+    for ( const auto& named : Queries::ALL ) {
+        QString sql = named.sql;
+        if ( !sql.trimmed().startsWith( "SELECT" ) ) continue;
+        INFO( "Query: " << named.name );
+
+        QSqlQuery query;
+        REQUIRE( query.prepare( sql ) );
+        bindPlaceholders( query, sql, probe_id );
+
+        QElapsedTimer timer;
+        timer.start();
+        REQUIRE( query.exec() );
+        while ( query.next() ) {
+        }
+        qint64 elapsed = timer.elapsed();
+
+        INFO( "Elapsed: " << elapsed << " ms" );
+        REQUIRE( elapsed < BUDGET_MS );
+    }
+
+    QFile::remove( QDir::current().filePath( "data/" + test_db_name ) );
+}